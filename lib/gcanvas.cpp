@@ -3,6 +3,9 @@
  * -----------------
  *
  * @author Marty Stepp
+ * @version 2022/03/20
+ * - added setPixelsARGB from a row-major framebuffer region
+ * - added setPixelsARGBUnchecked; per-pixel bounds checks follow require::Policy
  * @version 2021/04/09
  * - added sgl namespace
  * - converted Grid functionality to 2D array/vector
@@ -29,6 +32,8 @@
  */
 
 #include "gcanvas.h"
+#include <algorithm>
+#include <cstring>
 #include <exception>
 #include <stdexcept>
 #include "gcolor.h"
@@ -411,8 +416,9 @@ void GCanvas::fill(const std::string& rgb) {
 }
 
 void GCanvas::fillRegion(double x, double y, double width, double height, int rgb) {
-    checkBounds("GCanvas::fillRegion", x, y, getWidth(), getHeight());
-    checkBounds("GCanvas::fillRegion", x + width - 1, y + height - 1, getWidth(), getHeight());
+    // a region is checked once, whatever the per-pixel policy is
+    checkBounds("GCanvas::fillRegion", x, y, getWidth(), getHeight(), require::CHECKED);
+    checkBounds("GCanvas::fillRegion", x + width - 1, y + height - 1, getWidth(), getHeight(), require::CHECKED);
     checkColor("GCanvas::fillRegion", rgb);
     bool wasAutoRepaint = isAutoRepaint();
     setAutoRepaint(false);
@@ -822,7 +828,9 @@ void GCanvas::setKeyListener(GEventListenerVoid func) {
 }
 
 void GCanvas::setPixel(double x, double y, int rgb) {
-    require::inRange2D(x, y, getWidth(), getHeight(), "GCanvas::setPixel", "x", "y");
+    if (require::shouldCheck()) {
+        require::inRange2D(x, y, getWidth(), getHeight(), "GCanvas::setPixel", "x", "y");
+    }
     checkColor("GCanvas::setPixel", rgb);
     GThread::runOnQtGuiThread([this, x, y, rgb]() {
         ensureBackgroundImage();
@@ -848,7 +856,9 @@ void GCanvas::setPixel(double x, double y, int r, int g, int b) {
 }
 
 void GCanvas::setPixelARGB(double x, double y, int argb) {
-    require::inRange2D(x, y, getWidth(), getHeight(), "GCanvas::setPixelARGB", "x", "y");
+    if (require::shouldCheck()) {
+        require::inRange2D(x, y, getWidth(), getHeight(), "GCanvas::setPixelARGB", "x", "y");
+    }
     checkColor("GCanvas::setPixel", argb);
     GThread::runOnQtGuiThread([this, x, y, argb]() {
         ensureBackgroundImage();
@@ -946,6 +956,53 @@ void GCanvas::setPixelsARGB(int** pixels, int width, int height) {
     });
 }
 
+void GCanvas::setPixelsARGB(const unsigned int* pixels, int width, int height,
+                            int x, int y, int w, int h) {
+    require::nonNull(pixels, "GCanvas::setPixelsARGB");
+    ensureBackgroundImage();
+    GThread::runOnQtGuiThread([this, pixels, width, height, &x, &y, &w, &h]() {
+        lockForWrite();
+        // clip to both the framebuffer and the canvas, once for the whole rectangle
+        int right = std::min(std::min(x + w, width), _backgroundImage->width());
+        int bottom = std::min(std::min(y + h, height), _backgroundImage->height());
+        x = std::max(x, 0);
+        y = std::max(y, 0);
+        w = right - x;
+        h = bottom - y;
+        if (w > 0 && h > 0) {
+            copyPixelsARGB(pixels, width, x, y, w, h);
+        }
+        unlock();
+    });
+    if (w > 0 && h > 0) {
+        conditionalRepaintRegion(x, y, w, h);
+    }
+}
+
+void GCanvas::setPixelsARGBUnchecked(const unsigned int* pixels, int width,
+                                     int x, int y, int w, int h) {
+    ensureBackgroundImage();
+    GThread::runOnQtGuiThread([this, pixels, width, x, y, w, h]() {
+        lockForWrite();
+        copyPixelsARGB(pixels, width, x, y, w, h);
+        unlock();
+    });
+    conditionalRepaintRegion(x, y, w, h);
+}
+
+void GCanvas::copyPixelsARGB(const unsigned int* pixels, int width, int x, int y, int w, int h) {
+    if (_backgroundImage->format() != QImage::Format_ARGB32) {
+        // e.g. loaded from a file; the scanlines must be 0xAARRGGBB words
+        *_backgroundImage = _backgroundImage->convertToFormat(QImage::Format_ARGB32);
+    }
+    for (int yy = y; yy < y + h; yy++) {
+        // Format_ARGB32 scanlines are the same 0xAARRGGBB words as the framebuffer
+        memcpy(_backgroundImage->scanLine(yy) + x * sizeof(unsigned int),
+               pixels + static_cast<size_t>(yy) * width + x,
+               static_cast<size_t>(w) * sizeof(unsigned int));
+    }
+}
+
 void GCanvas::setPixelsARGB(const std::vector<std::vector<int>>& pixelsARGB) {
     ensureBackgroundImage();
     int width = pixelsARGB.size();
@@ -3,6 +3,9 @@
  * ---------------
  *
  * @author Marty Stepp
+ * @version 2022/03/20
+ * - added setPixelsARGB from a row-major framebuffer region
+ * - added setPixelsARGBUnchecked; per-pixel bounds checks follow require::Policy
  * @version 2021/04/09
  * - added sgl namespace
  * - converted Grid functionality to 2D array/vector
@@ -657,6 +660,27 @@ public:
      */
     virtual void setPixelsARGB(const std::vector<std::vector<int>>& pixelsARGB) override;
 
+    /**
+     * Copies the given rectangle of a framebuffer into the same place in the
+     * background layer of the canvas, then repaints just that rectangle.
+     * The framebuffer holds width x height ARGB values row by row, so that
+     * pixels[y * width + x] is the pixel at (x, y); each row of the rectangle
+     * is copied whole instead of pixel by pixel.  Parts of the rectangle
+     * outside the framebuffer or the canvas are ignored.
+     */
+    virtual void setPixelsARGB(const unsigned int* pixels, int width, int height,
+                               int x, int y, int w, int h);
+
+    /**
+     * Like the framebuffer version of setPixelsARGB, but nothing is checked:
+     * pixels must not be null and the rectangle must lie inside both the
+     * framebuffer (which is width pixels wide) and the canvas.  It is meant
+     * for render loops that validate their rectangle once, so that it is not
+     * checked again on every frame.
+     */
+    virtual void setPixelsARGBUnchecked(const unsigned int* pixels, int width,
+                                        int x, int y, int w, int h);
+
     /**
      * Converts the pixels of the canvas into a GImage object.
      */
@@ -672,6 +696,10 @@ private:
 
     friend class _Internal_QCanvas;
 
+    // copies a rectangle of a framebuffer into the background image;
+    // call on the Qt GUI thread with the lock held
+    void copyPixelsARGB(const unsigned int* pixels, int width, int x, int y, int w, int h);
+
     void ensureBackgroundImage();
 
     void ensureBackgroundImageConstHack() const;
@@ -4,6 +4,8 @@
  * This file implements the gconsolewindow.h interface.
  *
  * @author Marty Stepp
+ * @version 2022/03/20
+ * - added getPendingOutputSize
  * @version 2021/04/09
  * - added sgl namespace
  * @version 2021/04/03
@@ -140,7 +142,8 @@ GConsoleWindow::GConsoleWindow()
           _cerr_new_buf(nullptr),
           _cin_old_buf(nullptr),
           _cout_old_buf(nullptr),
-          _cerr_old_buf(nullptr) {
+          _cerr_old_buf(nullptr),
+          _pendingOutputSize(0) {
     _initMenuBar();
     _initWidgets();
     _initStreams();
@@ -460,6 +463,10 @@ std::string GConsoleWindow::getOutputColor() const {
     return _outputColor.empty() ? GWindow::getDefaultInteractorTextColor() : _outputColor;
 }
 
+int GConsoleWindow::getPendingOutputSize() const {
+    return _pendingOutputSize;
+}
+
 std::string GConsoleWindow::getUserInputColor() const {
     if (!_userInputColor.empty()) {
         return _userInputColor;
@@ -678,7 +685,11 @@ void GConsoleWindow::print(const std::string& str, bool isStdErr) {
     sgl::priv::strlib::replaceInPlace(strToPrint, "\r\n", "\n");
     sgl::priv::strlib::replaceInPlace(strToPrint, "\r", "\n");
 
-    GThread::runOnQtGuiThread([this, strToPrint, isStdErr]() {
+    // count the text until the GUI thread gets to it, so callers can see the backlog
+    int length = (int) strToPrint.length();
+    _pendingOutputSize += length;
+    GThread::runOnQtGuiThread([this, strToPrint, isStdErr, length]() {
+        _pendingOutputSize -= length;
         _coutMutex.lock();
         _allOutputBuffer << strToPrint;
         if (!this->_textArea) {
@@ -7,6 +7,8 @@
  * static method GConsoleWindow::instance().
  *
  * @author Marty Stepp
+ * @version 2022/03/20
+ * - added getPendingOutputSize
  * @version 2021/04/09
  * - added sgl namespace
  * @version 2021/04/03
@@ -27,6 +29,7 @@
 #ifndef _gconsolewindow_h
 #define _gconsolewindow_h
 
+#include <atomic>
 #include <iostream>
 #include <list>
 #include <sstream>
@@ -82,6 +85,7 @@ public:
     std::string getForeground() const override;
     int getForegroundInt() const override;
     virtual std::string getOutputColor() const;
+    virtual int getPendingOutputSize() const;
     virtual std::string getUserInputColor() const;
     virtual bool hasInputScript() const;
     virtual bool isClearEnabled() const;
@@ -189,6 +193,7 @@ private:
     QReadWriteLock _cinMutex;
     QReadWriteLock _cinQueueMutex;
     QMutex _coutMutex;
+    std::atomic<int> _pendingOutputSize;   // chars printed but not yet shown
 };
 
 } // namespace sgl
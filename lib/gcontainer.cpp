@@ -3,6 +3,8 @@
  * --------------------
  *
  * @author Marty Stepp
+ * @version 2022/03/20
+ * - setters can be batched by GTransaction
  * @version 2021/04/09
  * - added sgl namespace
  * @version 2021/04/03
@@ -76,7 +78,7 @@ void GContainer::add(GInteractor* interactor) {
     interactor->setContainer(this);
     _interactors.push_back(interactor);
 
-    GThread::runOnQtGuiThread([this, widget]() {
+    GThread::runOnQtGuiThreadBatchable([this, widget]() {
         widget->setParent(_iqcontainer);
         _iqcontainer->add(widget);
     });
@@ -93,7 +95,7 @@ void GContainer::addToGrid(GInteractor* interactor, int row, int col, int rowspa
         return;
     }
 
-    GThread::runOnQtGuiThread([this, widget, row, col, rowspan, colspan]() {
+    GThread::runOnQtGuiThreadBatchable([this, widget, row, col, rowspan, colspan]() {
         _iqcontainer->addToGrid(widget, row, col, rowspan, colspan);
     });
 }
@@ -118,7 +120,7 @@ void GContainer::addToRegion(GInteractor* interactor, Region region) {
     _interactors.push_back(interactor);
     _interactorsByRegion[region].push_back(interactor);
 
-    GThread::runOnQtGuiThread([this, widget, region]() {
+    GThread::runOnQtGuiThreadBatchable([this, widget, region]() {
         _iqcontainer->addToRegion(widget, region);
     });
 }
@@ -142,7 +144,7 @@ void GContainer::clear() {
     _interactors.clear();
     _interactorsByRegion.clear();
 
-    GThread::runOnQtGuiThread([this]() {
+    GThread::runOnQtGuiThreadBatchable([this]() {
         _iqcontainer->clear();
     });
 }
@@ -155,7 +157,7 @@ void GContainer::clearRegion(Region region) {
     }
     _interactorsByRegion.erase(region);
 
-    GThread::runOnQtGuiThread([this, region]() {
+    GThread::runOnQtGuiThreadBatchable([this, region]() {
         _iqcontainer->clearRegion(region);
     });
 }
@@ -313,7 +315,7 @@ void GContainer::insert(int index, GInteractor* interactor) {
     interactor->setContainer(this);
     _interactors.insert(_interactors.begin() + index, interactor);
 
-    GThread::runOnQtGuiThread([this, index, widget]() {
+    GThread::runOnQtGuiThreadBatchable([this, index, widget]() {
         _iqcontainer->insert(index, widget);
     });
 }
@@ -333,7 +335,7 @@ void GContainer::insertToRegion(int index, GInteractor* interactor, Region regio
     _interactors.push_back(interactor);
     _interactorsByRegion[region].insert(_interactorsByRegion[region].begin() + index, interactor);
 
-    GThread::runOnQtGuiThread([this, index, widget, region]() {
+    GThread::runOnQtGuiThreadBatchable([this, index, widget, region]() {
         _iqcontainer->insertToRegion(index, widget, region);
     });
 }
@@ -385,7 +387,7 @@ void GContainer::remove(GInteractor* interactor) {
     interactor->setContainer(nullptr);
     std::remove(_interactors.begin(), _interactors.end(), interactor);
 
-    GThread::runOnQtGuiThread([this, widget]() {
+    GThread::runOnQtGuiThreadBatchable([this, widget]() {
         _iqcontainer->remove(widget);
     });
 }
@@ -399,7 +401,7 @@ void GContainer::remove(int index) {
     interactor->setContainer(nullptr);
     _interactors.erase(_interactors.begin() + index);
 
-    GThread::runOnQtGuiThread([this, index]() {
+    GThread::runOnQtGuiThreadBatchable([this, index]() {
         _iqcontainer->remove(index);
     });
 }
@@ -415,7 +417,7 @@ void GContainer::removeFromRegion(GInteractor* interactor, Region region) {
     std::remove(_interactors.begin(), _interactors.end(), interactor);
     std::remove(_interactorsByRegion[region].begin(), _interactorsByRegion[region].end(), interactor);
 
-    GThread::runOnQtGuiThread([this, widget, region]() {
+    GThread::runOnQtGuiThreadBatchable([this, widget, region]() {
         _iqcontainer->removeFromRegion(widget, region);
     });
 }
@@ -438,7 +440,7 @@ void GContainer::removeFromRegion(int index, Region region) {
     std::remove(_interactors.begin(), _interactors.end(), interactor);
     _interactorsByRegion[region].erase(_interactorsByRegion[region].begin() + index);
 
-    GThread::runOnQtGuiThread([this, index, region]() {
+    GThread::runOnQtGuiThreadBatchable([this, index, region]() {
         _iqcontainer->removeFromRegion(index, region);
     });
 }
@@ -453,13 +455,13 @@ void GContainer::setAlignment(HorizontalAlignment halign, VerticalAlignment vali
 }
 
 void GContainer::setHorizontalAlignment(HorizontalAlignment halign) {
-    GThread::runOnQtGuiThread([this, halign]() {
+    GThread::runOnQtGuiThreadBatchable([this, halign]() {
         _iqcontainer->setHorizontalAlignment(halign);
     });
 }
 
 void GContainer::setMargin(double px) {
-    GThread::runOnQtGuiThread([this, px]() {
+    GThread::runOnQtGuiThreadBatchable([this, px]() {
         _iqcontainer->setMargin((int) px);
     });
 }
@@ -473,7 +475,7 @@ void GContainer::setPadding(double topBottom, double leftRight) {
 }
 
 void GContainer::setPadding(double top, double right, double bottom, double left) {
-    GThread::runOnQtGuiThread([this, top, right, bottom, left]() {
+    GThread::runOnQtGuiThreadBatchable([this, top, right, bottom, left]() {
         _iqcontainer->setPadding((int) top, (int) right, (int) bottom, (int) left);
     });
 }
@@ -487,7 +489,7 @@ void GContainer::setRegionAlignment(Region region, VerticalAlignment valign) {
 }
 
 void GContainer::setRegionAlignment(Region region, HorizontalAlignment halign, VerticalAlignment valign) {
-    GThread::runOnQtGuiThread([this, region, halign, valign]() {
+    GThread::runOnQtGuiThreadBatchable([this, region, halign, valign]() {
         _iqcontainer->setRegionAlignment(region, halign, valign);
     });
 }
@@ -505,7 +507,7 @@ void GContainer::setRegionAlignment(const std::string& region, const std::string
 }
 
 void GContainer::setRegionHorizontalAlignment(Region region, HorizontalAlignment halign) {
-    GThread::runOnQtGuiThread([this, region, halign]() {
+    GThread::runOnQtGuiThreadBatchable([this, region, halign]() {
         _iqcontainer->setRegionHorizontalAlignment(region, halign);
     });
 }
@@ -515,7 +517,7 @@ void GContainer::setRegionHorizontalAlignment(const std::string& region, const s
 }
 
 void GContainer::setRegionVerticalAlignment(Region region, VerticalAlignment valign) {
-    GThread::runOnQtGuiThread([this, region, valign]() {
+    GThread::runOnQtGuiThreadBatchable([this, region, valign]() {
         _iqcontainer->setRegionVerticalAlignment(region, valign);
     });
 }
@@ -525,13 +527,13 @@ void GContainer::setRegionVerticalAlignment(const std::string& region, const std
 }
 
 void GContainer::setSpacing(double px) {
-    GThread::runOnQtGuiThread([this, px]() {
+    GThread::runOnQtGuiThreadBatchable([this, px]() {
         _iqcontainer->setSpacing((int) px);
     });
 }
 
 void GContainer::setVerticalAlignment(VerticalAlignment valign) {
-    GThread::runOnQtGuiThread([this, valign]() {
+    GThread::runOnQtGuiThreadBatchable([this, valign]() {
         _iqcontainer->setVerticalAlignment(valign);
     });
 }
@@ -3,6 +3,10 @@
  * ------------------
  * 
  * @author Marty Stepp
+ * @version 2022/03/20
+ * - panes draw only the lines in view, from an index of where each line starts
+ * - diff is computed in the background so the window opens at once
+ * - added previous/next difference navigation
  * @version 2021/04/09
  * - added sgl namespace
  * @version 2021/04/03
@@ -20,13 +24,18 @@
  */
 
 #include "gdiffgui.h"
+#include <algorithm>
 #include <cctype>
+#include <cstring>
 #include <iostream>
 #include <vector>
+#include <QKeyEvent>
+#include <QPainter>
 #include <QScrollBar>
 #include <sstream>
 #include <string>
 #include "consoletext.h"
+#include "gfont.h"
 #include "gthread.h"
 #include "privatestrlib.h"
 
@@ -84,70 +93,33 @@ GDiffGui::GDiffGui(const std::string& name1,
                    const std::string& name2,
                    const std::string& text2,
                    int diffFlags,
-                   bool /*showCheckBoxes*/) {
-    GThread::runOnQtGuiThread([this, name1, text1, name2, text2, diffFlags]() {
-        std::string diffs = ::sgl::priv::diff::diff(text1, text2, diffFlags);
-
-        _window = new GWindow(800, 600);
-        _window->setTitle("Compare Output");
-        _hsplitter = new QSplitter(/* orientation */ Qt::Horizontal, /* parent */ _window->getWidget());
-        _window->setCloseOperation(GWindow::CLOSE_HIDE);
-
-        // function to close the window when Escape is pressed
-        // (similar to code in gdiffimage.cpp)
-        auto windowCloseLambda = [this](GEvent event) {
-            if (event.getType() == KEY_PRESSED && event.getKeyChar() == GEvent::ESCAPE_KEY) {
-                _window->close();
-            }
-        };
-
-        std::string font = getConsoleFont();
-        _textAreaLeft  = new GTextArea();
-        setupLeftRightText(_textAreaLeft, name1 + ":\n" + text1);
-        _textAreaLeft->setEditable(false);
-        _textAreaLeft->setFont(font);
-        _textAreaLeft->setLineWrap(false);
-        _textAreaLeft->setKeyListener(windowCloseLambda);
-        _textAreaLeft->setEventListener("scroll", [this]() {
-            syncScrollBars(/* left */ true);
-        });
-
-        _textAreaRight = new GTextArea();
-        setupLeftRightText(_textAreaRight, name2 + ":\n" + text2);
-        _textAreaRight->setEditable(false);
-        _textAreaRight->setFont(font);
-        _textAreaRight->setLineWrap(false);
-        _textAreaRight->setKeyListener(windowCloseLambda);
-        _textAreaRight->setEventListener("scroll", [this]() {
-            syncScrollBars(/* left */ false);
-        });
+                   bool /*showCheckBoxes*/)
+        : _name1(name1),
+          _name2(name2),
+          _text1(text1),
+          _text2(text2),
+          _diffFlags(diffFlags),
+          _diffDone(false),
+          _currentHunk(-1),
+          _syncing(false) {
+    // only where each line starts is worked out up front; lines are pulled
+    // out of the text when they scroll into view
+    _lines1.build(&_text1);
+    _lines2.build(&_text2);
 
-        _textAreaBottom = new GTextArea("Differences:\n");
-        _textAreaBottom->setEditable(false);
-        _textAreaBottom->setFont(font);
-        _textAreaBottom->setLineWrap(false);
-        _textAreaBottom->setKeyListener(windowCloseLambda);
-        setupDiffText(diffs);
-        _hsplitter->addWidget(_textAreaLeft->getWidget());
-        _hsplitter->addWidget(_textAreaRight->getWidget());
-        _hsplitter->setStretchFactor(0, 1);
-        _hsplitter->setStretchFactor(1, 1);
-        _hsplitter->setSizes(QList<int>({INT_MAX, INT_MAX}));   // evenly size the two halves
-        _hsplitterInteractor = new GGenericInteractor<QSplitter>(_hsplitter);
-
-        _vsplitter = new QSplitter(/* orientation */ Qt::Vertical, /* parent */ _window->getWidget());
-        _vsplitter->addWidget(_hsplitter);
-        _vsplitter->addWidget(_textAreaBottom->getWidget());
-        _vsplitter->setStretchFactor(0, 1);
-        _vsplitter->setStretchFactor(1, 1);
-        _vsplitter->setSizes(QList<int>({INT_MAX, INT_MAX}));   // evenly size the two halves
-        _vsplitterInteractor = new GGenericInteractor<QSplitter>(_vsplitter);
-
-        _window->addToRegion(_vsplitterInteractor, GWindow::REGION_CENTER);
-        _window->setKeyListener(windowCloseLambda);
-        _window->center();
-        _window->show();
+    GThread::runOnQtGuiThread([this]() {
+        setupPanes();
     });
+
+    // diffing large outputs takes a while, so the window shows both texts
+    // right away and the differences fill in when they are ready
+    GThread::runInNewThreadAsync([this]() {
+        std::vector<::sgl::priv::diff::DiffHunk> hunks =
+                ::sgl::priv::diff::diffHunks(_text1, _text2, _diffFlags);
+        GThread::runOnQtGuiThreadAsync([this, hunks]() {
+            showHunks(hunks);
+        });
+    }, "GDiffGui");
 }
 
 GDiffGui::~GDiffGui() {
@@ -155,73 +127,420 @@ GDiffGui::~GDiffGui() {
     _window = nullptr;
     _hsplitter = nullptr;
     _vsplitter = nullptr;
-    _textAreaLeft = nullptr;
-    _textAreaRight = nullptr;
-    _textAreaBottom = nullptr;
+    _paneLeft = nullptr;
+    _paneRight = nullptr;
+    _paneBottom = nullptr;
     _hsplitterInteractor = nullptr;
     _vsplitterInteractor = nullptr;
+    _previousButton = nullptr;
+    _nextButton = nullptr;
+    _hunkLabel = nullptr;
 }
 
-void GDiffGui::setupDiffText(const std::string& diffs) {
-    std::vector<std::string> lines = sgl::priv::strlib::split(diffs, "\n");
-    const std::string COLOR_NORMAL = _textAreaBottom->getColor();
-    for (std::string line : lines) {
-        std::string color;
-        if (sgl::priv::strlib::startsWith(line, "EXPECTED <")) {
-            color = GWindow::chooseLightDarkModeColor(COLOR_EXPECTED, COLOR_EXPECTED_DARK_MODE);
-        } else if (sgl::priv::strlib::startsWith(line, "STUDENT  >")) {
-            color = GWindow::chooseLightDarkModeColor(COLOR_STUDENT, COLOR_STUDENT_DARK_MODE);
-        } else {
-            color = COLOR_NORMAL;
+void GDiffGui::setupPanes() {
+    _window = new GWindow(800, 600);
+    _window->setTitle("Compare Output");
+    _hsplitter = new QSplitter(/* orientation */ Qt::Horizontal, /* parent */ _window->getWidget());
+    _window->setCloseOperation(GWindow::CLOSE_HIDE);
+
+    // function to close the window when Escape is pressed
+    // (similar to code in gdiffimage.cpp)
+    auto windowCloseLambda = [this](GEvent event) {
+        if (event.getType() == KEY_PRESSED && event.getKeyChar() == GEvent::ESCAPE_KEY) {
+            _window->close();
         }
+    };
+    auto keyLambda = [this](int key) {
+        return handleKey(key);
+    };
 
-        // BUGFIX: display special characters with extra printable character info
-        line = toPrintable(line);
+    QFont font = GFont::toQFont(getConsoleFont());
+    std::string numberColor = GWindow::chooseLightDarkModeColor(COLOR_LINE_NUMBERS, COLOR_LINE_NUMBERS_DARK_MODE);
+    std::string expectedColor = GWindow::chooseLightDarkModeColor(COLOR_EXPECTED, COLOR_EXPECTED_DARK_MODE);
+    std::string studentColor = GWindow::chooseLightDarkModeColor(COLOR_STUDENT, COLOR_STUDENT_DARK_MODE);
 
-        _textAreaBottom->appendFormattedText(line + "\n", color);
+    // the left and right panes show each text under its name, with the lines
+    // that differ in the same colors as the bottom pane
+    for (int side = 0; side < 2; side++) {
+        bool left = side == 0;
+        const LineIndex* lines = left ? &_lines1 : &_lines2;
+        std::string name = left ? _name1 : _name2;
+        std::string color = left ? expectedColor : studentColor;
+        int count = lines->size() + 1;
+        int digits = static_cast<int>(std::to_string(count).length());
+        _Internal_QDiffPane* pane = new _Internal_QDiffPane();
+        pane->setFont(font);
+        pane->setNumberColor(numberColor);
+        pane->setKeyHandler(keyLambda);
+        pane->setScrollHandler([this, left]() {
+            syncScrollBars(left);
+        });
+        pane->setLines(count, [this, lines, name, color, digits, left](int i) -> _Internal_QDiffPane::Line {
+            _Internal_QDiffPane::Line line;
+            if (i == 0) {
+                line.text = toPrintable(name + ":");
+            } else {
+                line.text = toPrintable(lines->line(i - 1));
+                // the last hunk that starts at or before this line
+                auto after = std::upper_bound(_hunks.begin(), _hunks.end(), i - 1,
+                        [left](int n, const ::sgl::priv::diff::DiffHunk& hunk) {
+                    return n < (left ? hunk.start1 : hunk.start2);
+                });
+                if (after != _hunks.begin()) {
+                    const ::sgl::priv::diff::DiffHunk& hunk = *(after - 1);
+                    if (i - 1 < (left ? hunk.end1 : hunk.end2)) {
+                        line.color = color;
+                    }
+                }
+            }
+            if (LINE_NUMBERS) {
+                line.number = sgl::priv::strlib::padLeft(i == 0 ? std::string("") : std::to_string(i), digits) + "  ";
+            }
+            return line;
+        });
+        (left ? _paneLeft : _paneRight) = pane;
     }
+
+    _paneBottom = new _Internal_QDiffPane();
+    _paneBottom->setFont(font);
+    _paneBottom->setKeyHandler(keyLambda);
+    _paneBottom->setLines(2, [](int i) {
+        _Internal_QDiffPane::Line line;
+        line.text = i == 0 ? "Differences:" : "Comparing...";
+        return line;
+    });
+
+    _hsplitter->addWidget(_paneLeft);
+    _hsplitter->addWidget(_paneRight);
+    _hsplitter->setStretchFactor(0, 1);
+    _hsplitter->setStretchFactor(1, 1);
+    _hsplitter->setSizes(QList<int>({INT_MAX, INT_MAX}));   // evenly size the two halves
+    _hsplitterInteractor = new GGenericInteractor<QSplitter>(_hsplitter);
+
+    _vsplitter = new QSplitter(/* orientation */ Qt::Vertical, /* parent */ _window->getWidget());
+    _vsplitter->addWidget(_hsplitter);
+    _vsplitter->addWidget(_paneBottom);
+    _vsplitter->setStretchFactor(0, 1);
+    _vsplitter->setStretchFactor(1, 1);
+    _vsplitter->setSizes(QList<int>({INT_MAX, INT_MAX}));   // evenly size the two halves
+    _vsplitterInteractor = new GGenericInteractor<QSplitter>(_vsplitter);
+
+    _previousButton = new GButton("Previous difference");
+    _previousButton->setActionListener([this]() {
+        handleKey(Qt::Key_P);
+    });
+    _nextButton = new GButton("Next difference");
+    _nextButton->setActionListener([this]() {
+        handleKey(Qt::Key_N);
+    });
+    _hunkLabel = new GLabel();
+    updateHunkLabel();
+
+    _window->addToRegion(_vsplitterInteractor, GWindow::REGION_CENTER);
+    _window->addToRegion(_previousButton, GWindow::REGION_SOUTH);
+    _window->addToRegion(_hunkLabel, GWindow::REGION_SOUTH);
+    _window->addToRegion(_nextButton, GWindow::REGION_SOUTH);
+    _window->setKeyListener(windowCloseLambda);
+    _window->center();
+    _window->show();
 }
 
-void GDiffGui::setupLeftRightText(GTextArea* textArea, const std::string& text) {
-    if (!LINE_NUMBERS) {
-        textArea->setText(text);
-        return;
+void GDiffGui::showHunks(const std::vector<::sgl::priv::diff::DiffHunk>& hunks) {
+    // keep only the hunks diff() would print, and work out where each one
+    // starts in the bottom pane: a blank line between hunks, the description,
+    // then the expected and student lines
+    _hunks.clear();
+    _bottomStarts.clear();
+    std::vector<std::string> descriptions;
+    int lineCount = 1;   // after "Differences:"
+    for (const ::sgl::priv::diff::DiffHunk& hunk : hunks) {
+        std::string description = ::sgl::priv::diff::describeHunk(hunk, _diffFlags);
+        if (description.empty()) {
+            continue;
+        }
+        _hunks.push_back(hunk);
+        _bottomStarts.push_back(lineCount);
+        descriptions.push_back(description);
+        lineCount += (_hunks.size() > 1 ? 1 : 0) + 1 + (hunk.end1 - hunk.start1) + (hunk.end2 - hunk.start2);
+    }
+    _diffDone = true;
+    _currentHunk = -1;
+
+    std::string expectedColor = GWindow::chooseLightDarkModeColor(COLOR_EXPECTED, COLOR_EXPECTED_DARK_MODE);
+    std::string studentColor = GWindow::chooseLightDarkModeColor(COLOR_STUDENT, COLOR_STUDENT_DARK_MODE);
+    if (_hunks.empty()) {
+        _paneBottom->setLines(2, [](int i) {
+            _Internal_QDiffPane::Line line;
+            line.text = i == 0 ? "Differences:" : ::sgl::priv::diff::NO_DIFFS_MESSAGE;
+            return line;
+        });
+    } else {
+        _paneBottom->setLines(lineCount, [this, descriptions, expectedColor, studentColor](int i) -> _Internal_QDiffPane::Line {
+            _Internal_QDiffPane::Line line;
+            if (i == 0) {
+                line.text = "Differences:";
+                return line;
+            }
+            int h = static_cast<int>(std::upper_bound(_bottomStarts.begin(), _bottomStarts.end(), i)
+                                     - _bottomStarts.begin()) - 1;
+            const ::sgl::priv::diff::DiffHunk& hunk = _hunks[h];
+            int k = i - _bottomStarts[h];
+            if (h > 0 && k-- == 0) {
+                return line;   // blank line between hunks
+            }
+            if (k == 0) {
+                line.text = toPrintable(descriptions[h]);
+            } else if (--k < hunk.end1 - hunk.start1) {
+                // BUGFIX: display special characters with extra printable character info
+                line.text = toPrintable("EXPECTED < " + _lines1.line(hunk.start1 + k));
+                line.color = expectedColor;
+            } else {
+                k -= hunk.end1 - hunk.start1;
+                line.text = toPrintable("STUDENT  > " + _lines2.line(hunk.start2 + k));
+                line.color = studentColor;
+            }
+            return line;
+        });
     }
 
-    std::vector<std::string> lines = sgl::priv::strlib::split(text, "\n");
-    const std::string COLOR_NORMAL = textArea->getColor();
-    for (int i = 0; i < lines.size(); i++) {
-        std::string line = lines[i];
+    // recolor the lines that differ
+    _paneLeft->viewport()->update();
+    _paneRight->viewport()->update();
+    updateHunkLabel();
+}
+
+void GDiffGui::jumpToHunk(int index) {
+    // a few lines above the hunk stay in view for context
+    static const int CONTEXT = 3;
+    const ::sgl::priv::diff::DiffHunk& hunk = _hunks[index];
+    _syncing = true;
+    _paneLeft->scrollToLine(std::max(0, hunk.start1 + 1 - CONTEXT));
+    _paneRight->scrollToLine(std::max(0, hunk.start2 + 1 - CONTEXT));
+    _paneBottom->scrollToLine(_bottomStarts[index]);
+    _syncing = false;
+    _currentHunk = index;
+    updateHunkLabel();
+}
+
+void GDiffGui::updateHunkLabel() {
+    std::string text;
+    if (!_diffDone) {
+        text = "Comparing...";
+    } else if (_hunks.empty()) {
+        text = ::sgl::priv::diff::NO_DIFFS_MESSAGE;
+    } else if (_currentHunk < 0) {
+        text = std::to_string(_hunks.size()) + " difference" + (_hunks.size() == 1 ? "" : "s");
+    } else {
+        text = "Difference " + std::to_string(_currentHunk + 1) + " of " + std::to_string(_hunks.size());
+    }
+    _hunkLabel->setText(text);
+    _previousButton->setEnabled(!_hunks.empty());
+    _nextButton->setEnabled(!_hunks.empty());
+}
 
-        // insert a gray line number at start of each line
-        int digits = static_cast<int>(std::to_string(lines.size()).length());
-        std::string lineNumberString =
-                sgl::priv::strlib::padLeft(i == 0 ? std::string("") : std::to_string(i), digits) + "  ";
-        textArea->appendFormattedText(lineNumberString, GWindow::chooseLightDarkModeColor(COLOR_LINE_NUMBERS, COLOR_LINE_NUMBERS_DARK_MODE));
-        textArea->appendFormattedText(toPrintable(line) + "\n", COLOR_NORMAL);
+int GDiffGui::mapLine(int line, bool left) const {
+    // line 0 of each pane is the name; text line t is pane line t + 1
+    if (line <= 0) {
+        return 0;
+    }
+    int t = line - 1;
+    auto after = std::upper_bound(_hunks.begin(), _hunks.end(), t,
+            [left](int n, const ::sgl::priv::diff::DiffHunk& hunk) {
+        return n < (left ? hunk.start1 : hunk.start2);
+    });
+    if (after == _hunks.begin()) {
+        return line;   // everything above matched
     }
+    const ::sgl::priv::diff::DiffHunk& hunk = *(after - 1);
+    int start = left ? hunk.start1 : hunk.start2;
+    int end = left ? hunk.end1 : hunk.end2;
+    int otherStart = left ? hunk.start2 : hunk.start1;
+    int otherEnd = left ? hunk.end2 : hunk.end1;
+    if (t < end) {
+        return otherStart + std::min(t - start, otherEnd - otherStart) + 1;
+    }
+    return t - end + otherEnd + 1;
 }
 
 void GDiffGui::syncScrollBars(bool left) {
-    QTextEdit* qleft  = static_cast<QTextEdit*>(_textAreaLeft->getWidget());
-    QTextEdit* qright = static_cast<QTextEdit*>(_textAreaRight->getWidget());
+    if (_syncing) {
+        return;
+    }
+    // adjust the other pane to show the lines matching this one's
+    _syncing = true;
     if (left) {
-        // adjust the right scrollbar to match the left one
-        GThread::runOnQtGuiThreadAsync([qleft, qright]() {
-            int lval = qleft->verticalScrollBar()->value();
-            int rmax = qright->verticalScrollBar()->maximum();
-            int rval = std::max(0, std::min(lval, rmax));
-            qright->verticalScrollBar()->setValue(rval);
-        });
+        _paneRight->scrollToLine(mapLine(_paneLeft->getFirstLine(), true));
+    } else {
+        _paneLeft->scrollToLine(mapLine(_paneRight->getFirstLine(), false));
+    }
+    _syncing = false;
+
+    // scrolling by hand moves away from the current hunk
+    if (_currentHunk >= 0) {
+        _currentHunk = -1;
+        updateHunkLabel();
+    }
+}
+
+bool GDiffGui::handleKey(int key) {
+    if (key == Qt::Key_Escape) {
+        _window->close();
+        return true;
+    } else if (key != Qt::Key_N && key != Qt::Key_P) {
+        return false;
+    } else if (_hunks.empty()) {
+        return true;
+    }
+
+    bool next = key == Qt::Key_N;
+    int index;
+    if (_currentHunk >= 0) {
+        index = _currentHunk + (next ? 1 : -1);
     } else {
-        // adjust the left scrollbar to match the right one
-        GThread::runOnQtGuiThreadAsync([qleft, qright]() {
-            int rval = qright->verticalScrollBar()->value();
-            int lmax = qleft->verticalScrollBar()->maximum();
-            int lval = std::max(0, std::min(rval, lmax));
-            qleft->verticalScrollBar()->setValue(lval);
+        // after scrolling by hand, go from the top of the left pane
+        int top = _paneLeft->getFirstLine();
+        auto after = std::upper_bound(_hunks.begin(), _hunks.end(), top,
+                [](int line, const ::sgl::priv::diff::DiffHunk& hunk) {
+            return line < hunk.start1 + 1;
         });
+        index = static_cast<int>(after - _hunks.begin()) - (next ? 0 : 1);
+    }
+    if (index >= 0 && index < static_cast<int>(_hunks.size())) {
+        jumpToHunk(index);
+    }
+    return true;
+}
+
+void GDiffGui::LineIndex::build(const std::string* text) {
+    _text = text;
+    _starts.clear();
+    const char* data = text->data();
+    size_t start = 0;
+    while (start < text->length()) {
+        _starts.push_back(start);
+        const void* newline = memchr(data + start, '\n', text->length() - start);
+        if (!newline) {
+            break;
+        }
+        start = static_cast<const char*>(newline) - data + 1;
+    }
+}
+
+int GDiffGui::LineIndex::size() const {
+    return static_cast<int>(_starts.size());
+}
+
+std::string GDiffGui::LineIndex::line(int i) const {
+    size_t start = _starts[i];
+    size_t end = (i + 1 < size()) ? _starts[i + 1] - 1 : _text->length();
+    if (i + 1 == size() && end > start && (*_text)[end - 1] == '\n') {
+        end--;
+    }
+    return _text->substr(start, end - start);
+}
+
+
+_Internal_QDiffPane::_Internal_QDiffPane(QWidget* parent)
+        : QAbstractScrollArea(parent),
+          _count(0),
+          _widest(0) {
+    setFocusPolicy(Qt::StrongFocus);
+    connect(verticalScrollBar(), &QScrollBar::valueChanged, [this](int /*value*/) {
+        if (_scrollHandler) {
+            _scrollHandler();
+        }
+    });
+}
+
+int _Internal_QDiffPane::getFirstLine() const {
+    return verticalScrollBar()->value();
+}
+
+void _Internal_QDiffPane::keyPressEvent(QKeyEvent* event) {
+    if (_keyHandler && _keyHandler(event->key())) {
+        event->accept();
+    } else {
+        QAbstractScrollArea::keyPressEvent(event);   // arrows, page up/down
     }
 }
 
+int _Internal_QDiffPane::lineHeight() const {
+    return std::max(1, QFontMetrics(font()).lineSpacing());
+}
+
+void _Internal_QDiffPane::paintEvent(QPaintEvent* /*event*/) {
+    static const int MARGIN = 4;
+    QPainter painter(viewport());
+    QFontMetrics metrics(font());
+    int height = lineHeight();
+    int first = verticalScrollBar()->value();
+    int x0 = MARGIN - horizontalScrollBar()->value();
+    QColor normalColor = palette().color(QPalette::Text);
+    QColor numberColor = _numberColor.empty() ? normalColor : QColor(QString::fromStdString(_numberColor));
+    int widest = _widest;
+
+    // only the lines in view are fetched and drawn
+    for (int row = 0; row * height < viewport()->height() && first + row < _count; row++) {
+        Line line = _source(first + row);
+        int baseline = row * height + metrics.ascent();
+        QString number = QString::fromStdString(line.number);
+        QString text = QString::fromStdString(line.text);
+        painter.setPen(numberColor);
+        painter.drawText(x0, baseline, number);
+        int x = x0 + metrics.horizontalAdvance(number);
+        painter.setPen(line.color.empty() ? normalColor : QColor(QString::fromStdString(line.color)));
+        painter.drawText(x, baseline, text);
+        widest = std::max(widest, x - x0 + metrics.horizontalAdvance(text) + 2 * MARGIN);
+    }
+
+    // lines are only measured once seen, so the horizontal range grows as
+    // wider ones scroll into view
+    if (widest > _widest) {
+        _widest = widest;
+        updateScrollBars();
+    }
+}
+
+void _Internal_QDiffPane::resizeEvent(QResizeEvent* event) {
+    QAbstractScrollArea::resizeEvent(event);
+    updateScrollBars();
+}
+
+void _Internal_QDiffPane::scrollContentsBy(int /*dx*/, int /*dy*/) {
+    viewport()->update();
+}
+
+void _Internal_QDiffPane::scrollToLine(int line) {
+    verticalScrollBar()->setValue(line);   // clamped to the range
+}
+
+void _Internal_QDiffPane::setKeyHandler(std::function<bool(int key)> func) {
+    _keyHandler = func;
+}
+
+void _Internal_QDiffPane::setLines(int count, std::function<Line(int)> source) {
+    _count = count;
+    _source = source;
+    updateScrollBars();
+    viewport()->update();
+}
+
+void _Internal_QDiffPane::setNumberColor(const std::string& color) {
+    _numberColor = color;
+}
+
+void _Internal_QDiffPane::setScrollHandler(std::function<void()> func) {
+    _scrollHandler = func;
+}
+
+void _Internal_QDiffPane::updateScrollBars() {
+    int rows = std::max(1, viewport()->height() / lineHeight());
+    verticalScrollBar()->setSingleStep(1);
+    verticalScrollBar()->setPageStep(rows);
+    verticalScrollBar()->setRange(0, std::max(0, _count - rows));
+    horizontalScrollBar()->setSingleStep(std::max(1, QFontMetrics(font()).averageCharWidth()));
+    horizontalScrollBar()->setPageStep(viewport()->width());
+    horizontalScrollBar()->setRange(0, std::max(0, _widest - viewport()->width()));
+}
+
 } // namespace sgl
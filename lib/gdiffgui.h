@@ -3,6 +3,10 @@
  * ----------------
  * 
  * @author Marty Stepp
+ * @version 2022/03/20
+ * - panes draw only the lines in view, from an index of where each line starts
+ * - diff is computed in the background so the window opens at once
+ * - added previous/next difference navigation
  * @version 2021/04/09
  * - added sgl namespace
  * @version 2018/10/06
@@ -19,17 +23,23 @@
 #ifndef _gdiffgui_h
 #define _gdiffgui_h
 
+#include <functional>
 #include <string>
+#include <vector>
+#include <QAbstractScrollArea>
 #include <QWidget>
 #include <QSplitter>
 
+#include "gbutton.h"
 #include "ginteractor.h"
-#include "gtextarea.h"
+#include "glabel.h"
 #include "gwindow.h"
 #include "privatediff.h"
 
 namespace sgl {
 
+class _Internal_QDiffPane;
+
 /**
  * A GDiffGui is a graphical window that displays differences between two
  * text strings.  This class is used to implement the "Compare Output" feature
@@ -70,18 +80,92 @@ private:
 
     Q_DISABLE_COPY(GDiffGui)
 
-    void setupDiffText(const std::string& diffs);
-    void setupLeftRightText(GTextArea* textArea, const std::string& text);
+    // Byte offsets where each line of a text starts, cut the way
+    // split(text, "\n") cuts it
+    class LineIndex {
+    public:
+        void build(const std::string* text);
+        int size() const;
+        std::string line(int i) const;
+
+    private:
+        const std::string* _text = nullptr;
+        std::vector<size_t> _starts;
+    };
+
+    void setupPanes();
+    void showHunks(const std::vector<::sgl::priv::diff::DiffHunk>& hunks);
+    void jumpToHunk(int index);
+    void updateHunkLabel();
+    int mapLine(int line, bool left) const;
     void syncScrollBars(bool left);
+    bool handleKey(int key);
+
+    std::string _name1;
+    std::string _name2;
+    std::string _text1;
+    std::string _text2;
+    int _diffFlags;
+    LineIndex _lines1;
+    LineIndex _lines2;
+    bool _diffDone;
+    std::vector<::sgl::priv::diff::DiffHunk> _hunks;   // only the ones diff() shows
+    std::vector<int> _bottomStarts;   // line of the bottom pane where each hunk begins
+    int _currentHunk;
+    bool _syncing;
 
     GWindow* _window;
     QSplitter* _hsplitter;
     QSplitter* _vsplitter;
-    GTextArea* _textAreaLeft;
-    GTextArea* _textAreaRight;
-    GTextArea* _textAreaBottom;
+    _Internal_QDiffPane* _paneLeft;
+    _Internal_QDiffPane* _paneRight;
+    _Internal_QDiffPane* _paneBottom;
     GGenericInteractor<QSplitter>* _hsplitterInteractor;
     GGenericInteractor<QSplitter>* _vsplitterInteractor;
+    GButton* _previousButton;
+    GButton* _nextButton;
+    GLabel* _hunkLabel;
+};
+
+/**
+ * Internal class; not to be used by clients.
+ * A read-only scrolling text view that asks for and draws only the lines
+ * currently in view, so it costs the same however many lines it has.
+ * @private
+ */
+class _Internal_QDiffPane : public QAbstractScrollArea {
+public:
+    struct Line {
+        std::string number;   // drawn before the text in the line number color
+        std::string text;
+        std::string color;    // "" for the normal text color
+    };
+
+    _Internal_QDiffPane(QWidget* parent = nullptr);
+
+    int getFirstLine() const;
+    void scrollToLine(int line);
+    void setKeyHandler(std::function<bool(int key)> func);
+    void setLines(int count, std::function<Line(int)> source);
+    void setNumberColor(const std::string& color);
+    void setScrollHandler(std::function<void()> func);
+
+protected:
+    void keyPressEvent(QKeyEvent* event) override;
+    void paintEvent(QPaintEvent* event) override;
+    void resizeEvent(QResizeEvent* event) override;
+    void scrollContentsBy(int dx, int dy) override;
+
+private:
+    int lineHeight() const;
+    void updateScrollBars();
+
+    int _count;
+    int _widest;   // widest line drawn so far, in pixels
+    std::function<Line(int)> _source;
+    std::function<bool(int key)> _keyHandler;
+    std::function<void()> _scrollHandler;
+    std::string _numberColor;
 };
 
 } // namespace sgl
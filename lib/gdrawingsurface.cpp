@@ -3,6 +3,8 @@
  * -------------------------
  *
  * @author Marty Stepp
+ * @version 2022/03/20
+ * - checkBounds follows the require::Policy for per-pixel checks
  * @version 2021/04/09
  * - added sgl namespace
  * - converted Grid functionality to 2D array/vector
@@ -40,8 +42,11 @@ GDrawingSurface::~GDrawingSurface() {
     _forwardTarget = nullptr;
 }
 
-void GDrawingSurface::checkBounds(const std::string& member, double x, double y, double width, double height) const {
-    require::inRange2D(x, y, width - 1, height - 1, member);
+void GDrawingSurface::checkBounds(const std::string& member, double x, double y, double width, double height,
+                                  require::Policy policy) const {
+    if (require::shouldCheck(policy)) {
+        require::inRange2D(x, y, width - 1, height - 1, member);
+    }
 }
 
 void GDrawingSurface::checkColor(const std::string& /* member */, int /* rgb */) const {
@@ -3,6 +3,8 @@
  * -----------------------
  *
  * @author Marty Stepp
+ * @version 2022/03/20
+ * - checkBounds follows the require::Policy for per-pixel checks
  * @version 2021/04/09
  * - added sgl namespace
  * - converted Grid functionality to 2D array/vector
@@ -24,6 +26,7 @@
 #include <QWidget>
 #include "gobjects.h"
 #include "gtypes.h"
+#include "require.h"
 
 namespace sgl {
 
@@ -779,8 +782,11 @@ protected:
 
     /**
      * Throws an error if the given x/y values are out of bounds.
+     * Per-pixel callers leave the policy as the build's default; callers
+     * that check a whole region once pass require::CHECKED.
      */
-    void checkBounds(const std::string& member, double x, double y, double width, double height) const;
+    void checkBounds(const std::string& member, double x, double y, double width, double height,
+                     require::Policy policy = require::DEFAULT_POLICY) const;
 
     /**
      * Throws an error if the given rgb value is not a valid color.
@@ -3,6 +3,8 @@
  * --------------
  *
  * @author Marty Stepp
+ * @version 2022/03/20
+ * - GEventQueue can set the time of replayed events
  * @version 2021/04/09
  * - added sgl namespace
  * @version 2018/09/20
@@ -552,6 +554,7 @@ private:
     int _col;
     QEvent* _internalQtEvent;
 
+    friend class GEventQueue;
     friend class GInteractor;
     friend class GObservable;
     friend class _Internal_QWidget;
@@ -3,6 +3,9 @@
  * ---------------------
  *
  * @author Marty Stepp
+ * @version 2022/03/20
+ * - added getEventQueueSize, getFunctionQueueSize
+ * - added event recording and replay
  * @version 2021/04/09
  * - added sgl namespace
  * @version 2021/04/03
@@ -16,8 +19,17 @@
  */
 
 #include "qtgui.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
 #include <QEvent>
 #include "gexceptions.h"
+#include "gobservable.h"
 #include "gthread.h"
 #include "gtypes.h"
 #include "gwindow.h"
@@ -28,7 +40,11 @@ namespace sgl {
 GEventQueue* GEventQueue::_instance = nullptr;
 
 GEventQueue::GEventQueue()
-        : _eventMask(0) {
+        : _eventMask(0),
+          _recordingStart(0),
+          _isRecording(false),
+          _isReplaying(false),
+          _isSendingReplayedEvent(false) {
     // empty
 }
 
@@ -52,6 +68,22 @@ int GEventQueue::getEventMask() const {
     return _eventMask;
 }
 
+int GEventQueue::getEventQueueSize() const {
+    GEventQueue* thisHack = const_cast<GEventQueue*>(this);
+    thisHack->_eventQueueMutex.lockForRead();
+    int size = (int) _eventQueue.size();
+    thisHack->_eventQueueMutex.unlock();
+    return size;
+}
+
+int GEventQueue::getFunctionQueueSize() const {
+    GEventQueue* thisHack = const_cast<GEventQueue*>(this);
+    thisHack->_functionQueueMutex.lockForRead();
+    int size = (int) _functionQueue.size();
+    thisHack->_functionQueueMutex.unlock();
+    return size;
+}
+
 GEvent GEventQueue::getNextEvent(int mask) {
     setEventMask(mask);
 
@@ -78,6 +110,14 @@ GEvent GEventQueue::getNextEvent(int mask) {
     return bogusEvent;
 }
 
+std::vector<GRecordedEvent> GEventQueue::getRecording() const {
+    GEventQueue* thisHack = const_cast<GEventQueue*>(this);
+    thisHack->_recordingMutex.lockForRead();
+    std::vector<GRecordedEvent> events = _recordedEvents;
+    thisHack->_recordingMutex.unlock();
+    return events;
+}
+
 GEventQueue* GEventQueue::instance() {
     if (!_instance) {
         _instance = new GEventQueue();
@@ -97,6 +137,110 @@ bool GEventQueue::isEmpty() const {
     return _functionQueue.empty();
 }
 
+bool GEventQueue::isIgnoringEvent(const GEvent& event) const {
+    // while replaying, only the replayed events (and whatever their listeners
+    // cause) get through; window events still do so the window can be closed
+    return _isReplaying && !_isSendingReplayedEvent
+            && event.getEventClass() != WINDOW_EVENT;
+}
+
+bool GEventQueue::isRecording() const {
+    return _isRecording;
+}
+
+bool GEventQueue::isReplaying() const {
+    return _isReplaying;
+}
+
+/*
+ * Escapes tabs, newlines and backslashes so that the string fits in one
+ * tab-separated field of a recording file.
+ */
+static std::string escapeField(const std::string& s) {
+    std::string result;
+    for (char ch : s) {
+        if (ch == '\\') {
+            result += "\\\\";
+        } else if (ch == '\t') {
+            result += "\\t";
+        } else if (ch == '\n') {
+            result += "\\n";
+        } else {
+            result += ch;
+        }
+    }
+    return result;
+}
+
+/*
+ * Undoes escapeField.
+ */
+static std::string unescapeField(const std::string& s) {
+    std::string result;
+    for (size_t i = 0; i < s.length(); i++) {
+        if (s[i] == '\\' && i + 1 < s.length()) {
+            i++;
+            result += s[i] == 't' ? '\t' : s[i] == 'n' ? '\n' : s[i];
+        } else {
+            result += s[i];
+        }
+    }
+    return result;
+}
+
+// first line of a recording file
+static const std::string RECORDING_HEADER = "# GEventQueue recording 1";
+
+bool GEventQueue::loadRecording(const std::string& filename) {
+    std::ifstream input(filename);
+    std::string line;
+    if (!std::getline(input, line) || line != RECORDING_HEADER) {
+        return false;
+    }
+    std::vector<GRecordedEvent> events;
+    while (std::getline(input, line)) {
+        std::vector<std::string> fields;
+        size_t start = 0;
+        size_t tab;
+        while ((tab = line.find('\t', start)) != std::string::npos) {
+            fields.push_back(line.substr(start, tab - start));
+            start = tab + 1;
+        }
+        fields.push_back(line.substr(start));
+        if (fields.size() < 16) {
+            return false;
+        }
+        try {
+            GRecordedEvent recorded;
+            recorded.time = std::stol(fields[0]);
+            recorded.sourceID = std::stoi(fields[1]);
+            recorded.sourceType = unescapeField(fields[2]);
+            GEvent& event = recorded.event;
+            event._class = (EventClass) std::stoi(fields[3]);
+            event._type = (EventType) std::stoi(fields[4]);
+            event._name = unescapeField(fields[5]);
+            event._x = std::stod(fields[6]);
+            event._y = std::stod(fields[7]);
+            event._button = std::stoi(fields[8]);
+            event._keyCode = std::stoi(fields[9]);
+            event._keyChar = (char) std::stoi(fields[10]);
+            event._modifiers = std::stoi(fields[11]);
+            event._row = std::stoi(fields[12]);
+            event._col = std::stoi(fields[13]);
+            event._actionCommand = unescapeField(fields[14]);
+            event._requestUrl = unescapeField(fields[15]);
+            events.push_back(recorded);
+        } catch (const std::exception&) {
+            return false;
+        }
+    }
+
+    _recordingMutex.lockForWrite();
+    _recordedEvents.swap(events);
+    _recordingMutex.unlock();
+    return true;
+}
+
 GThunk GEventQueue::peek() {
     _functionQueueMutex.lockForRead();
     GThunk thunk = _functionQueue.front();
@@ -104,6 +248,88 @@ GThunk GEventQueue::peek() {
     return thunk;
 }
 
+void GEventQueue::recordEvent(const GEvent& event, int sourceID) {
+    GRecordedEvent recorded;
+    recorded.sourceID = sourceID;
+    recorded.sourceType = event.getSource()->getType();
+    recorded.event = event;
+    recorded.event._source = nullptr;
+    recorded.event._internalQtEvent = nullptr;
+
+    _recordingMutex.lockForWrite();
+    if (_isRecording && !_isReplaying) {
+        recorded.time = event.getTime() - _recordingStart;
+        _recordedEvents.push_back(recorded);
+    }
+    _recordingMutex.unlock();
+}
+
+GReplayStats GEventQueue::replay(bool realTime) {
+    if (GThread::iAmRunningOnTheQtGuiThread()) {
+        throw std::runtime_error("GEventQueue::replay: cannot be called from the Qt GUI thread");
+    }
+    typedef std::chrono::steady_clock Clock;
+    typedef std::chrono::duration<double, std::milli> Millis;
+
+    std::vector<GRecordedEvent> events = getRecording();
+    GReplayStats stats;
+    if (events.empty()) {
+        return stats;
+    }
+    stats.recordedTime = events.back().time - events.front().time;
+
+    _isReplaying = true;
+    Clock::time_point start = Clock::now();
+    long startTime = GEvent::getCurrentTimeMS();
+    try {
+        for (const GRecordedEvent& recorded : events) {
+            long offset = recorded.time - events.front().time;
+            if (realTime) {
+                std::this_thread::sleep_until(start + std::chrono::milliseconds(offset));
+                double late = Millis(Clock::now() - start).count() - offset;
+                stats.maxLateness = std::max(stats.maxLateness, late);
+            }
+
+            // look up the source on the Qt GUI thread, where it would be deleted
+            double latency = -1;
+            GThread::runOnQtGuiThread([this, &recorded, startTime, offset, &latency]() {
+                GObservable* source = GObservable::findObservable(recorded.sourceID);
+                if (!source || source->getType() != recorded.sourceType) {
+                    return;
+                }
+                GEvent event = recorded.event;
+                event._time = startTime + offset;
+                Clock::time_point began = Clock::now();
+                _isSendingReplayedEvent = true;
+                try {
+                    source->fireEvent(event);
+                } catch (...) {
+                    _isSendingReplayedEvent = false;
+                    throw;
+                }
+                _isSendingReplayedEvent = false;
+                latency = Millis(Clock::now() - began).count();
+            });
+
+            if (latency < 0) {
+                stats.skipped++;
+                continue;
+            }
+            stats.events++;
+            stats.latencies.push_back(latency);
+            if (recorded.event.getEventClass() == TIMER_EVENT) {
+                stats.frameTimes.push_back(latency);
+            }
+        }
+    } catch (...) {
+        _isReplaying = false;
+        throw;
+    }
+    _isReplaying = false;
+    stats.elapsedTime = Millis(Clock::now() - start).count();
+    return stats;
+}
+
 void GEventQueue::runOnQtGuiThreadAsync(GThunk thunk) {
     _functionQueueMutex.lockForWrite();
     _functionQueue.push(thunk);
@@ -130,10 +356,51 @@ void GEventQueue::runOnQtGuiThreadSync(GThunk thunk) {
     }
 }
 
+bool GEventQueue::saveRecording(const std::string& filename) const {
+    std::ofstream output(filename);
+    output << RECORDING_HEADER << std::endl;
+    output << std::setprecision(17);
+    for (const GRecordedEvent& recorded : getRecording()) {
+        const GEvent& event = recorded.event;
+        output << recorded.time << '\t'
+               << recorded.sourceID << '\t'
+               << escapeField(recorded.sourceType) << '\t'
+               << (int) event._class << '\t'
+               << (int) event._type << '\t'
+               << escapeField(event._name) << '\t'
+               << event._x << '\t'
+               << event._y << '\t'
+               << event._button << '\t'
+               << event._keyCode << '\t'
+               << (int) event._keyChar << '\t'
+               << event._modifiers << '\t'
+               << event._row << '\t'
+               << event._col << '\t'
+               << escapeField(event._actionCommand) << '\t'
+               << escapeField(event._requestUrl) << '\n';
+    }
+    output.flush();
+    return output.good();
+}
+
 void GEventQueue::setEventMask(int mask) {
     _eventMask = mask;
 }
 
+void GEventQueue::startRecording() {
+    _recordingMutex.lockForWrite();
+    _recordedEvents.clear();
+    _recordingStart = GEvent::getCurrentTimeMS();
+    _isRecording = true;
+    _recordingMutex.unlock();
+}
+
+void GEventQueue::stopRecording() {
+    _recordingMutex.lockForWrite();
+    _isRecording = false;
+    _recordingMutex.unlock();
+}
+
 GEvent GEventQueue::waitForEvent(int mask) {
     setEventMask(mask);
     while (true) {
@@ -160,6 +427,61 @@ GEvent GEventQueue::waitForEvent(int mask) {
     }
 }
 
+/*static*/ double GReplayStats::percentile(const std::vector<double>& times, double percent) {
+    if (times.empty()) {
+        return 0;
+    }
+    std::vector<double> sorted = times;
+    std::sort(sorted.begin(), sorted.end());
+    // nearest rank
+    int rank = (int) std::ceil(percent / 100 * sorted.size());
+    rank = std::max(1, std::min((int) sorted.size(), rank));
+    return sorted[rank - 1];
+}
+
+/*
+ * Writes the mean, median, 95th and 99th percentile and maximum of the given
+ * times to out.
+ */
+static void writeTimes(std::ostream& out, const std::vector<double>& times) {
+    double total = 0;
+    for (double time : times) {
+        total += time;
+    }
+    out << "mean " << (times.empty() ? 0 : total / times.size())
+        << ", median " << GReplayStats::percentile(times, 50)
+        << ", 95% " << GReplayStats::percentile(times, 95)
+        << ", 99% " << GReplayStats::percentile(times, 99)
+        << ", max " << GReplayStats::percentile(times, 100);
+}
+
+std::string GReplayStats::toString() const {
+    std::ostringstream out;
+    out << std::fixed << std::setprecision(3);
+    double seconds = elapsedTime / 1000;
+    out << "events: " << events << " replayed, " << skipped << " skipped" << std::endl;
+    out << "time: " << elapsedTime << " ms for " << recordedTime << " ms of recording";
+    if (seconds > 0) {
+        out << " (" << events / seconds << " events/s)";
+    }
+    out << std::endl;
+    out << "latency (ms): ";
+    writeTimes(out, latencies);
+    out << std::endl;
+    out << "frames: " << frameTimes.size();
+    if (seconds > 0) {
+        out << " (" << frameTimes.size() / seconds << " fps)";
+    }
+    out << std::endl;
+    out << "frame time (ms): ";
+    writeTimes(out, frameTimes);
+    out << std::endl;
+    if (maxLateness > 0) {
+        out << "behind schedule (ms): at most " << maxLateness << std::endl;
+    }
+    return out.str();
+}
+
 GEvent getNextEvent(int mask) {
     return GEventQueue::instance()->getNextEvent(mask);
 }
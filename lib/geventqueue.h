@@ -3,6 +3,9 @@
  * -------------------
  *
  * @author Marty Stepp
+ * @version 2022/03/20
+ * - added getEventQueueSize, getFunctionQueueSize
+ * - added event recording and replay
  * @version 2021/04/09
  * - added sgl namespace
  * @version 2021/04/03
@@ -19,8 +22,10 @@
 #ifndef _geventqueue_h
 #define _geventqueue_h
 
+#include <atomic>
 #include <queue>
 #include <string>
+#include <vector>
 #include <QObject>
 #include <QReadWriteLock>
 
@@ -33,6 +38,79 @@ class GObservable;
 class GThread;
 class QtGui;
 
+/**
+ * An event saved by GEventQueue::startRecording, along with when it happened
+ * and the object it happened to.
+ *
+ * @private
+ */
+struct GRecordedEvent {
+    /** Milliseconds after the recording was started. */
+    long time;
+
+    /**
+     * Which GObservable the event happened to, by the order they were created
+     * in: 1 for the first one the program made, 2 for the second, and so on.
+     */
+    int sourceID;
+
+    /** The type of that GObservable, such as "GButton" or "GWindow". */
+    std::string sourceType;
+
+    /** The event itself, without its source or underlying Qt event. */
+    GEvent event;
+};
+
+/**
+ * How long replaying a recording with GEventQueue::replay took.
+ * All times are in milliseconds.
+ *
+ * @private
+ */
+struct GReplayStats {
+    /** How many events were replayed. */
+    int events = 0;
+
+    /**
+     * How many events could not be replayed because the program has no
+     * object of the right type where the recording had one.
+     */
+    int skipped = 0;
+
+    /** Time from the first event of the recording to the last. */
+    double recordedTime = 0;
+
+    /** Time the whole replay took. */
+    double elapsedTime = 0;
+
+    /**
+     * For real-time replays, the furthest behind schedule any event was sent.
+     */
+    double maxLateness = 0;
+
+    /** Time each event's listener took, in the order they were replayed. */
+    std::vector<double> latencies;
+
+    /**
+     * Time each timer event's listener took.  Animated programs draw a frame
+     * per timer event, so these are their frame times.
+     */
+    std::vector<double> frameTimes;
+
+    /**
+     * Returns the given percentile (0-100) of the given times, or 0 if there
+     * are none.
+     */
+    static double percentile(const std::vector<double>& times, double percent);
+
+    /**
+     * Returns a summary of the replay: how many events and frames per second
+     * it managed, and the mean, median, 95th and 99th percentile and worst
+     * latency and frame time.
+     */
+    std::string toString() const;
+};
+
 /**
  * The GEventQueue is a first-in, first-out (FIFO) queue of events that occur
  * on graphical interactors.
@@ -62,12 +140,30 @@ public:
      */
     int getEventMask() const;
 
+    /**
+     * Returns the number of events waiting in the queue to be read by
+     * getNextEvent or waitForEvent.
+     */
+    int getEventQueueSize() const;
+
+    /**
+     * Returns the number of functions waiting in the queue to be run on
+     * the Qt GUI thread.
+     */
+    int getFunctionQueueSize() const;
+
     /**
      * Returns the next event that occurs that matches the given mask
      * of event types.
      */
     GEvent getNextEvent(int mask = ANY_EVENT);
 
+    /**
+     * Returns the events recorded since startRecording was called, or
+     * read by loadRecording.
+     */
+    std::vector<GRecordedEvent> getRecording() const;
+
     /**
      * Returns true if the given event would be accepted by the current
      * event mask, as per setEventMask.
@@ -75,6 +171,51 @@ public:
     bool isAcceptingEvent(const GEvent& event) const;
     bool isAcceptingEvent(int type) const;
 
+    /**
+     * Returns true if events are being recorded.
+     */
+    bool isRecording() const;
+
+    /**
+     * Returns true if a recording is being replayed.
+     */
+    bool isReplaying() const;
+
+    /**
+     * Reads a recording written by saveRecording, replacing the current one.
+     * Returns false if the file cannot be read.
+     */
+    bool loadRecording(const std::string& filename);
+
+    /**
+     * Sends the events of the current recording to the objects they happened
+     * to, in order, as if they were happening again, and returns how long
+     * their listeners took.
+     *
+     * If realTime is true, each event is sent as long after the start of the
+     * replay as it happened after the start of the recording.  Otherwise each
+     * one is sent as soon as the listener for the last one returns.  Either
+     * way, each replayed event's getTime is the time it would have happened,
+     * so programs that time their animation by their timer events behave the
+     * same at any speed.
+     *
+     * Objects are matched up by the order they were created in, so the program
+     * must build its windows and interactors in the same order as when it was
+     * recorded.  Events from the user and from timers are ignored while
+     * replaying, apart from window events such as closing the window.
+     * The events do not need the window to be on screen; run with the
+     * environment variable QT_QPA_PLATFORM=offscreen to replay without one.
+     *
+     * Must not be called from the Qt GUI thread, which the events are sent on.
+     */
+    GReplayStats replay(bool realTime = false);
+
+    /**
+     * Writes the current recording to the given file.
+     * Returns false if the file cannot be written.
+     */
+    bool saveRecording(const std::string& filename) const;
+
     /**
      * Sets a bit-flagged mask of event types to listen for
      * in the semi-deprecated global event-handling functions like waitForEvent.
@@ -82,6 +223,18 @@ public:
      */
     void setEventMask(int mask);
 
+    /**
+     * Starts saving every event sent by any window or interactor, along with
+     * the time it happened, for saveRecording and replay.
+     * Any earlier recording is discarded.
+     */
+    void startRecording();
+
+    /**
+     * Stops saving events.  The ones saved so far are kept.
+     */
+    void stopRecording();
+
     /**
      * Pauses the current thread until an event occurs that matches the given
      * bit-flagged mask.  The event is then returned.
@@ -108,6 +261,8 @@ private:
     void enqueueEvent(const GEvent& event);
     bool isEmpty() const;
     GThunk peek();
+    bool isIgnoringEvent(const GEvent& event) const;
+    void recordEvent(const GEvent& event, int sourceID);
     void runOnQtGuiThreadAsync(GThunk thunk);
     void runOnQtGuiThreadSync(GThunk thunk);
 
@@ -118,6 +273,13 @@ private:
     QReadWriteLock _functionQueueMutex;
     int _eventMask;
 
+    std::vector<GRecordedEvent> _recordedEvents;
+    QReadWriteLock _recordingMutex;
+    long _recordingStart;
+    std::atomic<bool> _isRecording;
+    std::atomic<bool> _isReplaying;
+    bool _isSendingReplayedEvent;   // Qt GUI thread only
+
     friend class GObservable;
     friend class GThread;
     friend class QtGui;
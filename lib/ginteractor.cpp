@@ -3,6 +3,8 @@
  * ---------------------
  *
  * @author Marty Stepp
+ * @version 2022/03/20
+ * - setters can be batched by GTransaction
  * @version 2021/04/09
  * - added sgl namespace
  * @version 2019/04/23
@@ -278,7 +280,7 @@ void GInteractor::removeMouseListener() {
 }
 
 void GInteractor::requestFocus() {
-    GThread::runOnQtGuiThread([this]() {
+    GThread::runOnQtGuiThreadBatchable([this]() {
         getWidget()->setFocus();
     });
 }
@@ -300,7 +302,7 @@ void GInteractor::setActionListener(GEventListenerVoid func) {
 }
 
 void GInteractor::setBackground(int rgb) {
-    GThread::runOnQtGuiThread([this, rgb]() {
+    GThread::runOnQtGuiThreadBatchable([this, rgb]() {
         QPalette palette(getWidget()->palette());
         palette.setColor(getWidget()->backgroundRole(), QColor(rgb));
 
@@ -323,7 +325,7 @@ void GInteractor::setBackground(int rgb) {
 void GInteractor::setBackground(const std::string& color) {
     if (GColor::hasAlpha(color)) {
         int argb = GColor::convertColorToARGB(color);
-        GThread::runOnQtGuiThread([this, argb]() {
+        GThread::runOnQtGuiThreadBatchable([this, argb]() {
             QColor qcolor = GColor::toQColorARGB(argb);
             QPalette palette(getWidget()->palette());
             palette.setColor(getWidget()->backgroundRole(), qcolor);
@@ -349,7 +351,7 @@ void GInteractor::setBackground(const std::string& color) {
 }
 
 void GInteractor::setBounds(double x, double y, double width, double height) {
-    GThread::runOnQtGuiThread([this, x, y, width, height]() {
+    GThread::runOnQtGuiThreadBatchable([this, x, y, width, height]() {
         getWidget()->setGeometry((int) x, (int) y, (int) width, (int) height);
         getWidget()->setFixedSize((int) width, (int) height);
     });
@@ -381,7 +383,7 @@ void GInteractor::setContainer(GContainer* container) {
         // widgets that are not in any container should not be shown on screen
         // (they will awkwardly hover at (0, 0) if they are shown)
         QWidget* widget = getWidget();
-        GThread::runOnQtGuiThread([widget]() {
+        GThread::runOnQtGuiThreadBatchable([widget]() {
             widget->setParent(nullptr);
         });
         setVisible(false);
@@ -397,13 +399,13 @@ void GInteractor::setDoubleClickListener(GEventListenerVoid func) {
 }
 
 void GInteractor::setEnabled(bool value) {
-    GThread::runOnQtGuiThread([this, value]() {
+    GThread::runOnQtGuiThreadBatchable([this, value]() {
         getWidget()->setEnabled(value);
     });
 }
 
 void GInteractor::setForeground(int rgb) {
-    GThread::runOnQtGuiThread([this, rgb]() {
+    GThread::runOnQtGuiThreadBatchable([this, rgb]() {
         QPalette palette(getWidget()->palette());
         palette.setColor(getWidget()->foregroundRole(), QColor(rgb));
         // TODO: does not totally work for some widgets, e.g. GChooser popup menu
@@ -414,7 +416,7 @@ void GInteractor::setForeground(int rgb) {
 void GInteractor::setForeground(const std::string& color) {
     if (GColor::hasAlpha(color)) {
         int argb = GColor::convertColorToARGB(color);
-        GThread::runOnQtGuiThread([this, argb]() {
+        GThread::runOnQtGuiThreadBatchable([this, argb]() {
             QPalette palette(getWidget()->palette());
             palette.setColor(getWidget()->foregroundRole(), GColor::toQColorARGB(argb));
             // TODO: does not totally work for some widgets, e.g. GChooser popup menu
@@ -427,7 +429,7 @@ void GInteractor::setForeground(const std::string& color) {
 }
 
 void GInteractor::setFont(const QFont& font) {
-    GThread::runOnQtGuiThread([this, font]() {
+    GThread::runOnQtGuiThreadBatchable([this, font]() {
         getWidget()->setFont(font);
     });
 }
@@ -438,7 +440,7 @@ void GInteractor::setFont(const std::string& font) {
 
 void GInteractor::setHeight(double height) {
     require::nonNegative(height, "GInteractor::setHeight", "height");
-    GThread::runOnQtGuiThread([this, height]() {
+    GThread::runOnQtGuiThreadBatchable([this, height]() {
         getWidget()->setFixedHeight((int) height);
     });
 }
@@ -470,7 +472,7 @@ void GInteractor::setKeyListener(GEventListenerVoid func) {
 }
 
 void GInteractor::setLocation(double x, double y) {
-    GThread::runOnQtGuiThread([this, x, y]() {
+    GThread::runOnQtGuiThreadBatchable([this, x, y]() {
         getWidget()->setGeometry(x, y, getWidth(), getHeight());
     });
 }
@@ -478,7 +480,7 @@ void GInteractor::setLocation(double x, double y) {
 void GInteractor::setMinimumSize(double width, double height) {
     require::nonNegative(width, "GInteractor::setMinimumSize", "width");
     require::nonNegative(height, "GInteractor::setMinimumSize", "height");
-    GThread::runOnQtGuiThread([this, width, height]() {
+    GThread::runOnQtGuiThreadBatchable([this, width, height]() {
         getInternalWidget()->setMinimumSize(width, height);
     });
 }
@@ -527,13 +529,13 @@ void GInteractor::setPreferredHeight(double height) {
 void GInteractor::setPreferredSize(double width, double height) {
     require::nonNegative(width, "GInteractor::setPreferredSize", "width");
     require::nonNegative(height, "GInteractor::setPreferredSize", "height");
-    GThread::runOnQtGuiThread([this, width, height]() {
+    GThread::runOnQtGuiThreadBatchable([this, width, height]() {
         getInternalWidget()->setPreferredSize(width, height);
     });
 }
 
 void GInteractor::setPreferredSize(const GDimension& size) {
-    GThread::runOnQtGuiThread([this, size]() {
+    GThread::runOnQtGuiThreadBatchable([this, size]() {
         getInternalWidget()->setPreferredSize(size.width, size.height);
     });
 }
@@ -545,7 +547,7 @@ void GInteractor::setPreferredWidth(double width) {
 void GInteractor::setSize(double width, double height) {
     require::nonNegative(width, "GInteractor::setSize", "width");
     require::nonNegative(height, "GInteractor::setSize", "height");
-    GThread::runOnQtGuiThread([this, width, height]() {
+    GThread::runOnQtGuiThreadBatchable([this, width, height]() {
         // setBounds(GRectangle(getX(), getY(), width, height));
         getWidget()->setGeometry((int) getX(), (int) getY(), (int) width, (int) height);
         getWidget()->setFixedSize((int) width, (int) height);
@@ -558,7 +560,7 @@ void GInteractor::setSize(const GDimension& size) {
 }
 
 void GInteractor::setTooltip(const std::string& tooltipText) {
-    GThread::runOnQtGuiThread([this, tooltipText]() {
+    GThread::runOnQtGuiThreadBatchable([this, tooltipText]() {
         getWidget()->setToolTip(QString::fromStdString(tooltipText));
     });
 }
@@ -566,14 +568,14 @@ void GInteractor::setTooltip(const std::string& tooltipText) {
 void GInteractor::setVisible(bool visible) {
     // don't allow setting visible to true unless widget is in a container
     if (!visible || _container) {
-        GThread::runOnQtGuiThread([this, visible]() {
+        GThread::runOnQtGuiThreadBatchable([this, visible]() {
             getWidget()->setVisible(visible);
         });
     }
 }
 
 void GInteractor::setWidth(double width) {
-    GThread::runOnQtGuiThread([this, width]() {
+    GThread::runOnQtGuiThreadBatchable([this, width]() {
         getWidget()->setFixedWidth((int) width);
     });
 }
@@ -3,6 +3,8 @@
  * ----------------
  *
  * @author Marty Stepp
+ * @version 2022/03/20
+ * - setters can be batched by GTransaction
  * @version 2021/04/09
  * - added sgl namespace
  * @version 2019/04/23
@@ -271,7 +273,7 @@ void GLabel::setText(const std::string& text) {
     if (_gtext) {
         _gtext->setText(text);
     }
-    GThread::runOnQtGuiThread([this, text]() {
+    GThread::runOnQtGuiThreadBatchable([this, text]() {
         _iqlabel->setText(QString::fromStdString(text));
         GLayout::forceUpdate(_iqlabel);
     });
@@ -302,7 +304,7 @@ void GLabel::setWidth(double width) {
 }
 
 void GLabel::setWordWrap(bool wrap) {
-    GThread::runOnQtGuiThread([this, wrap]() {
+    GThread::runOnQtGuiThreadBatchable([this, wrap]() {
         _iqlabel->setWordWrap(wrap);
     });
 }
@@ -3,6 +3,8 @@
  * -----------------
  *
  * @author Marty Stepp
+ * @version 2022/03/20
+ * - added beginDeferredUpdates/endDeferredUpdates for GTransaction
  * @version 2021/04/09
  * - added sgl namespace
  * @version 2018/08/23
@@ -12,6 +14,8 @@
  */
 
 #include "glayout.h"
+#include <vector>
+#include <QPointer>
 #include "require.h"
 #include "privatestrlib.h"
 
@@ -50,6 +54,38 @@ bool GLayout::contains(QLayout* layout, QWidget* widget) {
     return false;
 }
 
+// widgets whose updates are waiting for endDeferredUpdates (Qt GUI thread only)
+static int deferredDepth = 0;
+static std::vector<QPointer<QWidget>> deferredWidgets;
+
+void GLayout::beginDeferredUpdates() {
+    deferredDepth++;
+}
+
+void GLayout::endDeferredUpdates() {
+    if (deferredDepth == 0 || --deferredDepth > 0) {
+        return;
+    }
+    std::vector<QPointer<QWidget>> widgets;
+    widgets.swap(deferredWidgets);
+    for (const QPointer<QWidget>& widget : widgets) {
+        if (!widget) {
+            continue;   // deleted since
+        }
+        // updating a widget updates everything inside it too
+        bool inside = false;
+        for (const QPointer<QWidget>& other : widgets) {
+            if (other && other != widget && other->isAncestorOf(widget)) {
+                inside = true;
+                break;
+            }
+        }
+        if (!inside) {
+            forceUpdate(widget);
+        }
+    }
+}
+
 void GLayout::forceUpdate(GInteractor* interactor) {
     if (interactor) {
         forceUpdate(interactor->getWidget());
@@ -64,6 +100,15 @@ void GLayout::forceUpdate(QWidget* widget) {
     if (!widget) {
         return;
     }
+    if (deferredDepth > 0) {
+        for (const QPointer<QWidget>& deferred : deferredWidgets) {
+            if (deferred == widget) {
+                return;
+            }
+        }
+        deferredWidgets.push_back(widget);
+        return;
+    }
 
     // Update all child widgets.
     for (int i = 0; i < widget->children().size(); i++) {
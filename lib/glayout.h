@@ -3,6 +3,8 @@
  * ---------------
  *
  * @author Marty Stepp
+ * @version 2022/03/20
+ * - added beginDeferredUpdates/endDeferredUpdates for GTransaction
  * @version 2021/04/09
  * - added sgl namespace
  * @version 2018/09/07
@@ -35,10 +37,18 @@ public:
 
     enum Position { West, North, South, East, Center };
 
+    /**
+     * Makes forceUpdate only note which widgets need updating until the
+     * matching endDeferredUpdates, which updates each of them once.
+     * Used on the Qt GUI thread while a GTransaction is applied.
+     */
+    static void beginDeferredUpdates();
+
     static void clearLayout(QLayout* layout);
     static bool contains(QLayout* layout, QWidget* widget);
     static void forceUpdate(GInteractor* interactor);
     static void forceUpdate(QWidget* widget);
+    static void endDeferredUpdates();
     static QSize getPreferredSize(QWidget* widget);
     static QSize getProperSize(QLayout* layout);
     static QSize getProperSize(QWidget* widget);
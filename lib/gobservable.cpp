@@ -3,6 +3,8 @@
  * ---------------------
  *
  * @author Marty Stepp
+ * @version 2022/03/20
+ * - observables are numbered and fireEvent records/ignores events for GEventQueue replays
  * @version 2021/04/09
  * - added sgl namespace
  * @version 2021/04/03
@@ -23,13 +25,24 @@
 
 namespace sgl {
 
+int GObservable::_observableCount = 0;
+std::map<int, GObservable*> GObservable::_observables;
+std::mutex GObservable::_observablesMutex;
+
+// how many listeners are running on this thread, so events fired from inside
+// them are not recorded
+static thread_local int listenerDepth = 0;
+
 GObservable::GObservable()
         : _eventsEnabled(true) {
-    // empty
+    std::lock_guard<std::mutex> lock(_observablesMutex);
+    _observableID = ++_observableCount;
+    _observables[_observableID] = this;
 }
 
 GObservable::~GObservable() {
-    // empty
+    std::lock_guard<std::mutex> lock(_observablesMutex);
+    _observables.erase(_observableID);
 }
 
 void GObservable::clearEventListeners() {
@@ -44,14 +57,35 @@ bool GObservable::eventsEnabled() const {
     return _eventsEnabled;
 }
 
+/*static*/ GObservable* GObservable::findObservable(int id) {
+    std::lock_guard<std::mutex> lock(_observablesMutex);
+    auto it = _observables.find(id);
+    return it == _observables.end() ? nullptr : it->second;
+}
+
 void GObservable::fireEvent(GEvent& event) {
     if (eventsEnabled()) {
+        GEventQueue* queue = GEventQueue::instance();
+        if (queue->isIgnoringEvent(event)) {
+            return;   // a recording is being replayed in its place
+        }
         event.setSource(this);
+        if (listenerDepth == 0 && queue->isRecording()) {
+            // events fired by a listener will be fired again by it when replayed
+            queue->recordEvent(event, _observableID);
+        }
         if (hasEventListener(event.getName())) {
-            _eventMap[event.getName()].fireEvent(event);
+            listenerDepth++;
+            try {
+                _eventMap[event.getName()].fireEvent(event);
+            } catch (...) {
+                listenerDepth--;
+                throw;
+            }
+            listenerDepth--;
         } else {
             // put into global queue for waitForEvent calls
-            GEventQueue::instance()->enqueueEvent(event);
+            queue->enqueueEvent(event);
         }
     }
 }
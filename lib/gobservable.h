@@ -3,6 +3,8 @@
  * --------------------
  *
  * @author Marty Stepp
+ * @version 2022/03/20
+ * - observables are numbered and fireEvent records/ignores events for GEventQueue replays
  * @version 2021/04/09
  * - added sgl namespace
  * @version 2021/04/03
@@ -21,6 +23,7 @@
 
 #include <functional>
 #include <map>
+#include <mutex>
 #include <string>
 #include <QtEvents>
 
@@ -205,10 +208,22 @@ protected:
     virtual void setEventListeners(std::initializer_list<std::string> eventNames, GEventListenerVoid func);
 
 private:
+    /*
+     * Returns the observable object with the given ID, or nullptr if it has
+     * been deleted.
+     */
+    static GObservable* findObservable(int id);
+
     std::map<std::string, GEvent::EventListenerWrapper> _eventMap;
     bool _eventsEnabled;
+    int _observableID;   // 1 for the first observable created, 2 for the next, ...
+
+    static int _observableCount;
+    static std::map<int, GObservable*> _observables;   // by ID, for GEventQueue::replay
+    static std::mutex _observablesMutex;
 
     // allow all interactors and their inner QWidgets to call observable methods
+    friend class GEventQueue;
     friend class GInteractor;
     friend class _Internal_QWidget;
 };
@@ -3,6 +3,8 @@
  * ------------------
  *
  * @author Marty Stepp
+ * @version 2022/03/20
+ * - setters can be batched by GTransaction
  * @version 2021/04/09
  * - added sgl namespace
  * @version 2019/04/23
@@ -124,7 +126,7 @@ QWidget* GSlider::getWidget() const {
 }
 
 void GSlider::setMajorTickSpacing(int value) {
-    GThread::runOnQtGuiThread([this, value]() {
+    GThread::runOnQtGuiThreadBatchable([this, value]() {
         _iqslider->setTickInterval(value);
     });
 }
@@ -134,7 +136,7 @@ void GSlider::setMax(int max) {
     if (min > max) {
         throw std::runtime_error("GSlider::setMax: max (" + std::to_string(max) + ") cannot be less than min (" + std::to_string(min) + ")");
     }
-    GThread::runOnQtGuiThread([this, max]() {
+    GThread::runOnQtGuiThreadBatchable([this, max]() {
         _iqslider->setMaximum(max);
     });
 }
@@ -144,13 +146,13 @@ void GSlider::setMin(int min) {
     if (min > max) {
         throw std::runtime_error("GSlider::setMin: min (" + std::to_string(min) + ") cannot be greater than max (" + std::to_string(max) + ")");
     }
-    GThread::runOnQtGuiThread([this, min]() {
+    GThread::runOnQtGuiThreadBatchable([this, min]() {
         _iqslider->setMinimum(min);
     });
 }
 
 void GSlider::setMinorTickSpacing(int value) {
-    GThread::runOnQtGuiThread([this, value]() {
+    GThread::runOnQtGuiThreadBatchable([this, value]() {
         _iqslider->setTickInterval(value);
     });
 }
@@ -160,7 +162,7 @@ void GSlider::setPaintLabels(bool /* value */) {
 }
 
 void GSlider::setPaintTicks(bool value) {
-    GThread::runOnQtGuiThread([this, value]() {
+    GThread::runOnQtGuiThreadBatchable([this, value]() {
         _iqslider->setTickPosition(value ? QSlider::TicksBothSides : QSlider::NoTicks);
     });
 }
@@ -169,7 +171,7 @@ void GSlider::setRange(int min, int max) {
     if (min > max) {
         throw std::runtime_error("GSlider::setRange: min (" + std::to_string(min) + ") cannot be greater than max (" + std::to_string(max) + ")");
     }
-    GThread::runOnQtGuiThread([this, min, max]() {
+    GThread::runOnQtGuiThreadBatchable([this, min, max]() {
         _iqslider->setRange(min, max);
     });
 }
@@ -185,7 +187,7 @@ void GSlider::setState(int min, int max, int value) {
     if (value < min || value > max) {
         throw std::runtime_error("GSlider::setState: value out of range: " + std::to_string(value));
     }
-    GThread::runOnQtGuiThread([this, min, max, value]() {
+    GThread::runOnQtGuiThreadBatchable([this, min, max, value]() {
         _iqslider->setRange(min, max);
         _iqslider->setValue(value);
     });
@@ -195,7 +197,7 @@ void GSlider::setValue(int value) {
     if (value < getMin() || value > getMax()) {
         throw std::runtime_error("GSlider::setValue: value out of range: " + std::to_string(value));
     }
-    GThread::runOnQtGuiThread([this, value]() {
+    GThread::runOnQtGuiThreadBatchable([this, value]() {
         _iqslider->setValue(value);
     });
 }
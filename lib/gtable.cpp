@@ -5,6 +5,9 @@
  * See that file for documentation of each member.
  *
  * @author Marty Stepp
+ * @version 2022/03/20
+ * - per-cell bounds checks follow require::Policy
+ * - set and setCell* can be batched by GTransaction
  * @version 2021/04/09
  * - added sgl namespace
  * @version 2021/04/03
@@ -41,6 +44,7 @@
 #include "gfont.h"
 #include "gthread.h"
 #include "privatestrlib.h"
+#include "require.h"
 
 namespace sgl {
 
@@ -80,18 +84,27 @@ void GTable::autofitColumnWidths() {
 }
 
 void GTable::checkColumn(const std::string& member, int column) const {
+    if (!require::shouldCheck()) {
+        return;
+    }
     if (column < 0 || column > numCols()) {
         throw std::runtime_error("GTable::" + member + ": column value out of range");
     }
 }
 
 void GTable::checkIndex(const std::string& member, int row, int column) const {
+    if (!require::shouldCheck()) {
+        return;
+    }
     if (row < 0 || column < 0 || row > numRows() || column > numCols()) {
         throw std::runtime_error("GTable::" + member + ": row or column value out of range");
     }
 }
 
 void GTable::checkRow(const std::string& member, int row) const {
+    if (!require::shouldCheck()) {
+        return;
+    }
     if (row < 0 || row > numRows()) {
         throw std::runtime_error("GTable::" + member + ": row value out of range");
     }
@@ -359,7 +372,7 @@ void GTable::select(int row, int column) {
 
 void GTable::set(int row, int column, const std::string& text) {
     checkIndex("set", row, column);
-    GThread::runOnQtGuiThread([this, row, column, text]() {
+    GThread::runOnQtGuiThreadBatchable([this, row, column, text]() {
         QModelIndex index = _iqtableview->model()->index(row, column);
         _iqtableview->model()->setData(index, QVariant(text.c_str()));
     });
@@ -399,7 +412,7 @@ void GTable::setBackground(const std::string& color) {
 
 void GTable::setCellAlignment(int row, int column, HorizontalAlignment alignment) {
     checkIndex("setCellAlignment", row, column);
-    GThread::runOnQtGuiThread([this, row, column, alignment]() {
+    GThread::runOnQtGuiThreadBatchable([this, row, column, alignment]() {
         setCellAlignmentInternal(row, column, alignment);   // do the actual work
     });
 }
@@ -412,7 +425,7 @@ void GTable::setCellAlignmentInternal(int row, int column, HorizontalAlignment a
 
 void GTable::setCellBackground(int row, int column, int rgb) {
     checkIndex("setCellBackground", row, column);
-    GThread::runOnQtGuiThread([this, row, column, rgb]() {
+    GThread::runOnQtGuiThreadBatchable([this, row, column, rgb]() {
         setCellBackgroundInternal(row, column, rgb);   // do the actual work
     });
 }
@@ -427,7 +440,7 @@ void GTable::setCellBackgroundInternal(int row, int column, int rgb) {
 
 void GTable::setCellFont(int row, int column, const std::string& font) {
     checkIndex("setCellFont", row, column);
-    GThread::runOnQtGuiThread([this, row, column, font]() {
+    GThread::runOnQtGuiThreadBatchable([this, row, column, font]() {
         setCellFontInternal(row, column, font);   // do the actual work
     });
 }
@@ -438,7 +451,7 @@ void GTable::setCellFontInternal(int row, int column, const std::string& font) {
 
 void GTable::setCellForeground(int row, int column, int rgb) {
     checkIndex("setCellForeground", row, column);
-    GThread::runOnQtGuiThread([this, row, column, rgb]() {
+    GThread::runOnQtGuiThreadBatchable([this, row, column, rgb]() {
         setCellForegroundInternal(row, column, rgb);   // do the actual work
     });
 }
@@ -4,6 +4,8 @@
  *
  * This file implements the members declared in gthread.h.
  *
+ * @version 2022/03/20
+ * - added runOnQtGuiThreadBatchable and transactions
  * @version 2021/04/09
  * - added sgl namespace
  * - fixed warnings about noreturn functions on older Windows systems
@@ -32,12 +34,14 @@
 #include "consoletext.h"
 #include "gevent.h"
 #include "geventqueue.h"
+#include "glayout.h"
 #include "qtgui.h"
 #include "require.h"
 #include <chrono>
 #include <exception>
 #include <pthread.h>
 #include <stdexcept>
+#include <vector>
 
 namespace sgl {
 
@@ -114,6 +118,10 @@ void QFunctionThread::run() {
 }
 
 
+// changes saved by the GTransaction open on each thread, if any
+static thread_local int transactionDepth = 0;
+static thread_local std::vector<GThunk> transactionChanges;
+
 /*static*/ GThread* GThread::_qtGuiThread = nullptr;
 /*static*/ GThread* GThread::_studentThread = nullptr;
 std::map<QThread*, GThread*> GThread::_allGThreadsQt;
@@ -176,6 +184,7 @@ GThread::GThread() {
 }
 
 /*static*/ void GThread::runOnQtGuiThread(GThunk func) {
+    func = withSavedChanges(func);
     if (iAmRunningOnTheQtGuiThread()) {
         // already on Qt GUI thread; just run the function!
         func();
@@ -189,6 +198,7 @@ GThread::GThread() {
 }
 
 /*static*/ void GThread::runOnQtGuiThreadAsync(GThunk func) {
+    func = withSavedChanges(func);
     if (iAmRunningOnTheQtGuiThread()) {
         // already on Qt GUI thread; just run the function!
         func();
@@ -208,6 +218,51 @@ GThread::GThread() {
     }
 }
 
+/*static*/ void GThread::runOnQtGuiThreadBatchable(GThunk func) {
+    if (isInTransaction()) {
+        transactionChanges.push_back(func);
+    } else {
+        runOnQtGuiThread(func);
+    }
+}
+
+/*static*/ void GThread::beginTransaction() {
+    transactionDepth++;
+}
+
+/*static*/ void GThread::commitTransaction() {
+    if (transactionDepth > 0 && --transactionDepth == 0 && !transactionChanges.empty()) {
+        // the saved changes go ahead of this (empty) call in one trip
+        runOnQtGuiThread([]() {});
+    }
+}
+
+/*static*/ bool GThread::isInTransaction() {
+    return transactionDepth > 0;
+}
+
+/*static*/ GThunk GThread::withSavedChanges(GThunk func) {
+    if (transactionChanges.empty()) {
+        return func;
+    }
+    std::vector<GThunk> changes;
+    changes.swap(transactionChanges);
+    return [changes, func]() {
+        // containers redo their layout once, after all of the changes
+        GLayout::beginDeferredUpdates();
+        try {
+            for (const GThunk& change : changes) {
+                change();
+            }
+        } catch (...) {
+            GLayout::endDeferredUpdates();
+            throw;
+        }
+        GLayout::endDeferredUpdates();
+        func();
+    };
+}
+
 /*static*/ void GThread::startStudentThread(GThunkInt mainFunc) {
     if (!_studentThread) {
         _studentThread = new GThreadStd(mainFunc, "Student main()");
@@ -9,6 +9,8 @@
  * You can also run code in a new thread using the static method
  * GThread::runInNewThread or GThread::runInNewThreadAsync.
  *
+ * @version 2022/03/20
+ * - added runOnQtGuiThreadBatchable, which GTransaction collects
  * @version 2021/04/09
  * - added sgl namespace
  * @version 2021/04/03
@@ -292,6 +294,18 @@ public:
      */
     static void runOnQtGuiThreadAsync(GThunk func);
 
+    /**
+     * Runs the given void function on the Qt GUI thread like
+     * <code>runOnQtGuiThread</code>, unless the current thread has a
+     * GTransaction open, in which case the function is saved and run along
+     * with the rest of the transaction when it is committed.
+     * This is for changes whose caller does not wait on their results, such
+     * as interactor setters; any other call to the Qt GUI thread from this
+     * thread first runs the changes saved so far, so they keep their order.
+     * @private
+     */
+    static void runOnQtGuiThreadBatchable(GThunk func);
+
     /**
      * Starts the student's thread, telling it to run the given function,
      * which accepts no arguments and returns an int.
@@ -340,6 +354,15 @@ protected:
     static std::map<std::thread*, GThread*> _allGThreadsStd;
 
 private:
+    // GTransaction support; see gtransaction.h
+    static void beginTransaction();
+    static void commitTransaction();
+    static bool isInTransaction();
+
+    // returns func preceded by any changes this thread's transaction has saved
+    static GThunk withSavedChanges(GThunk func);
+
+    friend class GTransaction;
     friend class QtGui;
 };
 
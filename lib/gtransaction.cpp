@@ -0,0 +1,60 @@
+/*
+ * File: gtransaction.cpp
+ * ----------------------
+ * This file implements the gtransaction.h interface.
+ *
+ * @version 2022/03/21
+ * - destructor reports a failed commit instead of letting it escape
+ * @version 2022/03/20
+ * - initial version
+ */
+
+#include "gtransaction.h"
+#include <exception>
+#include <iostream>
+#include "glayout.h"
+#include "gthread.h"
+
+namespace sgl {
+
+GTransaction::GTransaction()
+        : _open(true) {
+    GThread::beginTransaction();
+}
+
+GTransaction::~GTransaction() {
+    // an exception leaving a destructor would terminate the program
+    try {
+        commit();
+    } catch (const std::exception& ex) {
+        std::cerr << "Warning: a GTransaction could not be committed: " << ex.what() << std::endl;
+    } catch (...) {
+        std::cerr << "Warning: a GTransaction could not be committed." << std::endl;
+    }
+}
+
+/*static*/ void GTransaction::build(GThunk func) {
+    GThread::runOnQtGuiThread([func]() {
+        GLayout::beginDeferredUpdates();
+        try {
+            func();
+        } catch (...) {
+            GLayout::endDeferredUpdates();
+            throw;
+        }
+        GLayout::endDeferredUpdates();
+    });
+}
+
+void GTransaction::commit() {
+    if (_open) {
+        _open = false;
+        GThread::commitTransaction();
+    }
+}
+
+/*static*/ bool GTransaction::isOpen() {
+    return GThread::isInTransaction();
+}
+
+} // namespace sgl
@@ -0,0 +1,95 @@
+/*
+ * File: gtransaction.h
+ * --------------------
+ * This file defines the <code>GTransaction</code> class, which batches
+ * changes to interactors into a single trip to the Qt GUI thread.
+ *
+ * @version 2022/03/21
+ * - destructor reports a failed commit instead of letting it escape
+ * @version 2022/03/20
+ * - initial version
+ */
+
+
+#ifndef _gtransaction_h
+#define _gtransaction_h
+
+#include "gtypes.h"
+
+namespace sgl {
+
+/**
+ * Normally every change to an interactor waits for the Qt GUI thread to
+ * make it, one at a time.  While a GTransaction is open, changes made by
+ * the thread that opened it are saved instead: adding interactors to and
+ * removing them from containers, and setting their text, values, colors,
+ * fonts, sizes, visibility and so on.  When the transaction is committed
+ * they are all made in one trip to the Qt GUI thread, and each container
+ * affected redoes its layout once, at the end.
+ *
+ * <pre>
+ *     GTransaction transaction;
+ *     for (int i = 0; i < stats.size(); i++) {
+ *         labels[i]->setText(stats[i]);
+ *     }
+ *     transaction.commit();   // or let it go out of scope
+ * </pre>
+ *
+ * Changes are still made in the order they were asked for.  Anything else
+ * that needs the Qt GUI thread while a transaction is open first makes the
+ * changes saved so far.  Getters that read an interactor directly, however,
+ * see it as it was before the transaction until it is committed; so do the
+ * argument checks of setters that look at other properties, such as
+ * GSlider::setValue checking the slider's range.
+ *
+ * Interactors need their Qt widgets as soon as they are constructed, so
+ * creating one still takes a trip of its own.  To create many at once, do
+ * it inside <code>build</code>, which makes the whole trip at once.
+ *
+ * Transactions can be nested; only the outermost commit makes the changes.
+ */
+class GTransaction {
+public:
+    /**
+     * Opens a transaction on the current thread.
+     */
+    GTransaction();
+
+    /**
+     * Commits the transaction if it has not been committed already.
+     * If making the changes throws an exception, it is written to
+     * <code>cerr</code> rather than thrown, since a destructor must not
+     * throw; call <code>commit</code> to be able to catch it.
+     */
+    virtual ~GTransaction();
+
+    /**
+     * Runs the given function on the Qt GUI thread, after any changes saved
+     * so far, and waits for it to finish.  Interactors it creates, adds and
+     * changes are handled there without a trip to the Qt GUI thread each,
+     * and containers redo their layout once after it returns.
+     */
+    static void build(GThunk func);
+
+    /**
+     * Makes all of the changes saved since the transaction was opened, in
+     * one trip to the Qt GUI thread, and closes it.
+     * Does nothing if it has already been committed.
+     */
+    void commit();
+
+    /**
+     * Returns true if the current thread has a transaction open.
+     */
+    static bool isOpen();
+
+private:
+    GTransaction(const GTransaction&) = delete;
+    GTransaction& operator =(const GTransaction&) = delete;
+
+    bool _open;
+};
+
+} // namespace sgl
+
+#endif // _gtransaction_h
@@ -6,6 +6,9 @@
  * See diff.h for documentation of each function.
  * 
  * @author Marty Stepp
+ * @version 2022/03/20
+ * - split diff into diffHunks and describeHunk, which GDiffGui uses directly
+ * - line index lookups use binary search instead of walking each set
  * @version 2021/04/03
  * - removed dependency on custom collections
  * @version 2016/10/30
@@ -19,8 +22,7 @@
 
 #include "privatediff.h"
 #include <algorithm>
-#include <map>
-#include <set>
+#include <unordered_map>
 #include <vector>
 #include "privateregexpr.h"
 #include "privatestrlib.h"
@@ -39,11 +41,49 @@ static std::string stripWhitespace(const std::string& s) {
     return result.str();
 }
 
+// adds lines [from1, to1) of the first string and [from2, to2) of the second
+// to the hunk they follow on from, or starts a new hunk with them
+static void addToHunks(std::vector<DiffHunk>& hunks, int from1, int to1, int from2, int to2) {
+    if (!hunks.empty() && hunks.back().end1 == from1 && hunks.back().end2 == from2) {
+        hunks.back().end1 = to1;
+        hunks.back().end2 = to2;
+    } else {
+        hunks.push_back(DiffHunk {from1, to1, from2, to2});
+    }
+}
+
 std::string diff(std::string s1, std::string s2, int flags) {
+    std::vector<DiffHunk> hunks = diffHunks(s1, s2, flags);
+    std::vector<std::string> lines1Original = sgl::priv::strlib::split(s1, "\n");
+    std::vector<std::string> lines2Original = sgl::priv::strlib::split(s2, "\n");
+    std::vector<std::string> out;
+
+    for (const DiffHunk& hunk : hunks) {
+        std::string description = describeHunk(hunk, flags);
+        if (description.empty()) {
+            continue;
+        }
+        out.push_back("\n" + description);
+        for (int x = hunk.start1; x < hunk.end1; x++) {
+            out.push_back("EXPECTED < " + lines1Original[x]);
+        }   // deleted elems
+        for (int y = hunk.start2; y < hunk.end2; y++) {
+            out.push_back("STUDENT  > " + lines2Original[y]);
+        }   // added elems
+    }
+
+    if (out.size() > 0) {
+        out.push_back("");
+        return sgl::priv::strlib::trim(sgl::priv::strlib::join(out, "\n"));
+    } else {
+        return NO_DIFFS_MESSAGE;
+    }
+}
+
+std::vector<DiffHunk> diffHunks(std::string s1, std::string s2, int flags) {
+    std::vector<DiffHunk> hunks;
     std::vector<std::string> lines1 = sgl::priv::strlib::split(s1, "\n");
     std::vector<std::string> lines2 = sgl::priv::strlib::split(s2, "\n");
-    std::vector<std::string> lines1Original = lines1;
-    std::vector<std::string> lines2Original = lines2;
 
     if (flags & IGNORE_NUMBERS) {
         s1 = sgl::priv::regexpr::replace(s1, "[0-9]+", "###");
@@ -109,24 +149,24 @@ std::string diff(std::string s1, std::string s2, int flags) {
     }
 
     if (sgl::priv::strlib::trimEnd(s1) == sgl::priv::strlib::trimEnd(s2)) {
-        return NO_DIFFS_MESSAGE;
+        return hunks;
     }
 
-    // build a reverse-index array using the line as key and line number as value
-    // don't store blank lines, so they won't be targets of the shortest distance
-    // search
-    std::map<std::string, std::set<int>> reverse1;
-    std::map<std::string, std::set<int>> reverse2;
+    // build a reverse-index array using the line as key and line numbers as value
+    // (in increasing order); don't store blank lines, so they won't be targets
+    // of the shortest distance search
+    std::unordered_map<std::string, std::vector<int>> reverse1;
+    std::unordered_map<std::string, std::vector<int>> reverse2;
+    reverse1.reserve(lines1.size());
+    reverse2.reserve(lines2.size());
     for (int i = 0; i < lines1.size(); i++) {
-        std::string line = lines1[i];
-        if ((int) line.length() > 0) {
-            reverse1[line].insert(i);
+        if (!lines1[i].empty()) {
+            reverse1[lines1[i]].push_back(i);
         }
     }
     for (int i = 0; i < lines2.size(); i++) {
-        std::string line = lines2[i];
-        if ((int) line.length() > 0) {
-            reverse2[line].insert(i);
+        if (!lines2[i].empty()) {
+            reverse2[lines2[i]].push_back(i);
         }
     }
 
@@ -134,13 +174,11 @@ std::string diff(std::string s1, std::string s2, int flags) {
     // (start at beginning of each list)
     int index1 = 0;
     int index2 = 0;
-    std::vector<int> actions;
 
     // walk this loop until we reach the end of one of the lists of lines
     while (index1 < lines1.size() && index2 < lines2.size()) {
-        // if we have a common line, save it and go to the next
+        // if we have a common line, go to the next
         if (lines1[index1] == lines2[index2]) {
-            actions.push_back(4);
             index1++;
             index2++;
             continue;
@@ -153,11 +191,12 @@ std::string diff(std::string s1, std::string s2, int flags) {
         int s2 = index2;
         while ((s1 + s2 - index1 - index2) < (best1 + best2 - index1 - index2)) {
             int d = -1;
-            if (lines2.size() > s2 && reverse1.find(lines2[s2]) != reverse1.end()) {
-                for (int lineNumber : reverse1[lines2[s2]]) {
-                    if (lineNumber >= s1) {
-                        d = lineNumber;
-                        break;
+            if (lines2.size() > s2) {
+                auto found = reverse1.find(lines2[s2]);
+                if (found != reverse1.end()) {
+                    auto next = std::lower_bound(found->second.begin(), found->second.end(), s1);
+                    if (next != found->second.end()) {
+                        d = *next;
                     }
                 }
             }
@@ -167,11 +206,12 @@ std::string diff(std::string s1, std::string s2, int flags) {
             }
 
             d = -1;
-            if (lines1.size() > s1 && reverse2.find(lines1[s1]) != reverse2.end()) {
-                for (int lineNumber : reverse2[lines1[s1]]) {
-                    if (lineNumber >= s2) {
-                        d = lineNumber;
-                        break;
+            if (lines1.size() > s1) {
+                auto found = reverse2.find(lines1[s1]);
+                if (found != reverse2.end()) {
+                    auto next = std::lower_bound(found->second.begin(), found->second.end(), s2);
+                    if (next != found->second.end()) {
+                        d = *next;
                     }
                 }
             }
@@ -184,100 +224,48 @@ std::string diff(std::string s1, std::string s2, int flags) {
             s2++;
         }
 
-        while (index1 < best1) {
-            actions.push_back(1);
-            index1++;
-        }  // deleted elements
-
-        while (index2 < best2) {
-            actions.push_back(2);
-            index2++;
-        }  // added elements
+        // deleted and added elements
+        addToHunks(hunks, index1, best1, index2, best2);
+        index1 = best1;
+        index2 = best2;
     }
 
     // we've reached the end of one list, now walk to the end of the other
-    while (index1 < lines1.size()) {
-        actions.push_back(1);
-        index1++;
+    if (index1 < lines1.size()) {
+        addToHunks(hunks, index1, lines1.size(), index2, index2);
+        index1 = lines1.size();
     }  // deleted elements
 
-    if (flags & IGNORE_TRAILING) {
-        while (index2 < lines2.size()) {
-            actions.push_back(2);
-            index2++;
-        }  // added elements
-    }
-
-    // and this marks our ending point
-    actions.push_back(8);
-
-    int op = 0;
-    int x0 = 0;
-    int x1 = 0;
-    int y0 = 0;
-    int y1 = 0;
-    std::vector<std::string> out;
-
-    for (int action : actions) {
-        if (action == 1) {
-            op |= action;
-            x1++;
-            continue;
-        } else if (action == 2) {
-            op |= action;
-            y1++;
-            continue;
-        }
-
-        if (op > 0) {
-            bool multipleLines = (x1 != x0 + 1);
-            std::string xstr = std::string("") + (multipleLines ? (std::to_string(x0 + 1) + "-" + std::to_string(x1)) : std::to_string(x1));
-            std::string ystr = std::string("") + ((y1 != y0 + 1) ? (std::to_string(y0 + 1) + "-" + std::to_string(y1)) : std::to_string(y1));
-            std::string linesStr = std::string("\nLine") + (multipleLines ? "s " : " ");
-            std::string doStr = std::string("do") + (multipleLines ? "" : "es");
-            if (op == 1) {
-                out.push_back(linesStr + xstr + " deleted near student line " + std::to_string(y1));
-            } else if (op == 3) {
-                if (xstr == ystr) {
-                    out.push_back(linesStr + xstr + " " + doStr + " not match");
-                } else {
-                    out.push_back(linesStr + xstr + " changed to student line " + ystr);
-                }
-            }
-
-            while (x0 < x1) {
-                out.push_back("EXPECTED < " + lines1Original[x0]);
-                x0++;
-            }   // deleted elems
+    if ((flags & IGNORE_TRAILING) && index2 < lines2.size()) {
+        addToHunks(hunks, index1, index1, index2, lines2.size());
+    }  // added elements
 
-            if (op == 2) {
-                if (!(flags & IGNORE_LEADING) || x1 > 0) {
-                    out.push_back(linesStr + std::to_string(x1) + " added at student line " + ystr);
-                }
-            } else if (op == 3) {
-                // out.push_back("---");
-            }
+    return hunks;
+}
 
-            while (y0 < y1) {
-                if (!(flags & IGNORE_LEADING) || op != 2 || x1 > 0) {
-                    out.push_back("STUDENT  > " + lines2Original[y0]);
-                }
-                y0++;
-            }   // added elems
+std::string describeHunk(const DiffHunk& hunk, int flags) {
+    int op = (hunk.end1 > hunk.start1 ? 1 : 0) | (hunk.end2 > hunk.start2 ? 2 : 0);
+    int x0 = hunk.start1;
+    int x1 = hunk.end1;
+    int y0 = hunk.start2;
+    int y1 = hunk.end2;
+    bool multipleLines = (x1 != x0 + 1);
+    std::string xstr = std::string("") + (multipleLines ? (std::to_string(x0 + 1) + "-" + std::to_string(x1)) : std::to_string(x1));
+    std::string ystr = std::string("") + ((y1 != y0 + 1) ? (std::to_string(y0 + 1) + "-" + std::to_string(y1)) : std::to_string(y1));
+    std::string linesStr = std::string("Line") + (multipleLines ? "s " : " ");
+    std::string doStr = std::string("do") + (multipleLines ? "" : "es");
+    if (op == 1) {
+        return linesStr + xstr + " deleted near student line " + std::to_string(y1);
+    } else if (op == 3) {
+        if (xstr == ystr) {
+            return linesStr + xstr + " " + doStr + " not match";
+        } else {
+            return linesStr + xstr + " changed to student line " + ystr;
         }
-        x1++;
-        x0 = x1;
-        y1++;
-        y0 = y1;
-        op = 0;
-    }
-
-    if (out.size() > 0) {
-        out.push_back("");
-        return sgl::priv::strlib::trim(sgl::priv::strlib::join(out, "\n"));
-    } else {
-        return NO_DIFFS_MESSAGE;
+    } else if (op == 2 && (!(flags & IGNORE_LEADING) || x1 > 0)) {
+        return linesStr + std::to_string(x1) + " added at student line " + ystr;
     }
+    return "";
 }
 
 bool diffPass(const std::string& s1, const std::string& s2, int flags) {
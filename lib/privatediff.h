@@ -7,6 +7,8 @@
  * - moved to private SGL namespace
  *
  * @author Marty Stepp
+ * @version 2022/03/20
+ * - added diffHunks and describeHunk for viewers that lay out diffs themselves
  * @version 2021/04/09
  * - moved to private SGL namespace
  * @version 2016/10/30
@@ -25,6 +27,7 @@
 #define _private_diff_h
 
 #include <string>
+#include <vector>
 
 namespace sgl {
 namespace priv {
@@ -51,7 +54,31 @@ enum DiffFlags {
 const int DIFF_STRICT_FLAGS = IGNORE_TRAILING;
 const int DIFF_DEFAULT_FLAGS = IGNORE_CASE | IGNORE_TRAILING | IGNORE_WHITESPACE | IGNORE_PUNCTUATION;
 
+/*
+ * A run of lines that differ between two strings: lines [start1, end1) of
+ * the first were deleted or changed into lines [start2, end2) of the second.
+ * Lines are numbered from 0, as split(s, "\n") numbers them.
+ */
+struct DiffHunk {
+    int start1;
+    int end1;
+    int start2;
+    int end2;
+};
+
 std::string diff(std::string s1, std::string s2, int flags = DIFF_DEFAULT_FLAGS);
+
+/*
+ * Returns the hunks that diff() reports, in order, without formatting them.
+ */
+std::vector<DiffHunk> diffHunks(std::string s1, std::string s2, int flags = DIFF_DEFAULT_FLAGS);
+
+/*
+ * Returns the line diff() puts above the given hunk, such as
+ * "Line 3 changed to student line 4", or "" if diff() leaves the hunk out.
+ */
+std::string describeHunk(const DiffHunk& hunk, int flags = DIFF_DEFAULT_FLAGS);
+
 bool diffPass(const std::string& s1, const std::string& s2, int flags = DIFF_DEFAULT_FLAGS);
 bool isDiffMatch(const std::string& diffs);
 
@@ -4,6 +4,8 @@
  * This file implements the privatestrlib.h interface.
  * This functionality is considered "private" and not to be used by students.
  *
+ * @version 2022/03/20
+ * - split runs in linear time on long strings
  * @version 2021/04/09
  * - moved to private SGL namespace
  * - renamed some functions to remove 'string' prefix
@@ -325,21 +327,22 @@ std::vector<std::string> split(const std::string& str, char delimiter, int limit
 }
 
 std::vector<std::string> split(const std::string& str, const std::string& delimiter, int limit) {
-    std::string str2 = str;
+    // walk through str rather than erasing from the front of a copy,
+    // which took quadratic time on long strings
     std::vector<std::string> result;
     int count = 0;
-    size_t index = 0;
+    size_t start = 0;
     while (limit < 0 || count < limit) {
-        index = str2.find(delimiter);
+        size_t index = str.find(delimiter, start);
         if (index == std::string::npos) {
             break;
         }
-        result.push_back(str2.substr(0, index));
-        str2.erase(str2.begin(), str2.begin() + index + delimiter.length());
+        result.push_back(str.substr(start, index - start));
+        start = index + delimiter.length();
         count++;
     }
-    if ((int) str2.length() > 0) {
-        result.push_back(str2);
+    if (start < str.length()) {
+        result.push_back(str.substr(start));
     }
 
     return result;
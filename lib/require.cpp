@@ -3,6 +3,8 @@
  * -----------------
  * This file implements the require.h interface.
  *
+ * @version 2022/03/20
+ * - inRange2D only builds its messages when a value is out of range
  * @version 2018/09/05
  * - initial version
  */
@@ -57,6 +59,9 @@ void inRange2D(double x, double y, double maxX, double maxY, const std::string&
 }
 
 void inRange2D(double x, double y, double minX, double minY, double maxX, double maxY, const std::string& caller, const std::string& xValueName, const std::string& yValueName, const std::string& details) {
+    if (minX <= x && x <= maxX && minY <= y && y <= maxY) {
+        return;   // the messages below are only worth building on failure
+    }
     inRange(x, minX, maxX, caller, xValueName, _default(details, " must be between (" + std::to_string(minX) + "," + std::to_string(minY) + ")-" + std::to_string(maxX) + "," + std::to_string(maxY) + ") inclusive but was (" + std::to_string(x) + "," + std::to_string(y) + ")"));
     inRange(y, minY, maxY, caller, yValueName, _default(details, " must be between (" + std::to_string(minX) + "," + std::to_string(minY) + ")-" + std::to_string(maxX) + "," + std::to_string(maxY) + ") inclusive but was (" + std::to_string(x) + "," + std::to_string(y) + ")"));
 }
@@ -66,6 +71,9 @@ void inRange2D(int x, int y, int maxX, int maxY, const std::string& caller, cons
 }
 
 void inRange2D(int x, int y, int minX, int minY, int maxX, int maxY, const std::string& caller, const std::string& xValueName, const std::string& yValueName, const std::string& details) {
+    if (minX <= x && x <= maxX && minY <= y && y <= maxY) {
+        return;   // the messages below are only worth building on failure
+    }
     inRange(x, minX, maxX, caller, xValueName, _default(details, " must be between (" + std::to_string(minX) + "," + std::to_string(minY) + ")-" + std::to_string(maxX) + "," + std::to_string(maxY) + ") inclusive but was (" + std::to_string(x) + "," + std::to_string(y) + ")"));
     inRange(y, minY, maxY, caller, yValueName, _default(details, " must be between (" + std::to_string(minX) + "," + std::to_string(minY) + ")-" + std::to_string(maxX) + "," + std::to_string(maxY) + ") inclusive but was (" + std::to_string(x) + "," + std::to_string(y) + ")"));
 }
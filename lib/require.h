@@ -4,6 +4,9 @@
  *
  * This file contains assertion functions for argument checking within the
  * code of the SGL C++ library itself.
+ *
+ * @version 2022/03/20
+ * - added Policy, so per-element checks can be turned off per build or per call
  */
 
 
@@ -12,11 +15,51 @@
 
 #include <string>
 
+/*
+ * How much checking per-element calls such as GCanvas::setPixel do can be
+ * chosen when building the library by defining SGL_REQUIRE_POLICY as one of
+ * these.  Checks that run once per object or per batch are not affected.
+ */
+#define SGL_REQUIRE_CHECKED 0
+#define SGL_REQUIRE_DEBUG_CHECKED 1
+#define SGL_REQUIRE_UNCHECKED 2
+
+#ifndef SGL_REQUIRE_POLICY
+#define SGL_REQUIRE_POLICY SGL_REQUIRE_CHECKED
+#endif
+
 /**
  * @private
  */
 namespace require {
 
+/*
+ * Whether a call site checks its arguments: always, only in builds without
+ * NDEBUG, or never.
+ */
+enum Policy {
+    CHECKED = SGL_REQUIRE_CHECKED,
+    DEBUG_CHECKED = SGL_REQUIRE_DEBUG_CHECKED,
+    UNCHECKED = SGL_REQUIRE_UNCHECKED
+};
+
+/*
+ * The policy per-element call sites use unless they choose their own.
+ */
+const Policy DEFAULT_POLICY = static_cast<Policy>(SGL_REQUIRE_POLICY);
+
+/*
+ * Returns whether a call site with the given policy should check its
+ * arguments in this build, e.g. if (require::shouldCheck()) { ... }
+ */
+inline bool shouldCheck(Policy policy = DEFAULT_POLICY) {
+#ifdef NDEBUG
+    return policy == CHECKED;
+#else
+    return policy != UNCHECKED;
+#endif
+}
+
 void inRange(double value, double min, double max, const std::string& caller = "", const std::string& valueName = "", const std::string& details = "");
 void inRange(int value, int min, int max, const std::string& caller = "", const std::string& valueName = "", const std::string& details = "");
 void inRange2D(double x, double y, double maxX, double maxY, const std::string& caller = "", const std::string& xValueName = "", const std::string& yValueName = "", const std::string& details = "");
@@ -0,0 +1,339 @@
+/*Joshua Lindquist & Sarah Allen
+CS132 Winter 2022
+Final Project: Simulation
+
+Cpp file for the Behavior class*/
+
+#include "Behavior.h"
+#include "Entity.h"
+#include "SimRandom.h"
+#include <algorithm>
+#include <fstream>
+#include <sstream>
+
+//The rules the hand-written getMove()s used to follow, in the same order and with the same
+//random draws
+static const char* DEFAULT_SCENARIO =
+    "species Deer\n"
+    "look NORTH SOUTH WEST EAST\n"
+    "1 avoid Tree Building\n"
+    "2 flee Tiger Hunter Lumberjack for 5 rest 5\n"
+    "3 wander\n"
+    "\n"
+    "species Hunter\n"
+    "look NORTH SOUTH WEST EAST\n"
+    "1 target Deer\n"
+    "2 avoid Tree Building\n"
+    "3 wander\n"
+    "\n"
+    "species Lumberjack\n"
+    "look NORTH SOUTH WEST EAST\n"
+    "1 target Tree\n"
+    "1 avoid Building\n"
+    "2 wander\n"
+    "\n"
+    "species Tiger\n"
+    "look NORTH EAST SOUTH WEST\n"
+    "1 avoid Tree Building\n"
+    "2 target Deer Hunter Lumberjack Tiger Entity\n"
+    "3 wander for 5\n";
+
+const unsigned char Behavior::NO_RULE;
+
+//Returns the way back from dir
+static Direction opposite(Direction dir) {
+    switch (dir) {
+        case NORTH: return SOUTH;
+        case SOUTH: return NORTH;
+        case EAST:  return WEST;
+        case WEST:  return EAST;
+        default:    return CENTER;
+    }
+}
+
+Behavior::Behavior(Species species) {
+    this->species = species;
+    look[0] = NORTH;
+    look[1] = EAST;
+    look[2] = SOUTH;
+    look[3] = WEST;
+    fleeRule = -1;
+}
+
+const Behavior* Behavior::forSpecies(Species species) {
+    return behaviors()[species];
+}
+
+vector<Behavior*>& Behavior::behaviors() {
+    static vector<Behavior*> all = [] {
+        vector<Behavior*> parsed;
+        string error;
+        parse(DEFAULT_SCENARIO, parsed, error);
+        return parsed;
+    }();
+    return all;
+}
+
+bool Behavior::load(const string& path, string& error) {
+    ifstream file(path);
+    if (!file.good()) {
+        error = "could not read " + path;
+        return false;
+    }
+    stringstream text;
+    text << file.rdbuf();
+    return compile(text.str(), error);
+}
+
+bool Behavior::compile(const string& text, string& error) {
+    vector<Behavior*> parsed;
+    if (!parse(text, parsed, error)) {
+        return false;
+    }
+    vector<Behavior*>& all = behaviors();
+    for (int s = 0; s < SPECIES_COUNT; s++) {
+        if (parsed[s] != nullptr) {
+            delete all[s];
+            all[s] = parsed[s];
+        }
+    }
+    return true;
+}
+
+bool Behavior::parse(const string& text, vector<Behavior*>& parsed, string& error) {
+    parsed.assign(SPECIES_COUNT, nullptr);
+    Behavior* current = nullptr;
+    istringstream lines(text);
+    string line;
+    int number = 0;
+    auto fail = [&](const string& message) {
+        error = "line " + to_string(number) + ": " + message;
+        for (Behavior* behavior : parsed) {
+            delete behavior;
+        }
+        parsed.assign(SPECIES_COUNT, nullptr);
+        return false;
+    };
+    auto speciesNamed = [](const string& name) {
+        int s = 0;
+        while (s < SPECIES_COUNT && to_string((Species) s) != name) {
+            s++;
+        }
+        return s;
+    };
+
+    while (getline(lines, line)) {
+        number++;
+        line = line.substr(0, line.find('#'));
+        istringstream words(line);
+        string word;
+        if (!(words >> word)) {
+            continue;
+        }
+        if (word == "species") {
+            string name;
+            words >> name;
+            int s = speciesNamed(name);
+            if (s == SPECIES_COUNT || s == EMPTY) {
+                return fail("unknown species \"" + name + "\"");
+            }
+            if (parsed[s] != nullptr) {
+                return fail(name + " is described twice");
+            }
+            current = parsed[s] = new Behavior((Species) s);
+        } else if (current == nullptr) {
+            return fail("expected \"species\" before \"" + word + "\"");
+        } else if (word == "look") {
+            int seen = 0;
+            for (int i = 0; i < 4; i++) {
+                string name;
+                words >> name;
+                int d = NORTH;
+                while (d <= WEST && to_string((Direction) d) != name) {
+                    d++;
+                }
+                if (d > WEST || (seen & (1 << d))) {
+                    return fail("look needs NORTH, EAST, SOUTH and WEST once each");
+                }
+                seen |= 1 << d;
+                current->look[i] = (Direction) d;
+            }
+        } else {
+            Rule rule = Rule {TARGET, 0, 0, 0, 0};
+            istringstream priority(word);
+            string action;
+            if (!(priority >> rule.priority) || !priority.eof()) {
+                return fail("expected look or a priority, got \"" + word + "\"");
+            }
+            words >> action;
+            if (action == "target") {
+                rule.action = TARGET;
+            } else if (action == "avoid") {
+                rule.action = AVOID;
+            } else if (action == "flee") {
+                rule.action = FLEE;
+            } else if (action == "wander") {
+                rule.action = WANDER;
+            } else {
+                return fail("unknown action \"" + action + "\"");
+            }
+            while (words >> word) {
+                if (word == "for" || word == "rest") {
+                    int& value = word == "for" ? rule.steps : rule.rest;
+                    if (!(words >> value) || value < 0) {
+                        return fail(word + " needs a number of ticks");
+                    }
+                } else if (rule.action == WANDER) {
+                    return fail("wander doesn't take species");
+                } else {
+                    int s = speciesNamed(word);
+                    if (s == SPECIES_COUNT) {
+                        return fail("unknown species \"" + word + "\"");
+                    }
+                    rule.species |= 1 << s;
+                }
+            }
+            if (rule.action != WANDER && rule.species == 0) {
+                return fail(action + " needs at least one species");
+            }
+            if (rule.action == FLEE) {
+                if (rule.steps == 0) {
+                    return fail("flee needs \"for\" a number of ticks");
+                }
+                for (const Rule& other : current->rules) {
+                    if (other.action == FLEE) {
+                        return fail("only one flee rule per species");
+                    }
+                }
+            }
+            if (current->rules.size() == NO_RULE) {
+                return fail("too many rules");
+            }
+            current->rules.push_back(rule);
+        }
+    }
+    for (Behavior* behavior : parsed) {
+        if (behavior != nullptr) {
+            behavior->build();
+        }
+    }
+    return true;
+}
+
+void Behavior::build() {
+    //Lowest priority first; rules with the same priority keep the order they were written in
+    stable_sort(rules.begin(), rules.end(), [](const Rule& a, const Rule& b) {
+        return a.priority < b.priority;
+    });
+    fleeRule = -1;
+    for (int r = 0; r < rules.size(); r++) {
+        if (rules[r].action == FLEE) {
+            fleeRule = r;
+        }
+    }
+
+    table.assign(Entity::SIGNATURE_COUNT, Entry {NO_RULE, 0});
+    int mask = (1 << Entity::SIGNATURE_BITS) - 1;
+    for (int signature = 0; signature < Entity::SIGNATURE_COUNT; signature++) {
+        Entry& entry = table[signature];
+        for (int first = 0, last = 0; first < rules.size() && entry.rule == NO_RULE; first = last) {
+            while (last < rules.size() && rules[last].priority == rules[first].priority) {
+                last++;
+            }
+            //A group looks one direction at a time, each rule in turn, and wanders if it
+            //finds nothing
+            for (int i = 0; i < 4 && entry.rule == NO_RULE; i++) {
+                int neighbor = (signature >> ((look[i] - NORTH) * Entity::SIGNATURE_BITS)) & mask;
+                for (int r = first; r < last && entry.rule == NO_RULE; r++) {
+                    if (rules[r].action != WANDER && (rules[r].species & (1 << neighbor))) {
+                        entry = Entry {(unsigned char) r, (unsigned char) i};
+                    }
+                }
+            }
+            for (int r = first; r < last && entry.rule == NO_RULE; r++) {
+                if (rules[r].action == WANDER) {
+                    entry = Entry {(unsigned char) r, 0};
+                }
+            }
+        }
+    }
+}
+
+int Behavior::affinity(Species other) const {
+    for (const Rule& rule : rules) {
+        if (rule.action != WANDER && (rule.species & (1 << other))) {
+            return rule.action == TARGET ? 4 : 0;
+        }
+    }
+    return 1;
+}
+
+BehaviorMemory Behavior::start() {
+    return BehaviorMemory {CENTER, 0, -1, 0};
+}
+
+Direction Behavior::move(int signature, BehaviorMemory& memory, Branch& branch) const {
+    const Entry& entry = table[signature];
+
+    //Running and resting come first unless something more important than the flee rule is
+    //next to it
+    if (fleeRule >= 0 && (entry.rule == NO_RULE || rules[entry.rule].priority >= rules[fleeRule].priority)) {
+        if (memory.flee > 0) {
+            memory.flee--;
+            branch = BRANCH_FLEEING;
+            BehaviorCounters::count(species, branch);
+            return memory.heading;
+        } else if (memory.flee == 0) {
+            memory.rest = rules[fleeRule].rest;
+            memory.flee = -1;
+            branch = BRANCH_REST;
+            BehaviorCounters::count(species, branch);
+            return CENTER;
+        } else if (memory.rest != 0) {
+            memory.rest--;
+            branch = BRANCH_REST;
+            BehaviorCounters::count(species, branch);
+            return CENTER;
+        }
+    }
+
+    if (entry.rule == NO_RULE) {
+        branch = BRANCH_REST;
+        BehaviorCounters::count(species, branch);
+        return CENTER;
+    }
+    const Rule& rule = rules[entry.rule];
+    Direction dir = CENTER;
+    switch (rule.action) {
+        case TARGET:
+            branch = BRANCH_TARGET;
+            dir = look[entry.look];
+            break;
+        case AVOID:
+            //Turn to one side or the other of it
+            branch = BRANCH_AVOID;
+            dir = look[(entry.look + (SimRandom::below(2) == 0 ? 1 : 3)) % 4];
+            break;
+        case FLEE:
+            branch = BRANCH_FLEE;
+            memory.flee = rule.steps;
+            memory.heading = opposite(look[entry.look]);
+            dir = memory.heading;
+            break;
+        case WANDER:
+            branch = BRANCH_WANDER;
+            if (rule.steps == 0) {
+                memory.heading = look[SimRandom::below(4)];
+            } else if (memory.steps == 0) {
+                memory.steps = rule.steps;
+                memory.heading = look[SimRandom::below(4)];
+            }
+            if (memory.steps > 0) {
+                memory.steps--;
+            }
+            dir = memory.heading;
+            break;
+    }
+    BehaviorCounters::count(species, branch);
+    return dir;
+}
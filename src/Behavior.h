@@ -0,0 +1,108 @@
+/*Sarah Allen & Joshua Lindquist
+CS132 Winter 2022
+Final Project: Simulation
+
+Class main author: Josh
+
+Header for the Behavior class, which decides how a kind of Creature moves from a description
+in a scenario file instead of code. A scenario lists, for each species, the order it looks
+around in and a set of rules with priorities:
+
+    #Deer turn away from trees, run from anything that hunts them, and rest after running
+    species Deer
+    look NORTH SOUTH WEST EAST
+    1 avoid Tree Building
+    2 flee Tiger Hunter Lumberjack for 5 rest 5
+    3 wander
+
+Lower priorities are checked first. target moves toward the first neighbor of the listed species,
+avoid turns to one side of it at random, flee runs the other way for a number of steps and then
+rests, and wander moves randomly, keeping the same way for "for N" steps if given. Rules with the
+same priority are checked together, one direction at a time. When a scenario is loaded every
+species' rules are compiled into a table with an entry for every combination of the four neighbors,
+so a move is one table lookup plus the random draws for ties. Deer, Hunters, Lumberjacks and Tigers
+start out with built-in rules that move them exactly as they always have.*/
+
+#ifndef _BEHAVIOR_H
+#define _BEHAVIOR_H
+
+#include <string>
+#include <vector>
+#include "entitytypes.h"
+#include "BehaviorCounters.h"
+using namespace std;
+
+//What a Behavior remembers about one Creature between moves
+struct BehaviorMemory {
+    Direction heading;  //way it is fleeing or wandering
+    int steps;          //steps left in heading while wandering
+    int flee;           //steps left fleeing, 0 to start resting, -1 if not fleeing
+    int rest;           //ticks left resting
+};
+
+class Behavior {
+public:
+    //Returns the Behavior Creatures of species follow, or nullptr if there isn't one
+    static const Behavior* forSpecies(Species species);
+
+    //Reads the scenario file at path and compiles it. The species it describes get their new
+    //rules; the others keep theirs. Returns false, with a message in error, if the file can't
+    //be read or doesn't make sense, and then nothing changes.
+    static bool load(const string& path, string& error);
+
+    //The same as load(), with the scenario in text
+    static bool compile(const string& text, string& error);
+
+    //Returns a BehaviorMemory for a new Creature
+    static BehaviorMemory start();
+
+    //Returns the move for a Creature whose neighbors pack into signature (see
+    //Entity::getSignature()) and updates its memory. branch is set to the kind of decision
+    //made, which is also counted in BehaviorCounters.
+    Direction move(int signature, BehaviorMemory& memory, Branch& branch) const;
+
+    //Returns how many times more often than by chance a Creature following this Behavior steps
+    //into a neighbor of species other: 4 if its first rule about other goes for it (it checks
+    //all four sides), 0 if that rule keeps away from it, and 1 if no rule mentions it
+    int affinity(Species other) const;
+
+private:
+    enum Action {TARGET, AVOID, FLEE, WANDER};
+
+    struct Rule {
+        Action action;
+        int priority;
+        int species;   //bit s set if the rule is about Species s
+        int steps;     //"for N"
+        int rest;      //"rest N"
+    };
+
+    //What a signature leads to: which rule, and which of the look directions it is about
+    struct Entry {
+        unsigned char rule;
+        unsigned char look;
+    };
+
+    static const unsigned char NO_RULE = 255;
+
+    Behavior(Species species);
+
+    //Works out the table entry for every signature from the rules
+    void build();
+
+    //Reads a scenario into parsed, by Species, and builds its tables. Returns false, with a
+    //message in error, if it doesn't make sense.
+    static bool parse(const string& text, vector<Behavior*>& parsed, string& error);
+
+    //The Behavior of every Species, nullptr where there isn't one. Starts out with the
+    //built-in scenario.
+    static vector<Behavior*>& behaviors();
+
+    Species species;
+    Direction look[4];  //order neighbors are checked in
+    vector<Rule> rules;
+    int fleeRule;       //the rule with a flee, -1 if none; its memory is checked at its priority
+    vector<Entry> table;  //by signature
+};
+
+#endif
@@ -0,0 +1,133 @@
+/*Joshua Lindquist & Sarah Allen
+CS132 Winter 2022
+Final Project: Simulation
+
+Cpp file for the BehaviorCounters class*/
+
+#include "BehaviorCounters.h"
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+std::string to_string(Branch branch) {
+    switch (branch) {
+        case BRANCH_AVOID:   return "avoid";
+        case BRANCH_FLEE:    return "flee";
+        case BRANCH_FLEEING: return "fleeing";
+        case BRANCH_REST:    return "rest";
+        case BRANCH_TARGET:  return "target";
+        case BRANCH_WANDER:  return "wander";
+        default:             return "unknown";
+    }
+}
+int BRANCH_COUNT = 6;
+
+BehaviorCounters* BehaviorCounters::_instance = nullptr;
+string BehaviorCounters::_runPath = "";
+
+BehaviorCounters::ThreadCounts::ThreadCounts(int size) : counts(size), merged(size, 0) {
+    for (int i = 0; i < size; i++) {
+        counts[i] = 0;
+    }
+}
+
+BehaviorCounters::BehaviorCounters() {
+    tickCounts.resize(SPECIES_COUNT * BRANCH_COUNT);
+    totalCounts.resize(SPECIES_COUNT * BRANCH_COUNT);
+}
+
+BehaviorCounters* BehaviorCounters::instance() {
+    if (!_instance) {
+        _instance = new BehaviorCounters();
+    }
+    return _instance;
+}
+
+BehaviorCounters::ThreadCounts* BehaviorCounters::local() {
+    //The registry keeps a reference too, so counts from a finished thread still get merged
+    thread_local ThreadCounts* counts = nullptr;
+    if (!counts) {
+        shared_ptr<ThreadCounts> made = make_shared<ThreadCounts>(SPECIES_COUNT * BRANCH_COUNT);
+        BehaviorCounters* all = instance();
+        lock_guard<mutex> lock(all->threadMutex);
+        all->threads.push_back(made);
+        counts = made.get();
+    }
+    return counts;
+}
+
+void BehaviorCounters::mergeTick() {
+    //Straight into tickCounts, so a tick's merge allocates nothing. Always threadMutex first.
+    lock_guard<mutex> lock(threadMutex);
+    lock_guard<mutex> totalLock(totalMutex);
+    fill(tickCounts.begin(), tickCounts.end(), 0);
+    for (shared_ptr<ThreadCounts>& thread : threads) {
+        for (int i = 0; i < tickCounts.size(); i++) {
+            unsigned long long now = thread->counts[i].load(memory_order_relaxed);
+            tickCounts[i] += now - thread->merged[i];
+            thread->merged[i] = now;
+        }
+    }
+    for (int i = 0; i < tickCounts.size(); i++) {
+        totalCounts[i] += tickCounts[i];
+    }
+}
+
+unsigned long long BehaviorCounters::getTickCount(Species species, Branch branch) {
+    lock_guard<mutex> lock(totalMutex);
+    return tickCounts[species * BRANCH_COUNT + branch];
+}
+
+unsigned long long BehaviorCounters::getTotalCount(Species species, Branch branch) {
+    lock_guard<mutex> lock(totalMutex);
+    return totalCounts[species * BRANCH_COUNT + branch];
+}
+
+string BehaviorCounters::toPrometheus() {
+    ostringstream out;
+    out << "# HELP sim_behavior_branch_total Times each species' getMove() took each branch.\n";
+    out << "# TYPE sim_behavior_branch_total counter\n";
+    lock_guard<mutex> lock(totalMutex);
+    for (int s = 0; s < SPECIES_COUNT; s++) {
+        for (int b = 0; b < BRANCH_COUNT; b++) {
+            unsigned long long count = totalCounts[s * BRANCH_COUNT + b];
+            if (count == 0) { //most species never take most branches
+                continue;
+            }
+            out << "sim_behavior_branch_total{species=\"" << to_string((Species) s)
+                << "\",branch=\"" << to_string((Branch) b) << "\"} " << count << "\n";
+        }
+    }
+    return out.str();
+}
+
+bool BehaviorCounters::writeRun(const string& path) {
+    ofstream file(path);
+    if (!file.good()) {
+        return false;
+    }
+    file << "species,branch,count" << endl;
+    lock_guard<mutex> lock(totalMutex);
+    for (int s = 0; s < SPECIES_COUNT; s++) {
+        for (int b = 0; b < BRANCH_COUNT; b++) {
+            unsigned long long count = totalCounts[s * BRANCH_COUNT + b];
+            if (count != 0) {
+                file << to_string((Species) s) << "," << to_string((Branch) b) << ","
+                     << count << endl;
+            }
+        }
+    }
+    return file.good();
+}
+
+void BehaviorCounters::writeRunAtExit(const string& path) {
+    if (_runPath == "") {
+        atexit([] {
+            BehaviorCounters* counters = instance();
+            counters->mergeTick();
+            counters->writeRun(_runPath);
+        });
+    }
+    _runPath = path;
+}
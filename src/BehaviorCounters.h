@@ -0,0 +1,92 @@
+/*Sarah Allen & Joshua Lindquist
+CS132 Winter 2022
+Final Project: Simulation
+
+Class main author: Josh
+
+Header for the BehaviorCounters class, which counts how often each species' getMove() takes each
+of its decision branches (flee, rest, avoid an obstacle, go after a target, wander). getMove()
+calls count() which only bumps a counter owned by the calling thread; the Model merges every
+thread's counters once per tick, and the totals are exported with the other Metrics and can be
+written out at the end of a run.*/
+
+#ifndef _BEHAVIORCOUNTERS_H
+#define _BEHAVIORCOUNTERS_H
+
+#include <atomic>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "entitytypes.h"
+using namespace std;
+
+//The decision branches a getMove() can take
+enum Branch {
+    BRANCH_AVOID,    //turned away from a tree or building
+    BRANCH_FLEE,     //saw a threat and started running
+    BRANCH_FLEEING,  //still running from an earlier threat
+    BRANCH_REST,     //standing still to rest
+    BRANCH_TARGET,   //found prey, a tree or a mate next to it and went for it
+    BRANCH_WANDER    //nothing around, moved randomly
+};
+std::string to_string(Branch branch);
+extern int BRANCH_COUNT;
+
+class BehaviorCounters {
+public:
+    //Returns the single BehaviorCounters object for this process, creating it if needed
+    static BehaviorCounters* instance();
+
+    //Counts one decision. Cheap enough to call on every getMove(): no locks, no shared writes.
+    static void count(Species species, Branch branch);
+
+    //Folds every thread's counts into the totals; the Model calls this when a tick is committed
+    void mergeTick();
+
+    //Returns how often species took branch during the last merged tick
+    unsigned long long getTickCount(Species species, Branch branch);
+
+    //Returns how often species took branch since the run started, as of the last merge
+    unsigned long long getTotalCount(Species species, Branch branch);
+
+    //Returns the run totals in the Prometheus text format, for Metrics to export
+    string toPrometheus();
+
+    //Writes the run totals as species,branch,count lines. Returns false if the file failed.
+    bool writeRun(const string& path);
+
+    //Merges and calls writeRun(path) when the program exits
+    void writeRunAtExit(const string& path);
+
+private:
+    BehaviorCounters();
+
+    //One thread's counts. Only that thread writes them, and they only ever grow, so merging just
+    //reads them and keeps the difference from what it saw last time.
+    struct ThreadCounts {
+        vector<atomic<unsigned long long>> counts;
+        vector<unsigned long long> merged;
+        ThreadCounts(int size);
+    };
+
+    //Returns the calling thread's counts, registering them on first use
+    static ThreadCounts* local();
+
+    static BehaviorCounters* _instance;
+    static string _runPath;
+
+    mutex threadMutex;
+    vector<shared_ptr<ThreadCounts>> threads;
+    mutex totalMutex;
+    vector<unsigned long long> tickCounts;
+    vector<unsigned long long> totalCounts;
+};
+
+inline void BehaviorCounters::count(Species species, Branch branch) {
+    atomic<unsigned long long>& counter = local()->counts[species * BRANCH_COUNT + branch];
+    //Only this thread writes the counter, so a plain load and store is enough
+    counter.store(counter.load(memory_order_relaxed) + 1, memory_order_relaxed);
+}
+
+#endif
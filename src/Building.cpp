@@ -12,6 +12,10 @@ string Building::getType() {
     return "Building";
 }
 
+Species Building::getSpecies() {
+    return BUILDING;
+}
+
 string Building::toString() {
     //return "H";
     return "\xF0\x9F\x8F\xA0";
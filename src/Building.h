@@ -20,6 +20,9 @@ public:
     //Returns "Building"
     virtual string getType();
 
+    //Returns BUILDING
+    virtual Species getSpecies();
+
     //Returns image of building using a UTC-8 hex code 
     virtual string toString();
 
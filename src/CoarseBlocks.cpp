@@ -0,0 +1,232 @@
+/*Joshua Lindquist & Sarah Allen
+CS132 Winter 2022
+Final Project: Simulation
+
+Cpp file for the CoarseBlocks class*/
+
+#include "CoarseBlocks.h"
+#include "Behavior.h"
+#include "Model.h"
+#include "SimRandom.h"
+#include <algorithm>
+
+const int CoarseBlocks::BLOCK;
+
+CoarseBlocks::CoarseBlocks(int size) {
+    this->size = size;
+    perSide = (size + BLOCK - 1) / BLOCK;
+    coarse.assign(perSide * perSide, false);
+    counts.assign((size_t) perSide * perSide * SPECIES_COUNT, 0);
+    moved.assign(counts.size(), 0);
+
+    //Only Species with a Behavior move; the rest just get walked into
+    affinity.assign(SPECIES_COUNT * SPECIES_COUNT, 0);
+    weapons.assign(SPECIES_COUNT, FORFEIT);
+    for (int s = 0; s < SPECIES_COUNT; s++) {
+        const Behavior* behavior = Behavior::forSpecies((Species) s);
+        for (int t = 0; t < SPECIES_COUNT && behavior != nullptr; t++) {
+            affinity[s * SPECIES_COUNT + t] = behavior->affinity((Species) t);
+        }
+        Entity* sample = Model::typeTranslator((Species) s);
+        if (sample != nullptr) {
+            weapons[s] = sample->fight();
+            delete sample;
+        }
+    }
+}
+
+int CoarseBlocks::blockOf(int row, int col) const {
+    return (row / BLOCK) * perSide + col / BLOCK;
+}
+
+bool CoarseBlocks::isCoarse(int row, int col) const {
+    return coarse[blockOf(row, col)];
+}
+
+bool CoarseBlocks::isCoarseBlock(int block) const {
+    return coarse[block];
+}
+
+void CoarseBlocks::setCoarse(int block, bool coarse) {
+    this->coarse[block] = coarse;
+}
+
+void CoarseBlocks::bounds(int block, int& row, int& col, int& rows, int& cols) const {
+    row = (block / perSide) * BLOCK;
+    col = (block % perSide) * BLOCK;
+    rows = min(BLOCK, size - row);
+    cols = min(BLOCK, size - col);
+}
+
+int CoarseBlocks::blockEnd(int col) const {
+    return min(size, (col / BLOCK + 1) * BLOCK);
+}
+
+int CoarseBlocks::neighbor(int block, Direction dir) const {
+    //The same way round as Model::neighborCell(): EAST and WEST change the row
+    int row = block / perSide;
+    int col = block % perSide;
+    if (dir == WEST) {
+        row = (row + perSide - 1) % perSide;
+    } else if (dir == EAST) {
+        row = (row + 1) % perSide;
+    } else if (dir == NORTH) {
+        col = (col + perSide - 1) % perSide;
+    } else if (dir == SOUTH) {
+        col = (col + 1) % perSide;
+    }
+    return row * perSide + col;
+}
+
+int CoarseBlocks::getCount(int block, Species species) const {
+    return counts[(size_t) block * SPECIES_COUNT + species];
+}
+
+void CoarseBlocks::setCount(int block, Species species, int count) {
+    counts[(size_t) block * SPECIES_COUNT + species] = count;
+}
+
+long CoarseBlocks::total(Species species) const {
+    long sum = 0;
+    for (int b = 0; b < coarse.size(); b++) {
+        if (coarse[b]) {
+            sum += counts[(size_t) b * SPECIES_COUNT + species];
+        }
+    }
+    return sum;
+}
+
+int CoarseBlocks::room(int block) const {
+    int row;
+    int col;
+    int rows;
+    int cols;
+    bounds(block, row, col, rows, cols);
+    const int* n = &counts[(size_t) block * SPECIES_COUNT];
+    const int* incoming = &moved[(size_t) block * SPECIES_COUNT];
+    int taken = 0;
+    for (int s = EMPTY + 1; s < SPECIES_COUNT; s++) {
+        taken += n[s] + incoming[s];
+    }
+    return max(0, rows * cols - taken);
+}
+
+int CoarseBlocks::getBlockCount() const {
+    return coarse.size();
+}
+
+int CoarseBlocks::roundRandomly(double x) {
+    int whole = (int) x;
+    return whole + (SimRandom::below(1 << 20) < (x - whole) * (1 << 20));
+}
+
+void CoarseBlocks::step(long tick, vector<Arrival>& arrivals) {
+    for (int b = 0; b < coarse.size(); b++) {
+        if (!coarse[b]) {
+            continue;
+        }
+        SimRandom::atCell(tick, -4, b, 0);
+        int* n = &counts[(size_t) b * SPECIES_COUNT];
+        int row;
+        int col;
+        int rows;
+        int cols;
+        bounds(b, row, col, rows, cols);
+        double area = rows * cols;
+        int occupied = 0;
+        for (int s = EMPTY + 1; s < SPECIES_COUNT; s++) {
+            occupied += n[s];
+        }
+
+        //A Creature that steps onto one of its neighbors' cells mates with its own kind (or a
+        //Hunter with a Lumberjack) and fights anything else, just like Model::moveEntity().
+        //The next map is filled in cell by cell, so only the neighbors north and west have
+        //moved yet and can be met. Stepping south or east onto something that never moves
+        //ends with it being put back on top of the Creature.
+        for (int s = EMPTY + 1; s < SPECIES_COUNT; s++) {
+            for (int t = EMPTY + 1; t < SPECIES_COUNT && n[s] > 0; t++) {
+                int others = n[t] - (s == t);
+                int rate = affinity[s * SPECIES_COUNT + t];
+                if (others <= 0 || rate == 0) {
+                    continue;
+                }
+                double steps = n[s] * (others / area) * rate / 2;
+                if (Behavior::forSpecies((Species) t) == nullptr) {
+                    int crushed = min(n[s], roundRandomly(steps));
+                    n[s] -= crushed;
+                    occupied -= crushed;
+                }
+                int meetings = min(n[s], roundRandomly(steps));
+                if (meetings == 0) {
+                    continue;
+                }
+                bool mates = s == t || (s == HUNTER && t == LUMBERJACK)
+                             || (s == LUMBERJACK && t == HUNTER);
+                if (mates) {
+                    //The baby takes its parent's place, and the parent is lost if there is no
+                    //empty cell next to it
+                    double crowded = occupied / area;
+                    int lost = min(n[s], roundRandomly(meetings * crowded * crowded * crowded * crowded));
+                    n[s] -= lost;
+                    occupied -= lost;
+                    continue;
+                }
+                //The same odds as Model::fight()
+                Attack mine = weapons[s];
+                Attack theirs = weapons[t];
+                double winChance = 0;
+                if (theirs == FORFEIT || (mine == BITE && theirs == CHOP)) {
+                    winChance = 1;
+                } else if ((mine == STAB && theirs == BITE) || (mine == BITE && theirs == STAB)) {
+                    winChance = 0.5;
+                }
+                int wins = min(n[t], roundRandomly(meetings * winChance));
+                int losses = min(n[s], meetings - wins);
+                if (t == TREE) {
+                    //A beaten Tree becomes a Building on the same cell, and the winner goes back
+                    //where it was, so the block is no fuller
+                    n[TREE] -= wins;
+                    n[BUILDING] += wins;
+                } else {
+                    n[t] -= wins;
+                    occupied -= wins;
+                }
+                n[s] -= losses;
+                occupied -= losses;
+            }
+        }
+
+        //Creatures on an edge that step over it leave. A quarter of them step each way, and one
+        //row (or column) in rows (or cols) is the edge.
+        for (int s = EMPTY + 1; s < SPECIES_COUNT; s++) {
+            if (Behavior::forSpecies((Species) s) == nullptr) {
+                continue;
+            }
+            int start = n[s];
+            int staying = n[s];
+            for (Direction dir : {NORTH, EAST, SOUTH, WEST}) {
+                int across = dir == EAST || dir == WEST ? rows : cols;
+                int leaving = min(staying, roundRandomly(start / (4.0 * across)));
+                int next = neighbor(b, dir);
+                if (coarse[next]) {
+                    //Counts only ever go down during the rest of the step, so this can't
+                    //overfill next
+                    leaving = min(leaving, room(next));
+                    n[s] -= leaving;
+                    moved[(size_t) next * SPECIES_COUNT + s] += leaving;
+                } else {
+                    Direction side = dir == NORTH ? SOUTH : dir == SOUTH ? NORTH
+                                   : dir == EAST ? WEST : EAST;
+                    for (int i = 0; i < leaving; i++) {
+                        arrivals.push_back(Arrival {next, side, (Species) s, b});
+                    }
+                }
+                staying -= leaving;
+            }
+        }
+    }
+    for (size_t i = 0; i < counts.size(); i++) {
+        counts[i] += moved[i];
+    }
+    fill(moved.begin(), moved.end(), 0);
+}
@@ -0,0 +1,92 @@
+/*Sarah Allen & Joshua Lindquist
+CS132 Winter 2022
+Final Project: Simulation
+
+Class main author: Josh
+
+Header for the CoarseBlocks class, which stands in for the parts of a big world nobody is
+watching. The map is cut into BLOCK by BLOCK blocks. A coarse block keeps no Entities, only how
+many of each Species are in it, and each tick moves those numbers along with rates worked out
+from the same rules the Entities follow: how often a Creature walks into each Species (from its
+Behavior), whether that ends in a birth or a fight, who wins the fight (from the weapons), and
+how many step over the edge into the blocks around it. A tick of a coarse block costs the same
+however many Entities it holds, so a world that is mostly coarse runs far faster than one made
+of Entities. The Model turns blocks back into Entities when they come into view (see
+Model::setFocus()).*/
+
+#ifndef _COARSEBLOCKS_H
+#define _COARSEBLOCKS_H
+
+#include <vector>
+#include "entitytypes.h"
+using namespace std;
+
+//A Creature that walked out of a coarse block into a block with Entities, for the Model to place
+struct Arrival {
+    int block;          //block it arrives in
+    Direction side;     //side of that block it comes in on
+    Species species;
+    int from;           //coarse block it left, which still counts it until it is placed
+};
+
+class CoarseBlocks {
+public:
+    //Makes blocks for a size by size map, none of them coarse
+    CoarseBlocks(int size);
+
+    //Returns the number of the block holding the cell (row, col)
+    int blockOf(int row, int col) const;
+
+    //Returns true if the block holding (row, col) is coarse
+    bool isCoarse(int row, int col) const;
+    bool isCoarseBlock(int block) const;
+
+    //Marks a block coarse or not. Counts are left alone; the Model fills them in or empties them.
+    void setCoarse(int block, bool coarse);
+
+    //Puts the first cell and size of a block in row, col, rows and cols. Blocks on the far edges
+    //are smaller if the map isn't a whole number of blocks.
+    void bounds(int block, int& row, int& col, int& rows, int& cols) const;
+
+    //Returns the column just past the block holding col
+    int blockEnd(int col) const;
+
+    //Returns the block next to block in direction dir, wrapping around the edges
+    int neighbor(int block, Direction dir) const;
+
+    //Returns the number of Entities of species in a block
+    int getCount(int block, Species species) const;
+    void setCount(int block, Species species, int count);
+
+    //Returns the number of Entities of species in every coarse block together
+    long total(Species species) const;
+
+    //Returns how many more Entities a block has free cells for, counting what step() is
+    //moving into it
+    int room(int block) const;
+
+    int getBlockCount() const;
+
+    //Runs one tick of every coarse block. No more Creatures move into a coarse block than it has
+    //free cells for; the rest stay where they were. Creatures that leave for a block that isn't
+    //coarse are added to arrivals, and stay in their own block's counts until the Model takes
+    //them off after placing them.
+    void step(long tick, vector<Arrival>& arrivals);
+
+    //Cells each way in a block
+    static const int BLOCK = 16;
+
+private:
+    //Returns x rounded down or up at random, so it is right on average
+    static int roundRandomly(double x);
+
+    int size;
+    int perSide;              //blocks each way
+    vector<bool> coarse;      //by block
+    vector<int> counts;       //by block, SPECIES_COUNT each
+    vector<int> moved;        //what step() moves into each block, SPECIES_COUNT each
+    vector<int> affinity;     //by mover and other Species, see Behavior::affinity()
+    vector<Attack> weapons;   //by Species
+};
+
+#endif
@@ -6,58 +6,32 @@ Cpp file for the Deer class*/
 
 #include <iostream>
 #include "Deer.h"
-#include <vector>
 using namespace std;
 
 Deer::Deer() {
     stepCount = 0;
-    currentDir = CENTER;
     hasMated = false;
-    flee = -1;
-    rest = 0;
+    memory = Behavior::start();
 }
 
 Direction Deer::getMove() {
-    vector<Direction> dirs {NORTH, SOUTH, WEST, EAST};
-    vector<Direction> opposite {SOUTH, NORTH, EAST, WEST};
-    //Don't hit trees or houses
-    for (int i = 0; i < dirs.size(); i++) {
-        if (getNeighbor(dirs[i]) == "Tree" || getNeighbor(dirs[i]) == "Building") {
-            int chance = rand() % 2;
-            if (chance == 0) {
-                return dirs[(i+1) % 4];
-            } else {
-                return dirs[(i-1) % 4];
-            }
-        }
-    }
-    if (flee > 0) {
-        flee--;
-        return currentDir;
-    } else if (flee == 0) {
-        rest = 5;
-        flee = -1;
-        return CENTER;
-    } else if (rest != 0) {
-        rest--;
-        return CENTER;
-    } else {
-        for (int i = 0; i < dirs.size(); i++) {
-            if (getNeighbor(dirs[i]) == "Tiger" || getNeighbor(dirs[i]) == "Hunter" || getNeighbor(dirs[i]) == "Lumberjack") {
-                flee = 5;
-                currentDir = opposite[i];
-                return currentDir;
-            }
-        }
-        int random = rand() % 4;
-        return dirs[random];
-    }
+    Branch branch;
+    return Behavior::forSpecies(DEER)->move(getSignature(), memory, branch);
+}
+
+Direction Deer::getMove(const Surroundings& around) {
+    Branch branch;
+    return Behavior::forSpecies(DEER)->move(around.signature, memory, branch);
 }
 
 string Deer::getType() {
     return "Deer";
 }
 
+Species Deer::getSpecies() {
+    return DEER;
+}
+
 string Deer::toString() {
     return "\xF0\x9F\xA6\x8C";
 }
@@ -68,4 +42,23 @@ string Deer::getColor() {
 
 // Attack Deer::fight() const {
 //     return FORFEIT;
-// }
\ No newline at end of file
+// }
+
+void Deer::saveState(int* state) const {
+    Entity::saveState(state);
+    state[0] = stepCount;
+    state[1] = memory.heading;
+    state[2] = hasMated;
+    state[3] = memory.flee;
+    state[4] = memory.rest;
+    state[5] = memory.steps;
+}
+
+void Deer::loadState(const int* state) {
+    stepCount = state[0];
+    memory.heading = (Direction) state[1];
+    hasMated = state[2] != 0;
+    memory.flee = state[3];
+    memory.rest = state[4];
+    memory.steps = state[5];
+}
@@ -11,6 +11,7 @@ They will try to run from all threats, but need to rest after their burst of spe
 #define _DEER_H
 
 #include "Creature.h"
+#include "Behavior.h"
 using namespace std;
 
 class Deer : public Creature {
@@ -18,12 +19,18 @@ public:
     //Constructor
     Deer();
 
-    //Prefers to stay near trees and away from buildings/predators
+    //Prefers to stay near trees and away from buildings/predators, following the Deer Behavior
     virtual Direction getMove();
+
+    //The same, from what the Model shows it, without going through getNeighbor()
+    virtual Direction getMove(const Surroundings& around);
     
     //Returns "Deer"
     virtual string getType();
 
+    //Returns DEER
+    virtual Species getSpecies();
+
     //Returns image of deer using a UTC-8 hex code 
     virtual string toString();
 
@@ -32,12 +39,16 @@ public:
 
     // virtual Attack fight() const;
 
+    //Copies the Deer's stepCount, heading, hasMated, flee, rest and wander steps into state
+    virtual void saveState(int* state) const;
+
+    //Restores what saveState() wrote
+    virtual void loadState(const int* state);
+
 private: 
     int stepCount;
-    Direction currentDir;
     bool hasMated;
-    int flee;
-    int rest;
+    BehaviorMemory memory;
 };
 
 #endif
\ No newline at end of file
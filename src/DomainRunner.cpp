@@ -0,0 +1,408 @@
+/*Joshua Lindquist & Sarah Allen
+CS132 Winter 2022
+Final Project: Simulation
+
+Cpp file for the DomainRunner class*/
+
+#include "DomainRunner.h"
+#include <new>
+#include <stdexcept>
+
+#ifndef _WIN32
+#include <sched.h>
+#include <signal.h>
+#include <sys/mman.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#ifdef __linux__
+#include <sys/prctl.h>
+#endif
+
+static_assert(ATOMIC_LONG_LOCK_FREE == 2, "flags in shared memory need lock-free atomics");
+
+DomainRunner::DomainRunner(int modelSize, int domainCount, int tigerNum, int huntNum, int lumbNum,
+                           int treeNum, int deerNum) {
+    if (domainCount < 2 || modelSize < 2 * domainCount) {
+        throw invalid_argument("DomainRunner needs at least two domains of at least two rows");
+    }
+    if (Model::hasFootprints()) {
+        //A footprint could reach across a domain border, and halos only carry single cells
+        throw invalid_argument("DomainRunner only runs Entities that are 1 by 1");
+    }
+    if (Model::hasPerception()) {
+        //Halos go straight into the last tick's map, so its bit-planes don't show them
+        throw invalid_argument("DomainRunner can't run with a perception stencil");
+    }
+    this->size = modelSize;
+    this->domainCount = domainCount;
+    int startCounts[] = {tigerNum, huntNum, lumbNum, treeNum, deerNum};
+    for (int i = 0; i < 5; i++) {
+        counts[i] = startCounts[i];
+    }
+    failed = false;
+
+    //Split the rows as evenly as possible
+    for (int d = 0; d <= domainCount; d++) {
+        firstRows.push_back((int) ((long) modelSize * d / domainCount));
+    }
+
+    //Lay out the shared memory: control words, flags, mailbox rows, halos, snapshot grid
+    size_t controlSize = 64;
+    size_t flagsSize = sizeof(Flags) * domainCount;
+    size_t rowsSize = sizeof(CellRecord) * modelSize * ROW_COUNT * 2 * domainCount;
+    size_t halosSize = (size_t) modelSize * 2 * 2 * domainCount;
+    size_t gridSize = (size_t) modelSize * modelSize;
+    sharedSize = controlSize + flagsSize + rowsSize + halosSize + gridSize;
+    //NORESERVE: a big grid only costs memory once snapshot() touches it
+    void* memory = mmap(nullptr, sharedSize, PROT_READ | PROT_WRITE,
+                        MAP_SHARED | MAP_ANONYMOUS | MAP_NORESERVE, -1, 0);
+    if (memory == MAP_FAILED) {
+        throw runtime_error("DomainRunner could not map shared memory");
+    }
+    shared = (char*) memory;
+    target = new (shared) atomic<long>(0);
+    snapshotRequest = new (shared + sizeof(atomic<long>)) atomic<long>(0);
+    quit = new (shared + 2 * sizeof(atomic<long>)) atomic<long>(0);
+    flags = (Flags*) (shared + controlSize);
+    for (int d = 0; d < domainCount; d++) {
+        Flags* f = flags + d;
+        new (&f->halo) atomic<long>(0);
+        new (&f->forward) atomic<long>(0);
+        new (&f->back) atomic<long>(0);
+        new (&f->done) atomic<long>(0);
+        new (&f->snapshot) atomic<long>(0);
+    }
+    rows = (CellRecord*) (shared + controlSize + flagsSize);
+    halos = (unsigned char*) (shared + controlSize + flagsSize + rowsSize);
+    grid = halos + halosSize;
+
+    //Anything still buffered would otherwise be printed once per process
+    cout.flush();
+    for (int d = 0; d < domainCount; d++) {
+        int pid = fork();
+        if (pid < 0) {
+            failed = true;
+            break;
+        }
+        if (pid == 0) {
+#ifdef __linux__
+            prctl(PR_SET_PDEATHSIG, SIGKILL); //don't outlive the parent
+#endif
+            runDomain(d);
+            cout.flush();
+            _exit(0);
+        }
+        pids.push_back(pid);
+    }
+}
+
+DomainRunner::~DomainRunner() {
+    *quit = 1;
+    for (int pid : pids) {
+        if (failed) {
+            kill(pid, SIGKILL);
+        }
+        waitpid(pid, nullptr, 0);
+    }
+    munmap(shared, sharedSize);
+}
+
+bool DomainRunner::update(int ticks) {
+    if (failed) {
+        return false;
+    }
+    *target += ticks;
+    return waitForAll(&Flags::done, *target);
+}
+
+bool DomainRunner::snapshot(vector<unsigned char>& grid) {
+    if (failed) {
+        return false;
+    }
+    long request = ++*snapshotRequest;
+    if (!waitForAll(&Flags::snapshot, request)) {
+        return false;
+    }
+    grid.assign(this->grid, this->grid + (size_t) size * size);
+    return true;
+}
+
+long DomainRunner::getTick() {
+    return *target;
+}
+
+int DomainRunner::getSize() {
+    return size;
+}
+
+int DomainRunner::getDomainCount() {
+    return domainCount;
+}
+
+DomainRunner::CellRecord* DomainRunner::mailbox(int domain, long t, Row row) {
+    return rows + (((size_t) domain * 2 + (t & 1)) * ROW_COUNT + row) * size;
+}
+
+unsigned char* DomainRunner::halo(int domain, long t, bool top) {
+    return halos + (((size_t) domain * 2 + (t & 1)) * 2 + (top ? 0 : 1)) * size;
+}
+
+void DomainRunner::waitFor(atomic<long>& flag, long value) {
+    //Neighbors are usually close behind, so spin briefly before giving up the CPU
+    for (int spins = 0; flag.load() < value; spins++) {
+        if (spins > 100) {
+            sched_yield();
+        }
+    }
+}
+
+bool DomainRunner::waitForAll(atomic<long> Flags::* flag, long value) {
+    for (int spins = 0; ; spins++) {
+        bool all = true;
+        for (int d = 0; d < domainCount && all; d++) {
+            all = (flags[d].*flag).load() >= value;
+        }
+        if (all) {
+            return true;
+        }
+        //Now and then make sure nobody crashed, or we'd wait forever
+        if (spins % 1000 == 999) {
+            for (int pid : pids) {
+                if (waitpid(pid, nullptr, WNOHANG) != 0) {
+                    failed = true;
+                    return false;
+                }
+            }
+        }
+        usleep(spins < 1000 ? 0 : 100);
+    }
+}
+
+bool DomainRunner::waitForWork(int domain, Model& model, long t) {
+    while (true) {
+        if (*quit) {
+            return false;
+        }
+        long request = *snapshotRequest;
+        if (request > flags[domain].snapshot) {
+            int first = firstRows[domain];
+            for (int row = 1; row <= firstRows[domain + 1] - first; row++) {
+                unsigned char* out = grid + (size_t) (first + row - 1) * size;
+                for (int col = 0; col < size; col++) {
+                    Entity* thing = (*model.map)[row][col];
+                    out[col] = thing == nullptr ? EMPTY : thing->getSpecies();
+                }
+            }
+            flags[domain].snapshot = request;
+        }
+        if (*target > t) {
+            return true;
+        }
+        usleep(100);
+    }
+}
+
+void DomainRunner::writeHalo(Model& model, int row, unsigned char* out) {
+    for (int col = 0; col < size; col++) {
+        Entity* thing = (*model.map)[row][col];
+        out[col] = thing == nullptr ? EMPTY : thing->getSpecies();
+    }
+}
+
+void DomainRunner::readHalo(vector<vector<Entity*>>* map, int row, const unsigned char* in,
+                            vector<Entity*>& standIns) {
+    for (int col = 0; col < size; col++) {
+        if (in[col] != EMPTY) {
+            Entity* standIn = Model::typeTranslator((Species) in[col]);
+            (*map)[row][col] = standIn;
+            standIns.push_back(standIn);
+        }
+    }
+}
+
+void DomainRunner::writeRow(Model& model, int row, CellRecord* out) {
+    for (int col = 0; col < size; col++) {
+        Entity* thing = (*model.map)[row][col];
+        out[col].species = thing == nullptr ? EMPTY : thing->getSpecies();
+        if (thing != nullptr) {
+            thing->saveState(out[col].state);
+        }
+    }
+}
+
+void DomainRunner::writeMoved(Model& model, int row, const vector<Entity*>& before,
+                              CellRecord* out) {
+    for (int col = 0; col < size; col++) {
+        Entity* thing = (*model.map)[row][col];
+        if (thing == before[col]) {
+            out[col].species = UNCHANGED;
+        } else if (thing == nullptr) {
+            out[col].species = EMPTY;
+        } else {
+            //It moved in this tick, so the domain that owns the row gets it from now on
+            out[col].species = thing->getSpecies();
+            thing->saveState(out[col].state);
+            model.setCell(row, col, nullptr);
+            delete thing;
+        }
+    }
+}
+
+void DomainRunner::readStandIns(Model& model, int row, const CellRecord* in,
+                                vector<Entity*>& standIns, vector<Entity*>& before) {
+    for (int col = 0; col < size; col++) {
+        Entity* standIn = nullptr;
+        if (in[col].species != EMPTY) {
+            standIn = Model::typeTranslator((Species) in[col].species);
+            standIn->loadState(in[col].state);
+            standIns.push_back(standIn);
+        }
+        model.setCell(row, col, standIn);
+        before[col] = standIn;
+    }
+}
+
+void DomainRunner::readMoved(Model& model, int row, const CellRecord* in) {
+    for (int col = 0; col < size; col++) {
+        if (in[col].species == UNCHANGED) {
+            continue;
+        }
+        Entity* thing = nullptr;
+        if (in[col].species != EMPTY) {
+            thing = Model::typeTranslator((Species) in[col].species);
+            thing->loadState(in[col].state);
+            thing->setPos(row, col);
+        }
+        //Whatever was here lost the cell to the Entity from the other domain
+        Entity* lost = (*model.map)[row][col];
+        model.setCell(row, col, thing);
+        delete lost;
+    }
+}
+
+void DomainRunner::runDomain(int domain) {
+    int first = firstRows[domain];
+    int owned = firstRows[domain + 1] - first;
+    Model model(size, first, owned, counts[0], counts[1], counts[2], counts[3], counts[4]);
+
+    //Map rows: 0 is the top ghost row, 1..last are owned, last + 1 is the bottom ghost row
+    int last = owned;
+    int up = (domain + domainCount - 1) % domainCount;
+    int down = (domain + 1) % domainCount;
+    bool lastDomain = domain == domainCount - 1;
+    vector<Direction> moves((size_t) owned * size);
+    vector<Entity*> standIns;
+    vector<Entity*> topBefore;
+    vector<Entity*> bottomBefore;
+
+    for (long t = 0; waitForWork(domain, model, t); t++) {
+        //Trade border rows so every domain can fill in what its Entities see
+        writeHalo(model, 1, halo(domain, t, true));
+        writeHalo(model, last, halo(domain, t, false));
+        flags[domain].halo = t + 1;
+        waitFor(flags[up].halo, t + 1);
+        waitFor(flags[down].halo, t + 1);
+
+        model.beginTick();
+        model.map = model.nextMap;
+        readHalo(model.oldMap, 0, halo(up, t, false), standIns);
+        readHalo(model.oldMap, last + 1, halo(down, t, true), standIns);
+
+        //Deciding only reads last tick's map, so every domain does it at the same time
+        for (int row = 1; row <= last; row++) {
+            for (int col = 0; col < size; col++) {
+                if ((*model.oldMap)[row][col] != nullptr) {
+                    moves[(size_t) (row - 1) * size + col] = model.decideMove(row, col);
+                }
+            }
+        }
+
+        //Moving has to follow Model's row order, so wait for the rows above to be finished
+        topBefore.assign(size, nullptr);
+        bottomBefore.assign(size, nullptr);
+        if (domain > 0) {
+            waitFor(flags[domain - 1].forward, t + 1);
+            readStandIns(model, 0, mailbox(domain - 1, t, FORWARD_FINAL), standIns, topBefore);
+            readMoved(model, 1, mailbox(domain - 1, t, FORWARD_WRITES));
+        }
+        if (lastDomain) {
+            //Row 0 wraps around below the last row, and was finished first of all
+            waitFor(flags[0].forward, t + 1);
+            readStandIns(model, last + 1, mailbox(0, t, WRAP_FINAL), standIns, bottomBefore);
+            readMoved(model, last, mailbox(0, t, WRAP_WRITES));
+        }
+        for (int row = 1; row <= last; row++) {
+            for (int col = 0; col < size; col++) {
+                if ((*model.oldMap)[row][col] != nullptr) {
+                    model.resolveMove(row, col, moves[(size_t) (row - 1) * size + col]);
+                }
+            }
+        }
+
+        //Hand the finished border rows on, then send back what moved into the neighbors' rows
+        if (!lastDomain) {
+            writeRow(model, last, mailbox(domain, t, FORWARD_FINAL));
+            writeMoved(model, last + 1, bottomBefore, mailbox(domain, t, FORWARD_WRITES));
+        }
+        if (domain == 0) {
+            writeRow(model, 1, mailbox(domain, t, WRAP_FINAL));
+            writeMoved(model, 0, topBefore, mailbox(domain, t, WRAP_WRITES));
+        }
+        flags[domain].forward = t + 1;
+        if (domain > 0) {
+            writeMoved(model, 0, topBefore, mailbox(domain, t, BACK_UP));
+        }
+        if (lastDomain) {
+            writeMoved(model, last + 1, bottomBefore, mailbox(domain, t, BACK_DOWN));
+        }
+        flags[domain].back = t + 1;
+        if (!lastDomain) {
+            waitFor(flags[down].back, t + 1);
+            readMoved(model, last, mailbox(down, t, BACK_UP));
+        }
+        if (domain == 0) {
+            waitFor(flags[domainCount - 1].back, t + 1);
+            readMoved(model, 1, mailbox(domainCount - 1, t, BACK_DOWN));
+        }
+
+        model.commitUpdate();
+        for (int col = 0; col < size; col++) {
+            model.setCell(0, col, nullptr);
+            model.setCell(last + 1, col, nullptr);
+        }
+        for (Entity* standIn : standIns) {
+            delete standIn;
+        }
+        standIns.clear();
+        flags[domain].done = t + 1;
+    }
+}
+
+#else
+//No fork() or anonymous shared memory here, so the world can't be split up
+DomainRunner::DomainRunner(int, int, int, int, int, int, int) {
+    throw runtime_error("DomainRunner needs fork(), which this platform does not have");
+}
+
+DomainRunner::~DomainRunner() {}
+
+bool DomainRunner::update(int) {
+    return false;
+}
+
+bool DomainRunner::snapshot(vector<unsigned char>&) {
+    return false;
+}
+
+long DomainRunner::getTick() {
+    return 0;
+}
+
+int DomainRunner::getSize() {
+    return size;
+}
+
+int DomainRunner::getDomainCount() {
+    return domainCount;
+}
+#endif
@@ -0,0 +1,140 @@
+/*Sarah Allen & Joshua Lindquist
+CS132 Winter 2022
+Final Project: Simulation
+
+Class main author: Josh
+
+Header for the DomainRunner class, which runs one world split across several local processes so
+that no single process has to hold all of it. The world is cut into strips of whole rows (the
+domains) and each child process owns one strip as a Model with a ghost row above and below it.
+Every tick the processes trade the rows along their borders, and any Entities that crossed a
+border, through double-buffered mailboxes in shared memory.
+
+The result is exactly what one Model with the same seed would produce. Entities decide their moves
+(the expensive part) in parallel, since that only reads last tick's map; moves are then carried out
+strip after strip in the same row order Model uses, which is cheap. Linux/Unix only: the domains are
+fork()ed, so create the runner before starting any threads or the GUI.*/
+
+#ifndef _DOMAINRUNNER_H
+#define _DOMAINRUNNER_H
+
+#include <atomic>
+#include <vector>
+#include "Model.h"
+using namespace std;
+
+class DomainRunner {
+public:
+    //Starts domainCount processes that together hold a modelSize x modelSize world populated
+    //exactly like Model(modelSize, tigerNum, huntNum, lumbNum, treeNum, deerNum). Every domain
+    //needs at least two rows.
+    DomainRunner(int modelSize, int domainCount, int tigerNum, int huntNum, int lumbNum,
+                 int treeNum, int deerNum);
+
+    //Stops the domain processes and releases the shared memory
+    ~DomainRunner();
+
+    //Runs ticks more ticks in every domain and waits for them. Returns false if a domain process
+    //has died, after which the runner can't be used any more.
+    bool update(int ticks = 1);
+
+    //Fills grid with the Species of every cell, row by row (grid[row * size + col]). Returns false
+    //if a domain process has died.
+    bool snapshot(vector<unsigned char>& grid);
+
+    //Returns the number of ticks every domain has finished
+    long getTick();
+
+    // returns the number of columns wide / rows tall of the world
+    int getSize();
+
+    //Returns the number of domain processes
+    int getDomainCount();
+
+private:
+    //One cell of a row sent between domains: what is in it and its saveState()
+    struct CellRecord {
+        int species;   //a Species, or UNCHANGED
+        int state[Entity::STATE_SIZE];
+    };
+    static const int UNCHANGED = -1;
+
+    //Mailbox rows, written by one domain and read by its neighbors. There are two of each, and
+    //tick t uses the ones at t % 2, so a fast domain can't overwrite rows still being read.
+    enum Row {
+        FORWARD_FINAL,  //last owned row after moving, for the domain below's top ghost row
+        FORWARD_WRITES, //what moved into the bottom ghost row, the domain below's first row
+        WRAP_FINAL,     //domain 0 only: row 0 after moving, for the last domain's bottom ghost row
+        WRAP_WRITES,    //domain 0 only: what moved into row size-1 through the top ghost row
+        BACK_UP,        //changes made to the top ghost row, for the domain above
+        BACK_DOWN,      //last domain only: changes made to row 0 through the bottom ghost row
+        ROW_COUNT
+    };
+
+    //Progress flags of one domain: each holds t + 1 once that step of tick t is done
+    struct Flags {
+        atomic<long> halo;      //first and last owned row published for the next tick
+        atomic<long> forward;   //FORWARD_* (and WRAP_*) rows published
+        atomic<long> back;      //BACK_* rows published
+        atomic<long> done;      //tick finished
+        atomic<long> snapshot;  //last snapshot request written into the shared grid
+        char padding[24];       //keep each domain's flags on their own cache line
+    };
+
+    //Body of a domain process
+    void runDomain(int domain);
+
+    //Waits in a domain process until tick t may start, writing snapshots in the meantime.
+    //Returns false when the runner is shutting down.
+    bool waitForWork(int domain, Model& model, long t);
+
+    //Waits until flag reaches value (domain processes)
+    void waitFor(atomic<long>& flag, long value);
+
+    //Waits until every domain's flag reaches value (parent process). Returns false if a domain
+    //process died first.
+    bool waitForAll(atomic<long> Flags::* flag, long value);
+
+    //Returns a mailbox row written by domain for tick t
+    CellRecord* mailbox(int domain, long t, Row row);
+
+    //Returns the species of domain's first (top) or last owned row for tick t
+    unsigned char* halo(int domain, long t, bool top);
+
+    //Mailbox helpers, run inside a domain process:
+    //Writes the species of map row into a halo row
+    void writeHalo(Model& model, int row, unsigned char* out);
+    //Fills an empty ghost row with stand-in Entities of the species in a halo row
+    void readHalo(vector<vector<Entity*>>* map, int row, const unsigned char* in,
+                  vector<Entity*>& standIns);
+    //Writes every Entity of map row into out (they stay in the map)
+    void writeRow(Model& model, int row, CellRecord* out);
+    //Writes the Entities that moved into a ghost row and takes them out of the map. A cell still
+    //holding its stand-in from before is UNCHANGED.
+    void writeMoved(Model& model, int row, const vector<Entity*>& before, CellRecord* out);
+    //Fills a ghost row with stand-ins for the Entities in a row written by writeRow()
+    void readStandIns(Model& model, int row, const CellRecord* in, vector<Entity*>& standIns,
+                      vector<Entity*>& before);
+    //Puts the Entities in a row written by writeMoved() into an owned row
+    void readMoved(Model& model, int row, const CellRecord* in);
+
+    int size;
+    int domainCount;
+    vector<int> firstRows; //world row each domain starts at, plus size at the end
+    int counts[5];         //tigers, hunters, lumberjacks, trees and deer to start with
+    vector<int> pids;
+    bool failed;
+
+    //Shared memory, mapped before the domains are forked
+    char* shared;
+    size_t sharedSize;
+    atomic<long>* target;           //number of ticks the domains should run
+    atomic<long>* snapshotRequest;  //bumped to ask the domains for a snapshot
+    atomic<long>* quit;
+    Flags* flags;                   //one per domain
+    CellRecord* rows;               //domainCount * 2 * ROW_COUNT rows of size cells
+    unsigned char* halos;           //domainCount * 2 * 2 rows of size cells
+    unsigned char* grid;            //size * size cells, only touched by snapshot()
+};
+
+#endif
@@ -5,9 +5,28 @@ Final Project: Simulation
 Cpp file for Entity class*/
 
  #include "Entity.h"
+ #include <algorithm>
+ #include <cstring>
+
+atomic<long> Entity::nextId(0);
+const int Entity::SIGNATURE_BITS;
+const int Entity::SIGNATURE_COUNT;
 
 Entity::Entity() {
+    id = nextId++;
     fontSize = 9;
+    width = 1;
+    height = 1;
+    memset(nearby, 0, sizeof(nearby));
+    memset(touching, 0, sizeof(touching));
+    fill(neighborSpecies, neighborSpecies + 5, EMPTY);
+    signature = 0;
+}
+
+Entity::~Entity() {}
+
+long Entity::getId() const {
+    return id;
 }
 
 int Entity::getHeight() {
@@ -18,6 +37,11 @@ int Entity::getWidth() {
     return width;
 }
 
+void Entity::setFootprint(int width, int height) {
+    this->width = width;
+    this->height = height;
+}
+
 int Entity::getX() {
     return x;
 }
@@ -40,6 +64,11 @@ string Entity::getType() {
     return "Entity";
 }
 
+Species Entity::getSpecies() {
+    //default:
+    return ENTITY;
+}
+
 string Entity::toString() {
     //default:
     return "?";
@@ -54,11 +83,28 @@ Direction Entity::getMove() {
     return CENTER;
 }
 
+Direction Entity::getMove(const Surroundings& around) {
+    for (Direction dir : {CENTER, NORTH, EAST, SOUTH, WEST}) {
+        setNeighborSpecies(dir, around.neighbors[dir]);
+    }
+    return getMove();
+}
+
 void Entity::setNeighbor(Direction dir, const string& neighbor) {
     if (dir < 0 || dir >= DIRECTION_COUNT) {
         return;
     }
-    neighbors[dir] = neighbor;
+    //Names of Species are kept as the Species, and only other names as they are
+    Species species = neighbor == "" ? EMPTY : ENTITY;
+    for (int s = EMPTY + 1; s < SPECIES_COUNT; s++) {
+        if (neighbor == to_string((Species) s)) {
+            species = (Species) s;
+        }
+    }
+    setNeighborSpecies(dir, species);
+    if (species == ENTITY) {
+        neighbors[dir] = neighbor;
+    }
 }
 
 string Entity::getNeighbor(Direction dir) const{
@@ -66,7 +112,43 @@ string Entity::getNeighbor(Direction dir) const{
         return "";
     }
     //cout << "nebs: " << neighbors[dir] << endl;
-    return neighbors[dir];
+    if (!neighbors[dir].empty()) {
+        return neighbors[dir];
+    }
+    return neighborSpecies[dir] == EMPTY ? "" : to_string(neighborSpecies[dir]);
+}
+
+void Entity::setNeighborSpecies(Direction dir, Species species) {
+    if (dir < 0 || dir >= DIRECTION_COUNT) {
+        return;
+    }
+    neighborSpecies[dir] = species;
+    neighbors[dir].clear();
+    if (dir == CENTER) {
+        return;
+    }
+    int shift = (dir - NORTH) * SIGNATURE_BITS;
+    signature = (signature & ~(((1 << SIGNATURE_BITS) - 1) << shift)) | (species << shift);
+}
+
+int Entity::getSignature() const {
+    return signature;
+}
+
+void Entity::setSurroundings(const unsigned char* counts, const unsigned char* touching) {
+    //Perception fills SPECIES_COUNT bytes of each, which is SPECIES_LIMIT
+    static_assert(sizeof(nearby) == SPECIES_LIMIT, "one byte per Species");
+    static_assert(sizeof(Surroundings::touching) == SPECIES_LIMIT, "one byte per Species");
+    memcpy(nearby, counts, sizeof(nearby));
+    memcpy(this->touching, touching, sizeof(this->touching));
+}
+
+int Entity::countNearby(Species species) const {
+    return nearby[species];
+}
+
+int Entity::getTouching(Species species) const {
+    return touching[species];
 }
 
 int Entity::getFont() const {
@@ -82,3 +164,11 @@ void Entity::onWin() const {}
 
 void Entity::onMate() const {}
 
+void Entity::saveState(int* state) const {
+    //default: nothing to remember
+    for (int i = 0; i < STATE_SIZE; i++) {
+        state[i] = 0;
+    }
+}
+
+void Entity::loadState(const int*) {}
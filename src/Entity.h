@@ -10,17 +10,33 @@ vectors in model, and allows the model to interact with all of its data.*/
 #ifndef _ENTITY_H
 #define _ENTITY_H
 
+#include <atomic>
 #include <iostream>
 #include <vector>
 
 #include "entitytypes.h"
 using namespace std;
 
+//Everything an Entity is shown when it decides its move. The Model fills one in on the stack
+//for each Entity, so deciding needs no strings and no allocations.
+struct Surroundings {
+    Species neighbors[5];          //by Direction; CENTER is the Entity's own Species
+    int signature;                 //NORTH to WEST packed, see Entity::getSignature()
+    const unsigned char* counts;   //see Entity::setSurroundings(), nullptr without a stencil
+    unsigned char touching[SPECIES_LIMIT];
+};
+
 class Entity {
 public:
     //Constructor
     Entity();
 
+    //Destructor, virtual so deleting any kind of Entity through an Entity* is safe
+    virtual ~Entity();
+
+    //Returns the id this Entity was given when it was made, unique within the run
+    long getId() const;
+
     //Returns object's height
     virtual int getHeight();
 
@@ -30,6 +46,10 @@ public:
     //Returns object's width
     virtual int getWidth();
 
+    //Sets how many cells the Entity covers: width rows and height columns, starting at its own
+    //cell. The Model decides this when it places the Entity; every Entity starts out 1 by 1.
+    void setFootprint(int width, int height);
+
     //Returns object's X position
     virtual int getX();
 
@@ -42,6 +62,9 @@ public:
     //Returns the name of what type of entity the object is
     virtual string getType();
 
+    //Returns the same kind as getType(), as a Species id
+    virtual Species getSpecies();
+
     //Returns the visual representation of the entity
     virtual string toString();
 
@@ -51,12 +74,41 @@ public:
     //Default move of CENTER
     virtual Direction getMove();
 
-    //Function that allows Model class to feed the Entity what its neighbor is
+    //Returns the move given what is around the Entity. This is what the Model calls, after
+    //setSurroundings(). By default it passes around on to setNeighborSpecies() and then calls
+    //getMove(), which can still ask getNeighbor(); Entities that decide from around directly
+    //override it instead and skip all of that.
+    virtual Direction getMove(const Surroundings& around);
+
+    //Tells the Entity what its neighbor is by name, for older Entities. The Model itself only
+    //calls setNeighborSpecies(), and getNeighbor() turns that back into a name when asked.
     virtual void setNeighbor(Direction dir, const string& neighbor);
 
+    //Lets the Model tell the Entity the Species of its neighbor in dir, without any strings
+    void setNeighborSpecies(Direction dir, Species species);
+
+    //Returns the Species to the NORTH, EAST, SOUTH and WEST packed into one number,
+    //SIGNATURE_BITS bits each from the lowest bits up, for looking moves up in a table
+    int getSignature() const;
+
+    static const int SIGNATURE_BITS = 3;
+    static const int SIGNATURE_COUNT = 1 << (4 * SIGNATURE_BITS);
+
     //Gets neighbor
     //virtual string getNeighbor(Direction dir/* , int x, int y */) const;
 
+    //Lets the Model tell the Entity what its perception stencil sees (see Model::setPerception),
+    //SPECIES_COUNT bytes each: counts is how many cells of the stencil hold each Species, and
+    //touching is which of the eight cells around it hold each Species, one bit per cell going
+    //clockwise from NORTH. Only called when the Model has a stencil.
+    virtual void setSurroundings(const unsigned char* counts, const unsigned char* touching);
+
+    //Returns how many cells of the perception stencil held species when the Entity last looked
+    int countNearby(Species species) const;
+
+    //Returns which of the eight cells around the Entity held species, see setSurroundings()
+    int getTouching(Species species) const;
+
     virtual void setPos(int x, int y);
 
     //Gets object's display font size
@@ -71,13 +123,29 @@ public:
     //Allows entities to use a specific behavior after mating when cast as Entity
     virtual void onMate() const;
 
+    //Number of ints saveState() writes and loadState() reads
+    static const int STATE_SIZE = 6;
+
+    //Copies the Entity's behavior state (step counters, directions, ...) into state, so that an
+    //identical Entity can be made somewhere else with loadState()
+    virtual void saveState(int* state) const;
+
+    //Restores the behavior state written by saveState()
+    virtual void loadState(const int* state);
+
 private:
+    static atomic<long> nextId;
+    long id;
     int height;
     int width;
     int x;
     int y;
     bool child;
-    string neighbors[5];
+    Species neighborSpecies[5];  //by Direction, from setNeighborSpecies()
+    string neighbors[5];         //names setNeighbor() was given that aren't a Species
+    int signature;               //see getSignature()
+    unsigned char nearby[SPECIES_LIMIT];     //by Species, from setSurroundings()
+    unsigned char touching[SPECIES_LIMIT];
     int fontSize;
 };
 
@@ -0,0 +1,171 @@
+/*Joshua Lindquist & Sarah Allen
+CS132 Winter 2022
+Final Project: Simulation
+
+Cpp file for the EventStream class*/
+
+#include "EventStream.h"
+#include "Metrics.h"
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+
+std::string to_string(EventType type) {
+    switch (type) {
+        case EVENT_BIRTH: return "birth";
+        case EVENT_FIGHT: return "fight";
+        case EVENT_BUILD: return "build";
+        default:          return "unknown";
+    }
+}
+int EVENT_TYPE_COUNT = 3;
+
+EventStream* EventStream::_instance = nullptr;
+atomic<bool> EventStream::_active(false);
+const int EventStream::IDLE_MS;
+
+EventStream::Ring::Ring() : events(RING_SIZE), overflow(0) {}
+
+EventStream::EventStream() : nextId(0), running(false), delivered(0) {}
+
+EventStream* EventStream::instance() {
+    if (!_instance) {
+        _instance = new EventStream();
+        Metrics* metrics = Metrics::instance();
+        metrics->addGauge("sim_events_delivered", "Interaction events handed to subscribers.", [] {
+            return (double) _instance->getDelivered();
+        });
+        metrics->addGauge("sim_events_dropped", "Interaction events dropped because subscribers fell behind.", [] {
+            return (double) _instance->getOverflow();
+        });
+    }
+    return _instance;
+}
+
+EventStream::Ring* EventStream::local() {
+    //The registry keeps a reference too, so Events from a finished thread still get delivered
+    thread_local Ring* ring = nullptr;
+    if (!ring) {
+        shared_ptr<Ring> made = make_shared<Ring>();
+        EventStream* stream = instance();
+        lock_guard<mutex> lock(stream->ringMutex);
+        stream->rings.push_back(made);
+        ring = made.get();
+    }
+    return ring;
+}
+
+int EventStream::subscribe(function<void(const Event&)> handler) {
+    lock_guard<mutex> lock(subscriberMutex);
+    int id = nextId++;
+    subscribers.push_back(make_pair(id, handler));
+    if (!running) {
+        running = true;
+        dispatcher = thread(&EventStream::dispatch, this);
+        static bool registered = false;
+        if (!registered) {
+            registered = true;
+            atexit([] {
+                instance()->stop();
+            });
+        }
+    }
+    _active = true;
+    return id;
+}
+
+void EventStream::unsubscribe(int id) {
+    lock_guard<mutex> lock(subscriberMutex);
+    for (size_t i = 0; i < subscribers.size(); i++) {
+        if (subscribers[i].first == id) {
+            subscribers.erase(subscribers.begin() + i);
+            break;
+        }
+    }
+    _active = !subscribers.empty();
+}
+
+bool EventStream::writeCsv(const string& path) {
+    shared_ptr<ofstream> file = make_shared<ofstream>(path);
+    if (!file->good()) {
+        return false;
+    }
+    writeCsvHeader(*file);
+    subscribe([file](const Event& event) {
+        writeCsvLine(*file, event);
+    });
+    return true;
+}
+
+void EventStream::writeCsvHeader(ostream& out) {
+    out << "tick,type,species,other_species,actor,other,result,x,y,attack,other_attack" << endl;
+}
+
+void EventStream::writeCsvLine(ostream& out, const Event& event) {
+    out << event.tick << "," << to_string(event.type) << "," << to_string(event.species) << ","
+        << to_string(event.otherSpecies) << "," << event.actor << "," << event.other << ","
+        << event.result << "," << event.x << "," << event.y;
+    if (event.type == EVENT_FIGHT) {
+        out << "," << to_string(event.attack) << "," << to_string(event.otherAttack);
+    } else {
+        out << ",,";
+    }
+    out << "\n";
+}
+
+long long EventStream::getDelivered() {
+    return delivered;
+}
+
+long long EventStream::getOverflow() {
+    lock_guard<mutex> lock(ringMutex);
+    long long total = 0;
+    for (shared_ptr<Ring>& ring : rings) {
+        total += ring->overflow.load(memory_order_relaxed);
+    }
+    return total;
+}
+
+void EventStream::stop() {
+    {
+        lock_guard<mutex> lock(subscriberMutex);
+        if (!running) {
+            return;
+        }
+        running = false;
+        _active = false;
+    }
+    dispatcher.join();
+}
+
+void EventStream::dispatch() {
+    while (running) {
+        if (!deliver()) {
+            this_thread::sleep_for(chrono::milliseconds(IDLE_MS));
+        }
+    }
+    //Whatever was emitted before stop()
+    deliver();
+}
+
+bool EventStream::deliver() {
+    vector<shared_ptr<Ring>> current;
+    {
+        lock_guard<mutex> lock(ringMutex);
+        current = rings;
+    }
+    lock_guard<mutex> lock(subscriberMutex);
+    long long count = 0;
+    Event event;
+    for (shared_ptr<Ring>& ring : current) {
+        //Only take what is there now, so one busy thread can't keep the others waiting
+        for (size_t n = ring->events.size(); n > 0 && ring->events.pop(event); n--) {
+            for (auto& subscriber : subscribers) {
+                subscriber.second(event);
+            }
+            count++;
+        }
+    }
+    delivered += count;
+    return count > 0;
+}
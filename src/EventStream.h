@@ -0,0 +1,132 @@
+/*Sarah Allen & Joshua Lindquist
+CS132 Winter 2022
+Final Project: Simulation
+
+Class main author: Josh
+
+Header for the EventStream class, which carries what happens between Entities (births, fights
+and trees turned into Buildings) from the Model to anything that wants to know: overlays,
+recorders, metrics. The Model emit()s fixed-size Event records into a lock-free ring owned by the
+calling thread, and a dispatcher thread hands them to every subscriber. Emitting never waits: if a
+ring is full because the subscribers are slow, the Event is dropped and counted instead. Nothing is
+emitted at all until something subscribes.*/
+
+#ifndef _EVENTSTREAM_H
+#define _EVENTSTREAM_H
+
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "entitytypes.h"
+#include "SpscQueue.h"
+using namespace std;
+
+//The kinds of Event
+enum EventType {
+    EVENT_BIRTH,  //actor mated with other and result was born at (x, y)
+    EVENT_FIGHT,  //actor moved onto other at (x, y) and they fought; result won
+    EVENT_BUILD   //actor fought the tree other at (x, y), which became result, a Building
+};
+std::string to_string(EventType type);
+extern int EVENT_TYPE_COUNT;
+
+//One interaction. Entities are given by getId().
+struct Event {
+    long tick;           //the tick the Event happened in, as getTick() will show once it's done
+    EventType type;
+    Species species;     //the actor's species, or the baby's for a birth
+    Species otherSpecies;  //the other's species
+    long actor;
+    long other;
+    long result;
+    int x;               //world row and column it happened at
+    int y;
+    Attack attack;       //fights: the actor's weapon
+    Attack otherAttack;  //fights: the other's weapon
+};
+
+class EventStream {
+public:
+    //Returns the single EventStream object for this process, creating it if needed
+    static EventStream* instance();
+
+    //Hands event to the subscribers, if there are any. Never waits; see getOverflow().
+    static void emit(const Event& event);
+
+    //Calls handler with every Event from now on, on the dispatcher thread, and returns an id
+    //for unsubscribe(). Handlers run one after another, so a slow one delays the others (but
+    //never the Model).
+    int subscribe(function<void(const Event&)> handler);
+
+    //Stops calling the handler subscribe() returned id for. Don't call it from a handler.
+    void unsubscribe(int id);
+
+    //Appends every Event as a CSV line to the file at path until the program exits. Returns
+    //false if the file can't be written.
+    bool writeCsv(const string& path);
+
+    //Writes the header line and the line for one Event of the CSV writeCsv() makes
+    static void writeCsvHeader(ostream& out);
+    static void writeCsvLine(ostream& out, const Event& event);
+
+    //Returns how many Events were handed to subscribers so far
+    long long getDelivered();
+
+    //Returns how many Events were dropped because a ring was full
+    long long getOverflow();
+
+    //Delivers what is still queued and stops the dispatcher thread
+    void stop();
+
+private:
+    EventStream();
+
+    //One emitting thread's ring. Only that thread pushes and counts overflow.
+    struct Ring {
+        SpscQueue<Event> events;
+        atomic<long long> overflow;
+        Ring();
+    };
+
+    static const int RING_SIZE = 1 << 14;  //Events each thread can have waiting
+    static const int IDLE_MS = 1;          //how long the dispatcher sleeps when all rings are empty
+
+    //Returns the calling thread's ring, registering it on first use
+    static Ring* local();
+
+    //Body of the dispatcher thread
+    void dispatch();
+
+    //Hands every queued Event to the subscribers. Returns false if there were none.
+    bool deliver();
+
+    static EventStream* _instance;
+    static atomic<bool> _active;   //true while anything is subscribed
+
+    mutex ringMutex;
+    vector<shared_ptr<Ring>> rings;
+    mutex subscriberMutex;
+    vector<pair<int, function<void(const Event&)>>> subscribers;
+    int nextId;
+    thread dispatcher;
+    atomic<bool> running;
+    atomic<long long> delivered;
+};
+
+inline void EventStream::emit(const Event& event) {
+    if (!_active.load(memory_order_relaxed)) {
+        return;
+    }
+    Ring* ring = local();
+    if (!ring->events.push(event)) {
+        //Only this thread writes the counter, so a plain load and store is enough
+        ring->overflow.store(ring->overflow.load(memory_order_relaxed) + 1, memory_order_relaxed);
+    }
+}
+
+#endif
@@ -7,6 +7,9 @@ Cpp file for the Gui class*/
 #include <iostream>
 #include <fstream>
 #include "Gui.h"
+#include "SaveLoader.h"
+#include "gconsolewindow.h"
+#include "geventqueue.h"
 
 
 using namespace std;
@@ -14,6 +17,8 @@ using namespace std;
 Gui::Gui(int windowSize, int squareSize, int tigerNum, int huntNum, int lumbNum, int treeNum, int deerNum) {
     this->windowSize = windowSize;
     this->squareSize = squareSize;
+    frames = nullptr;
+    focus[2] = 0;
 
     // creates the initial version of our model
     model = new Model(windowSize / squareSize, tigerNum, huntNum, lumbNum, treeNum, deerNum);
@@ -36,42 +41,106 @@ Gui::Gui(int windowSize, int squareSize, int tigerNum, int huntNum, int lumbNum,
     this->load();
     });
     window->addToRegion(loadB, GWindow::Region::REGION_SOUTH);
+    //Population chart, one line per kind of Entity in the Entity's own color:
+    chart = new PopulationChart(CHART_WIDTH, windowSize);
+    chartSpecies = {BUILDING, DEER, HUNTER, LUMBERJACK, TIGER, TREE};
+    for (Species species : chartSpecies) {
+        Entity* sample = Model::typeTranslator(species);
+        chart->addSeries(sample->getColor());
+        delete sample;
+    }
+    window->addToRegion(chart->getCanvas(), GWindow::Region::REGION_EAST);
+    window->pack();
+    renderer = new MapRenderer(window->getCanvas(), model->getSize(), squareSize);
     
+    // library queues the metrics can report on, read only when they are scraped
+    Metrics* metrics = Metrics::instance();
+    metrics->addGauge("gui_event_queue_depth", "Events waiting in the GEventQueue.", [] {
+        return (double) GEventQueue::instance()->getEventQueueSize();
+    });
+    metrics->addGauge("gui_function_queue_depth", "Functions waiting to run on the Qt GUI thread.", [] {
+        return (double) GEventQueue::instance()->getFunctionQueueSize();
+    });
+    metrics->addGauge("console_pending_output_chars", "Console output not yet shown.", [] {
+        if (!GConsoleWindow::isInitialized()) {
+            return 0.0;
+        }
+        return (double) GConsoleWindow::instance()->getPendingOutputSize();
+    });
+    metrics->addGauge("model_unplaced_entities", "Entities lost for want of a free cell around coarse blocks.", [this] {
+        return (double) model->getUnplaced();
+    });
+
     // draw the critters at their initial positions
     draw();
+    chartPopulation();
 
-    // sets it so the redraw function will be called every 2 seconds. 
-     window->setTimerListener(2000, [this] {
-        this->update();
+    // sets it so the update function will be called every frame. It only starts
+    // a new tick every TICK_DELAY milliseconds, but keeps working on a tick that
+    // did not fit into the last frame.
+    lastTick = GEvent::getCurrentTimeMS();
+    window->setTimerListener(FRAME_DELAY, [this](GEvent event) {
+        this->update(event.getTime());
     });
 }
 
 void Gui::draw() {
-    // clear off the screen and draw the updated contents of the model
-    window->clearCanvasPixels();
-    window->setFillColor("#00DDAA");
-    window->drawRect(0, 0, windowSize, windowSize);
-    window->fillRect(0, 0, windowSize, windowSize);
-    for(int row = 0; row < model->getSize(); row++) {
-        for(int col = 0; col < model->getSize(); col++) {
-            Entity* thing = model->getEntity(row, col);
-            //Ignore nullptr non-entities
-            if(thing != nullptr) {
-               string name = thing->toString();
-               int fontSize = thing->getFont();
-               string font = "Arial-" + to_string(fontSize) + "-bold";
-               window->setColor(thing->getColor());
-               window->setFont(font);
-               window->drawString(name, row * squareSize, col * squareSize);
-            }
-        }
+    //Only the parts of the map that changed are redrawn, see MapRenderer
+    renderer->draw(model);
+}
+
+void Gui::update(long now) {
+    if (!model->isUpdating() && now - lastTick < TICK_DELAY) {
+        return;
+    }
+    //Call the model to update part of the grid, and only redraw a finished tick
+    if (model->stepUpdate(FRAME_BUDGET)) {
+        lastTick = now;
+        draw();
+        chartPopulation();
+        publishFrame();
     }
 }
 
-void Gui::update() {
-    //Call the model to update the grid
-    model->update();
-    draw();
+void Gui::chartPopulation() {
+    vector<double> values;
+    for (Species species : chartSpecies) {
+        values.push_back(model->getPopulation(species));
+    }
+    chart->addPoint(values);
+    chart->draw();
+}
+
+void Gui::setFocus(int row, int col, int rows, int cols) {
+    focus[0] = row;
+    focus[1] = col;
+    focus[2] = rows;
+    focus[3] = cols;
+    model->setFocus(row, col, rows, cols);
+}
+
+void Gui::publishFrames(string path) {
+    framesPath = path;
+    publishFrame();
+}
+
+void Gui::publishFrame() {
+    if (framesPath == "") {
+        return;
+    }
+    if (frames != nullptr && frames->getSize() != model->getSize()) {
+        delete frames;
+        frames = nullptr;
+    }
+    if (frames == nullptr) {
+        frames = SharedFrames::create(framesPath, model->getSize());
+        if (frames == nullptr) {
+            cout << "Could not publish frames to " << framesPath << endl;
+            framesPath = "";
+            return;
+        }
+    }
+    frames->publish(model);
 }
 
 string Gui::getFileName() {
@@ -112,53 +181,40 @@ void Gui::save() {
 }
 
 void Gui::load() {
-    ifstream loadFile;
     string load = getFileName();
-    loadFile.open(load);
-    bool goodFile = loadFile.good(); //Check for existing file
-    while (!goodFile) {
+    SaveLoader* loader = new SaveLoader(load);
+    while (!loader->isOpen()) { //Check for existing file
         cout << "Sorry, that file does not exist. Please try again." << endl;
-        loadFile.close();
+        delete loader;
         load = getFileName(); //Get a new file name
-        loadFile.open(load);
-        goodFile = loadFile.good();
+        loader = new SaveLoader(load);
     }
     //Use file info to create new model grid
-    loadFile >> windowSize;
-    loadFile >> squareSize;
+    windowSize = loader->getWindowSize();
+    squareSize = loader->getSquareSize();
+    int size = loader->getSize();
+    vector<unsigned char> grid;
+    loader->parse(grid);
+    delete loader;
 
-    //Create new (empty) Model
-    model = new Model(windowSize / squareSize, 0, 0, 0, 0, 0);
+    //Create new (empty) Model, and a renderer for its size
+    model = new Model(size, 0, 0, 0, 0, 0);
+    delete renderer;
+    renderer = new MapRenderer(window->getCanvas(), size, squareSize);
+    window->clearCanvasPixels();
     //Fill the Model:
-    for (int i = 0; i < windowSize / squareSize; i++) {
-        for (int j = 0; j < windowSize / squareSize; j++) {
-            string next;
-            loadFile >> next;
-
-            //Depending on next input, create an entity to place in (*map)[i][j]
-            if (next == ".," || next == "{.," || next == ".}") {
-                model->placeEntity(i, j, nullptr);
-            } else if (next == "Building," || next == "{Building," || next == "Building}") {
-                Entity* added = new Building;
-                model->placeEntity(i, j, added);
-            } else if (next == "Deer," || next == "{Deer," || next == "Deer}") {
-                Entity* added = new Deer;
-                model->placeEntity(i, j, added);
-            } else if (next == "Hunter," || next == "{Hunter," || next == "Hunter}") {
-                Entity* added = new Hunter;
-                model->placeEntity(i, j, added);
-            } else if (next == "Lumberjack," || next == "{Lumberjack," || next == "Lumberjack}") {
-                Entity* added = new Lumberjack;
-                model->placeEntity(i, j, added);
-            } else if (next == "Tiger," || next == "{Tiger," || next == "Tiger}") {
-                Entity* added = new Tiger;
-                model->placeEntity(i, j, added);
-            } else if (next == "Tree," || next == "{Tree," || next == "Tree}") {
-                Entity* added = new Tree;
-                model->placeEntity(i, j, added);
-            }
+    for (int i = 0; i < size; i++) {
+        for (int j = 0; j < size; j++) {
+            Species species = (Species) grid[(size_t) i * size + j];
+            model->placeEntity(i, j, species == EMPTY ? nullptr : Model::typeTranslator(species));
         }
     }
-    loadFile.close();
+    if (focus[2] > 0) {
+        model->setFocus(focus[0], focus[1], focus[2], focus[3]);
+    }
     draw();
+    //The old world's history doesn't belong to this one
+    chart->reset();
+    chartPopulation();
+    publishFrame();
 }
\ No newline at end of file
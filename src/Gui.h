@@ -10,7 +10,10 @@ class feeds it, and can also load to/save from separate files.*/
 #ifndef _GUI_H
 #define _GUI_H
 
+#include "MapRenderer.h"
 #include "Model.h"
+#include "PopulationChart.h"
+#include "SharedFrames.h"
 #include "gwindow.h"
 #include "gbutton.h"
 #include "gcontainer.h"
@@ -27,6 +30,25 @@ private:
     int squareSize;
     GButton* saveB;
     GButton* loadB;
+    long lastTick;         //time of the timer event that committed the last tick, in ms
+    string framesPath;     //where frames are published for Viewers, empty for nowhere
+    SharedFrames* frames;  //nullptr unless publishing
+    MapRenderer* renderer;         //draws the map onto the window's canvas
+    PopulationChart* chart;        //populations over time, beside the map
+    vector<Species> chartSpecies;  //Species of each series of the chart
+    int focus[4];  //row, col, rows and cols of the Model's focus window, no rows for none
+
+    //Adds the model's current population of each charted Species to the chart and redraws it
+    void chartPopulation();
+
+    //Publishes the model's current state for Viewers, remaking the frame file if the world
+    //changed size (after a load)
+    void publishFrame();
+
+    static const int TICK_DELAY = 2000;  //milliseconds between simulation ticks
+    static const int FRAME_DELAY = 33;   //milliseconds between timer calls (about 30 fps)
+    static const int FRAME_BUDGET = 15;  //milliseconds of simulation allowed per timer call
+    static const int CHART_WIDTH = 300;  //pixels
 
     //Helper function to obtain and return a file name from the user.
     string getFileName();
@@ -38,8 +60,19 @@ public:
     //Draws the vector of vectors of Entities from the Model object
     void draw();
 
-    //Calls for the Model object to update itself, then redraws the changes
-    void update();
+    //Calls for the Model object to update itself, then redraws the changes. Large worlds are
+    //updated a slice at a time so the window stays responsive; the map is only redrawn once the
+    //whole tick has been committed. now is the time of the timer event, in ms, so a replayed
+    //recording (see GEventQueue::replay()) ticks when it did, however fast it is replayed.
+    void update(long now);
+
+    //Starts publishing every committed tick to the frame file at path, so Viewers in other
+    //processes can watch this simulation.
+    void publishFrames(string path);
+
+    //Only simulates Entities in the rows by cols window at (row, col); the rest of the world
+    //is kept as counts (see Model::setFocus()). Carries over to loaded worlds.
+    void setFocus(int row, int col, int rows, int cols);
 
     //Save the state of the model and its parameters to a separate file for later use.
     void save();
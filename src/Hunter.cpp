@@ -9,7 +9,7 @@ Cpp file for the Hunter class*/
 #include "Hunter.h"
 
 Hunter::Hunter() {
-    currentDir = 0;
+    memory = Behavior::start();
     foodCount = 0;
 }
 
@@ -25,6 +25,10 @@ string Hunter::getType() {
     return "Hunter";
 }
 
+Species Hunter::getSpecies() {
+    return HUNTER;
+}
+
 string Hunter::toString() {
    
     //return "\xF0\x9F\xA7\x98"; //humanoid
@@ -37,32 +41,28 @@ string Hunter::getColor() {
 }
 
 Direction Hunter::getMove() {
-    vector<Direction> dirs {NORTH, SOUTH, WEST, EAST};
-    vector<Direction> opposite {SOUTH, NORTH, EAST, WEST};
-    //Persistance hunt deer
-    for (int i = 0; i < dirs.size(); i++) {
-        if (getNeighbor(dirs[i]) == "Deer") {
-            return dirs[i];
-        }
-    }
-    //Don't hit trees or houses
-    for (int i = 0; i < dirs.size(); i++) {
-        if (getNeighbor(dirs[i]) == "Tree" || getNeighbor(dirs[i]) == "Building") {
-            int chance = rand() % 2;
-            if (chance == 0) {
-                return dirs[(i+1) % 4];
-            } else {
-                return dirs[(i-1) % 4];
-            }
-        }
-    }
-    //potentially add home zone with ifs:
-    //if (getX() > HOME_BOUND && getX() < HOME_BOUND2 && getY() < BLAH && getY() > BLAB) {
-    int random = rand() % 4;
-    currentDir = random;
-    return dirs[random];
-    //} else {
-        //return opposite[currentDir];
-    //}
+    Branch branch;
+    return Behavior::forSpecies(HUNTER)->move(getSignature(), memory, branch);
+}
+
+Direction Hunter::getMove(const Surroundings& around) {
+    Branch branch;
+    return Behavior::forSpecies(HUNTER)->move(around.signature, memory, branch);
+}
+
+void Hunter::saveState(int* state) const {
+    Entity::saveState(state);
+    state[0] = memory.heading;
+    state[1] = foodCount;
+    state[2] = memory.steps;
+    state[3] = memory.flee;
+    state[4] = memory.rest;
+}
 
+void Hunter::loadState(const int* state) {
+    memory.heading = (Direction) state[0];
+    foodCount = state[1];
+    memory.steps = state[2];
+    memory.flee = state[3];
+    memory.rest = state[4];
 }
@@ -11,6 +11,7 @@ to fight the animals in order to gain food.*/
 #define _HUNTER_H
 
 #include "Creature.h"
+#include "Behavior.h"
 
 class Hunter : public Creature {
 public:
@@ -19,22 +20,34 @@ public:
 
     virtual void onWin();
 
-    //Searches for prey (Animals), returns to building to sleep
+    //Searches for prey (Animals), returns to building to sleep, following the Hunter Behavior
     virtual Direction getMove();
 
+    //The same, from what the Model shows it, without going through getNeighbor()
+    virtual Direction getMove(const Surroundings& around);
+
     //Always returns STAB, to kill Tigers
     virtual Attack fight() const;
 
     //Returns "Hunter"
     virtual string getType();
 
+    //Returns HUNTER
+    virtual Species getSpecies();
+
     //Returns image of bow using a UTC-8 hex code, to represent the concept of hunting
     virtual string toString();
 
     //Returns display color of the hunter
     virtual string getColor();
+    //Copies the Hunter's heading, foodCount, wander steps, flee and rest into state
+    virtual void saveState(int* state) const;
+
+    //Restores what saveState() wrote
+    virtual void loadState(const int* state);
+
 private: 
-    int currentDir;
+    BehaviorMemory memory;
     int foodCount;
 };
 
@@ -8,33 +8,25 @@ Cpp file for the Lumberjack class*/
 
 Lumberjack::Lumberjack() {
     woodCount = 0;
+    memory = Behavior::start();
 }
 
 Direction Lumberjack::getMove() {
-    vector<Direction> dirs {NORTH, SOUTH, WEST, EAST};
-
-    //Get! Those! Trees! but not the houses
-    for (int i = 0; i < dirs.size(); i++) {
-        if (getNeighbor(dirs[i]) == "Tree") {
-            woodCount++;
-            return dirs[i];
-        } else if (getNeighbor(dirs[i]) == "Building") {
-            int chance = rand() % 2;
-            if (chance == 0) {
-                return dirs[(i+1) % 4];
-            } else {
-                return dirs[(i-1) % 4];
-            }
-        }
+    return follow(getSignature());
+}
+
+Direction Lumberjack::getMove(const Surroundings& around) {
+    return follow(around.signature);
+}
+
+Direction Lumberjack::follow(int signature) {
+    Branch branch;
+    Direction dir = Behavior::forSpecies(LUMBERJACK)->move(signature, memory, branch);
+    //Get! Those! Trees!
+    if (branch == BRANCH_TARGET) {
+        woodCount++;
     }
-    //potentially add home zone with ifs:
-    //if (getX() > HOME_BOUND && getX() < HOME_BOUND2 && getY() < BLAH && getY() > BLAB) {
-    int random = rand() % 4;
-    //int currentDir = random;
-    return dirs[random];
-    //} else {
-        //return opposite[currentDir];
-    //}
+    return dir;
 }
 
 Attack Lumberjack::fight() const{
@@ -45,6 +37,10 @@ string Lumberjack::getType() {
     return "Lumberjack";
 }
 
+Species Lumberjack::getSpecies() {
+    return LUMBERJACK;
+}
+
 string Lumberjack::toString() {
   //return "\xF0\x9F\xA7\x8D"; //humanoid
   return "\xF0\x9F\xAA\x93"; //axe
@@ -52,4 +48,21 @@ string Lumberjack::toString() {
 
 string Lumberjack::getColor() {
     return "blue";
-}
\ No newline at end of file
+}
+
+void Lumberjack::saveState(int* state) const {
+    Entity::saveState(state);
+    state[0] = woodCount;
+    state[1] = memory.heading;
+    state[2] = memory.steps;
+    state[3] = memory.flee;
+    state[4] = memory.rest;
+}
+
+void Lumberjack::loadState(const int* state) {
+    woodCount = state[0];
+    memory.heading = (Direction) state[1];
+    memory.steps = state[2];
+    memory.flee = state[3];
+    memory.rest = state[4];
+}
@@ -10,6 +10,7 @@ Header file for Lumberjack class. Lumberjacks have the ability to harvest wood a
 #define _LUMBERJACK_H
 
 #include "Creature.h"
+#include "Behavior.h"
 
 class Lumberjack : public Creature {
 public:    
@@ -18,15 +19,21 @@ public:
 
     //virtual void getWood();
 
-    //Searches for trees, returns to a building to sleep
+    //Searches for trees, returns to a building to sleep, following the Lumberjack Behavior
     virtual Direction getMove();
 
+    //The same, from what the Model shows it, without going through getNeighbor()
+    virtual Direction getMove(const Surroundings& around);
+
     //Always returns CHOP, to cut down trees
     virtual Attack fight() const;
 
     //Returns "Lumberjack"
     virtual string getType();
 
+    //Returns LUMBERJACK
+    virtual Species getSpecies();
+
     //Returns image of axe using a UTC-8 hex code, to represent the concept of woodcutting
     virtual string toString();
 
@@ -36,8 +43,18 @@ public:
     //This is how the Lumberjack builds houses.
     //virtual Entity* buildHouse();
 
+    //Copies the Lumberjack's woodCount, heading, wander steps, flee and rest into state
+    virtual void saveState(int* state) const;
+
+    //Restores what saveState() wrote
+    virtual void loadState(const int* state);
+
 private:
+    //Follows the Lumberjack Behavior for neighbors packed into signature, counting wood
+    Direction follow(int signature);
+
     int woodCount;
+    BehaviorMemory memory;
 };
 
 #endif
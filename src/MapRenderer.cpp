@@ -0,0 +1,271 @@
+/*Joshua Lindquist & Sarah Allen
+CS132 Winter 2022
+Final Project: Simulation
+
+Cpp file for the MapRenderer class*/
+
+#include "MapRenderer.h"
+#include <algorithm>
+
+const int MapRenderer::TILE;
+const unsigned int MapRenderer::BACKGROUND;
+
+//Rounds a / b down, even when a is negative
+static int floorDiv(int a, int b) {
+    return a >= 0 ? a / b : -((-a + b - 1) / b);
+}
+
+MapRenderer::MapRenderer(GCanvas* canvas, int size, int squareSize, int threads) {
+    this->canvas = canvas;
+    this->size = size;
+    this->squareSize = squareSize;
+    width = size * squareSize;
+    height = size * squareSize;
+    tilesAcross = (width + TILE - 1) / TILE;
+    tilesDown = (height + TILE - 1) / TILE;
+    cells.assign((size_t) size * size, EMPTY);
+    //Nothing has been drawn, so every cell counts as changed the first time
+    drawnCells.assign(cells.size(), 255);
+    frame.assign((size_t) width * height, BACKGROUND);
+    tileDrawn.assign(tilesAcross * tilesDown, 0);
+    drawnTiles = 0;
+    makeSprites();
+
+    if (threads <= 0) {
+        threads = thread::hardware_concurrency();
+    }
+    job = nullptr;
+    jobCount = 0;
+    nextJob = 0;
+    generation = 0;
+    busy = 0;
+    stopping = false;
+    //The thread calling draw() does its share too
+    for (int i = 1; i < threads; i++) {
+        workers.push_back(thread(&MapRenderer::work, this));
+    }
+}
+
+MapRenderer::~MapRenderer() {
+    {
+        lock_guard<mutex> lock(poolMutex);
+        stopping = true;
+    }
+    wake.notify_all();
+    for (thread& worker : workers) {
+        worker.join();
+    }
+}
+
+void MapRenderer::makeSprites() {
+    sprites.assign(SPECIES_COUNT, Sprite {0, 0, 0, 0, vector<unsigned int>()});
+    reachLeft = 0;
+    reachRight = squareSize;
+    reachUp = 0;
+    reachDown = squareSize;
+    for (int s = EMPTY + 1; s < SPECIES_COUNT; s++) {
+        Entity* sample = Model::typeTranslator((Species) s);
+        if (sample == nullptr) {
+            continue;
+        }
+        //Drawn the same way Gui::draw() used to, onto a clear canvas big enough for the glyph to
+        //spill out of its square on any side
+        int fontSize = sample->getFont();
+        int span = squareSize + 2 * fontSize;
+        GCanvas scratch(2 * span, 2 * span, "#00000000");
+        scratch.setColor(sample->getColor());
+        scratch.setFont("Arial-" + to_string(fontSize) + "-bold");
+        scratch.drawString(sample->toString(), span, span);
+        vector<vector<int>> pixels = scratch.getPixelsARGB();  //by x, then y
+        delete sample;
+
+        //Keep only the part the glyph covers
+        int minX = (int) pixels.size();
+        int maxX = -1;
+        int minY = minX;
+        int maxY = -1;
+        for (int x = 0; x < pixels.size(); x++) {
+            for (int y = 0; y < pixels[x].size(); y++) {
+                if (((unsigned int) pixels[x][y] >> 24) != 0) {
+                    minX = min(minX, x);
+                    maxX = max(maxX, x);
+                    minY = min(minY, y);
+                    maxY = max(maxY, y);
+                }
+            }
+        }
+        if (maxX < 0) {
+            continue;
+        }
+        Sprite& sprite = sprites[s];
+        sprite.left = minX - span;
+        sprite.top = minY - span;
+        sprite.width = maxX - minX + 1;
+        sprite.height = maxY - minY + 1;
+        sprite.pixels.resize((size_t) sprite.width * sprite.height);
+        for (int y = 0; y < sprite.height; y++) {
+            for (int x = 0; x < sprite.width; x++) {
+                sprite.pixels[(size_t) y * sprite.width + x] = pixels[minX + x][minY + y];
+            }
+        }
+        reachLeft = min(reachLeft, sprite.left);
+        reachRight = max(reachRight, sprite.left + sprite.width);
+        reachUp = min(reachUp, sprite.top);
+        reachDown = max(reachDown, sprite.top + sprite.height);
+    }
+}
+
+void MapRenderer::draw(Model* model) {
+    //Read the map a row at a time, in parallel
+    runJobs(size, [this, model](int row) {
+        for (int col = 0; col < size; col++) {
+            Entity* thing = model->getEntity(row, col);
+            cells[(size_t) row * size + col] = thing != nullptr ? thing->getSpecies() : EMPTY;
+        }
+    });
+    runJobs(tilesAcross * tilesDown, [this](int tile) {
+        drawTile(tile);
+    });
+    drawnCells.swap(cells);
+
+    //Everything redrawn goes to the canvas at once
+    int left = tilesAcross;
+    int right = -1;
+    int top = tilesDown;
+    int bottom = -1;
+    drawnTiles = 0;
+    for (int tile = 0; tile < tileDrawn.size(); tile++) {
+        if (tileDrawn[tile]) {
+            drawnTiles++;
+            left = min(left, tile % tilesAcross);
+            right = max(right, tile % tilesAcross);
+            top = min(top, tile / tilesAcross);
+            bottom = max(bottom, tile / tilesAcross);
+        }
+    }
+    if (drawnTiles > 0) {
+        canvas->setPixelsARGB(frame.data(), width, height, left * TILE, top * TILE,
+                              (right - left + 1) * TILE, (bottom - top + 1) * TILE);
+    }
+}
+
+void MapRenderer::cellsReaching(int first, int last, int reachBefore, int reachAfter,
+                                int& firstCell, int& lastCell) {
+    //A cell's sprite covers [cell * squareSize + reachBefore, cell * squareSize + reachAfter)
+    //at most
+    firstCell = max(0, floorDiv(first - reachAfter, squareSize) + 1);
+    lastCell = min(size - 1, floorDiv(last - reachBefore, squareSize));
+}
+
+void MapRenderer::drawTile(int tile) {
+    tileDrawn[tile] = 0;
+    int x0 = (tile % tilesAcross) * TILE;
+    int y0 = (tile / tilesAcross) * TILE;
+    int x1 = min(x0 + TILE, width);   //just past the tile
+    int y1 = min(y0 + TILE, height);
+    //x is the row and y the column, as in Gui::draw()
+    int firstRow;
+    int lastRow;
+    int firstCol;
+    int lastCol;
+    cellsReaching(x0, x1 - 1, reachLeft, reachRight, firstRow, lastRow);
+    cellsReaching(y0, y1 - 1, reachUp, reachDown, firstCol, lastCol);
+
+    bool changed = false;
+    for (int row = firstRow; row <= lastRow && !changed; row++) {
+        size_t at = (size_t) row * size;
+        for (int col = firstCol; col <= lastCol && !changed; col++) {
+            changed = cells[at + col] != drawnCells[at + col];
+        }
+    }
+    if (!changed) {
+        return;
+    }
+    tileDrawn[tile] = 1;
+
+    for (int y = y0; y < y1; y++) {
+        fill(frame.begin() + (size_t) y * width + x0, frame.begin() + (size_t) y * width + x1,
+             BACKGROUND);
+    }
+    //In the order Gui::draw() went in, so overlapping glyphs come out the same way up
+    for (int row = firstRow; row <= lastRow; row++) {
+        for (int col = firstCol; col <= lastCol; col++) {
+            const Sprite& sprite = sprites[cells[(size_t) row * size + col]];
+            if (sprite.width == 0) {
+                continue;
+            }
+            int left = row * squareSize + sprite.left;
+            int top = col * squareSize + sprite.top;
+            int fromX = max(x0, left);
+            int toX = min(x1, left + sprite.width);
+            for (int y = max(y0, top); y < min(y1, top + sprite.height); y++) {
+                const unsigned int* from = sprite.pixels.data() + (size_t) (y - top) * sprite.width;
+                unsigned int* to = &frame[(size_t) y * width];
+                for (int x = fromX; x < toX; x++) {
+                    unsigned int src = from[x - left];
+                    unsigned int alpha = src >> 24;
+                    if (alpha == 255) {
+                        to[x] = src;
+                    } else if (alpha != 0) {
+                        //The frame is always opaque, so blending just mixes each channel
+                        unsigned int dst = to[x];
+                        unsigned int mixed = 0xFF000000;
+                        for (int shift = 0; shift < 24; shift += 8) {
+                            unsigned int a = (src >> shift) & 0xFF;
+                            unsigned int b = (dst >> shift) & 0xFF;
+                            mixed |= ((a * alpha + b * (255 - alpha) + 127) / 255) << shift;
+                        }
+                        to[x] = mixed;
+                    }
+                }
+            }
+        }
+    }
+}
+
+int MapRenderer::getDrawnTiles() {
+    return drawnTiles;
+}
+
+int MapRenderer::getTileCount() {
+    return tilesAcross * tilesDown;
+}
+
+void MapRenderer::runJobs(int count, const function<void(int)>& job) {
+    {
+        lock_guard<mutex> lock(poolMutex);
+        this->job = &job;
+        jobCount = count;
+        nextJob = 0;
+        busy = workers.size();
+        generation++;
+    }
+    wake.notify_all();
+    for (int i = nextJob++; i < count; i = nextJob++) {
+        job(i);
+    }
+    unique_lock<mutex> lock(poolMutex);
+    finished.wait(lock, [this] { return busy == 0; });
+}
+
+void MapRenderer::work() {
+    int seen = 0;
+    unique_lock<mutex> lock(poolMutex);
+    while (true) {
+        wake.wait(lock, [this, seen] { return stopping || generation != seen; });
+        if (stopping) {
+            return;
+        }
+        seen = generation;
+        const function<void(int)>& batch = *job;
+        int count = jobCount;
+        lock.unlock();
+        for (int i = nextJob++; i < count; i = nextJob++) {
+            batch(i);
+        }
+        lock.lock();
+        if (--busy == 0) {
+            finished.notify_all();
+        }
+    }
+}
@@ -0,0 +1,112 @@
+/*Sarah Allen & Joshua Lindquist
+CS132 Winter 2022
+Final Project: Simulation
+
+Class main author: Josh
+
+Header for the MapRenderer class, which draws the map for the Gui. Drawing every Entity with its
+own drawString() puts all of the work on the Qt GUI thread, one glyph at a time. Instead, each
+Species' glyph is drawn just once, when the renderer is made, and kept as a sprite. The map is
+drawn into an ARGB framebuffer cut into TILE by TILE pixel tiles: each draw() works out which
+cells changed since the last one, and only the tiles their sprites reach are redrawn, by a pool
+of worker threads that copy the sprites in. The changed part of the framebuffer then goes to
+the canvas as a single image update. It looks the same as drawing each glyph in turn, in the
+same order, so glyphs bigger than their squares still overlap the same way.*/
+
+#ifndef _MAPRENDERER_H
+#define _MAPRENDERER_H
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "Model.h"
+#include "gcanvas.h"
+using namespace std;
+using namespace sgl;
+
+class MapRenderer {
+public:
+    //Renders a size by size map of squareSize pixel squares onto canvas, using threads threads
+    //(0 for one per core). Make it on the GUI's thread; the sprites are drawn with the canvas
+    //library.
+    MapRenderer(GCanvas* canvas, int size, int squareSize, int threads = 0);
+
+    //Stops the worker threads
+    ~MapRenderer();
+
+    //Redraws whatever changed in model since the last draw() (everything, the first time) and
+    //shows it on the canvas
+    void draw(Model* model);
+
+    //Returns how many tiles the last draw() redrew, and how many there are
+    int getDrawnTiles();
+    int getTileCount();
+
+    //Pixels each way in a tile
+    static const int TILE = 64;
+
+    //Color behind the Entities
+    static const unsigned int BACKGROUND = 0xFF00DDAA;
+
+private:
+    //One Species' glyph. left and top are where it starts relative to the corner of its square.
+    struct Sprite {
+        int left;
+        int top;
+        int width;
+        int height;
+        vector<unsigned int> pixels;  //ARGB, row by row
+    };
+
+    //Draws every Species' glyph into sprites, and works out how far any of them reaches
+    void makeSprites();
+
+    //Redraws tile if any cell whose sprite reaches it has changed
+    void drawTile(int tile);
+
+    //Puts the range of cells whose sprites can reach pixels [first, last] of one axis in
+    //firstCell and lastCell. reachBefore and reachAfter are how far sprites reach that way.
+    void cellsReaching(int first, int last, int reachBefore, int reachAfter, int& firstCell,
+                       int& lastCell);
+
+    //Runs job(0) to job(count - 1) spread over the pool and the calling thread, and returns when
+    //they have all finished
+    void runJobs(int count, const function<void(int)>& job);
+
+    //Worker thread body
+    void work();
+
+    GCanvas* canvas;
+    int size;
+    int squareSize;
+    int width;        //pixels
+    int height;
+    int tilesAcross;
+    int tilesDown;
+    vector<Sprite> sprites;  //by Species
+    int reachLeft;    //how far the furthest sprite reaches left of its square's corner
+    int reachRight;   //and right, up and down of it
+    int reachUp;
+    int reachDown;
+    vector<unsigned char> cells;       //Species in each cell now
+    vector<unsigned char> drawnCells;  //Species in each cell when it was last drawn
+    vector<unsigned int> frame;        //ARGB, row by row
+    vector<unsigned char> tileDrawn;   //by tile, whether the last draw() redrew it
+    int drawnTiles;
+
+    vector<thread> workers;
+    mutex poolMutex;
+    condition_variable wake;      //a new batch of jobs, or stopping
+    condition_variable finished;  //the last worker finished its part of a batch
+    const function<void(int)>* job;
+    int jobCount;
+    atomic<int> nextJob;
+    int generation;   //batches started so far
+    int busy;         //workers still on the current batch
+    bool stopping;
+};
+
+#endif
@@ -0,0 +1,275 @@
+/*Joshua Lindquist & Sarah Allen
+CS132 Winter 2022
+Final Project: Simulation
+
+Cpp file for the Metrics class*/
+
+#include "Metrics.h"
+#include "BehaviorCounters.h"
+#include "PerfCounters.h"
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+#ifndef _WIN32
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+Metrics* Metrics::_instance = nullptr;
+
+const double Metrics::BUCKETS[Metrics::BUCKET_COUNT] = {
+    1, 2, 5, 10, 25, 50, 100, 250, 500, 1000, 2500, 5000
+};
+
+//Nanoseconds on the steady clock, so ticks per second survives wall clock changes
+static long long nowNanos() {
+    return chrono::duration_cast<chrono::nanoseconds>(
+                chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+Metrics::Metrics() : population(SPECIES_COUNT) {
+    ticks = 0;
+    for (int i = 0; i <= BUCKET_COUNT; i++) {
+        tickBuckets[i] = 0;
+    }
+    tickMicrosSum = 0;
+    ticksPerSecond = 0;
+    lastTickNanos = 0;
+    for (int i = 0; i < SPECIES_COUNT; i++) {
+        population[i] = 0;
+    }
+    running = false;
+    serverSocket = -1;
+}
+
+Metrics* Metrics::instance() {
+    if (!_instance) {
+        _instance = new Metrics();
+    }
+    return _instance;
+}
+
+void Metrics::recordTick(double tickMs) {
+    ticks++;
+    int bucket = 0;
+    while (bucket < BUCKET_COUNT && tickMs > BUCKETS[bucket]) {
+        bucket++;
+    }
+    tickBuckets[bucket]++;
+    tickMicrosSum += (unsigned long long) (tickMs * 1000);
+
+    //Ticks per second is a moving average of the gaps between committed ticks
+    long long now = nowNanos();
+    long long last = lastTickNanos.exchange(now);
+    if (last != 0 && now > last) {
+        double rate = 1e9 / (now - last);
+        double old = ticksPerSecond;
+        ticksPerSecond = old == 0 ? rate : old * 0.9 + rate * 0.1;
+    }
+}
+
+void Metrics::setPopulation(Species species, long count) {
+    if (species < 0 || species >= SPECIES_COUNT) {
+        return;
+    }
+    population[species] = count;
+}
+
+void Metrics::addGauge(const string& name, const string& help, function<double()> value) {
+    lock_guard<mutex> lock(gaugeMutex);
+    gauges.push_back({name, help, value});
+}
+
+void Metrics::appendGauge(string& out, const string& name, const string& help, double value) {
+    ostringstream text;
+    text.precision(15);
+    text << "# HELP " << name << " " << help << "\n";
+    text << "# TYPE " << name << " gauge\n";
+    text << name << " " << value << "\n";
+    out += text.str();
+}
+
+string Metrics::toPrometheus() {
+    ostringstream out;
+    out.precision(15); //memory sizes and counters must not come out in e-notation
+    out << "# HELP sim_ticks_total Ticks committed since the simulation started.\n";
+    out << "# TYPE sim_ticks_total counter\n";
+    out << "sim_ticks_total " << ticks << "\n";
+
+    out << "# HELP sim_ticks_per_second Moving average of committed ticks per second.\n";
+    out << "# TYPE sim_ticks_per_second gauge\n";
+    out << "sim_ticks_per_second " << ticksPerSecond << "\n";
+
+    out << "# HELP sim_tick_duration_seconds Time spent computing each tick.\n";
+    out << "# TYPE sim_tick_duration_seconds histogram\n";
+    unsigned long long cumulative = 0;
+    for (int i = 0; i < BUCKET_COUNT; i++) {
+        cumulative += tickBuckets[i];
+        out << "sim_tick_duration_seconds_bucket{le=\"" << BUCKETS[i] / 1000 << "\"} "
+            << cumulative << "\n";
+    }
+    cumulative += tickBuckets[BUCKET_COUNT];
+    out << "sim_tick_duration_seconds_bucket{le=\"+Inf\"} " << cumulative << "\n";
+    out << "sim_tick_duration_seconds_sum " << tickMicrosSum / 1e6 << "\n";
+    out << "sim_tick_duration_seconds_count " << cumulative << "\n";
+
+    out << "# HELP sim_population Entities of each species seen during the last tick.\n";
+    out << "# TYPE sim_population gauge\n";
+    for (int i = 1; i < SPECIES_COUNT; i++) { //skip EMPTY
+        out << "sim_population{species=\"" << to_string((Species) i) << "\"} "
+            << population[i] << "\n";
+    }
+
+    string text = out.str();
+    text += BehaviorCounters::instance()->toPrometheus();
+    text += PerfCounters::instance()->toPrometheus();
+
+#ifndef _WIN32
+    //Memory use, straight from the kernel so it costs nothing until scraped
+    ifstream statm("/proc/self/statm");
+    long pages = 0;
+    long residentPages = 0;
+    if (statm >> pages >> residentPages) {
+        long pageSize = sysconf(_SC_PAGESIZE);
+        appendGauge(text, "process_virtual_memory_bytes", "Virtual memory size in bytes.",
+                    (double) pages * pageSize);
+        appendGauge(text, "process_resident_memory_bytes", "Resident memory size in bytes.",
+                    (double) residentPages * pageSize);
+    }
+#endif
+
+    lock_guard<mutex> lock(gaugeMutex);
+    for (Gauge& gauge : gauges) {
+        appendGauge(text, gauge.name, gauge.help, gauge.value());
+    }
+    return text;
+}
+
+bool Metrics::writeFile(const string& path) {
+    //Write next to the real file, then rename over it so a scraper never reads half a file
+    string temp = path + ".tmp";
+    ofstream file(temp);
+    if (!file.good()) {
+        return false;
+    }
+    file << toPrometheus();
+    file.close();
+    if (file.fail()) {
+        return false;
+    }
+    return rename(temp.c_str(), path.c_str()) == 0;
+}
+
+void Metrics::startFileExporter(const string& path, int periodMs) {
+    if (fileThread.joinable()) {
+        return;
+    }
+    running = true;
+    fileThread = thread(&Metrics::fileLoop, this, path, periodMs);
+}
+
+void Metrics::fileLoop(string path, int periodMs) {
+    unique_lock<mutex> lock(stopMutex);
+    while (running) {
+        writeFile(path);
+        stopSignal.wait_for(lock, chrono::milliseconds(periodMs));
+    }
+}
+
+#ifndef _WIN32
+bool Metrics::serve(const string& socketPath) {
+    if (serveThread.joinable()) {
+        return false;
+    }
+    sockaddr_un address = {};
+    address.sun_family = AF_UNIX;
+    if (socketPath.size() >= sizeof(address.sun_path)) {
+        return false;
+    }
+    socketPath.copy(address.sun_path, socketPath.size());
+
+    int server = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (server < 0) {
+        return false;
+    }
+    unlink(socketPath.c_str()); //left behind by an earlier run
+    if (bind(server, (sockaddr*) &address, sizeof(address)) < 0 || listen(server, 4) < 0) {
+        close(server);
+        return false;
+    }
+    serverSocket = server;
+    this->socketPath = socketPath;
+    running = true;
+    serveThread = thread(&Metrics::serveLoop, this);
+    return true;
+}
+
+void Metrics::serveLoop() {
+    while (running) {
+        //Wake up now and then to notice stop()
+        pollfd waiting = {serverSocket, POLLIN, 0};
+        if (poll(&waiting, 1, 200) <= 0) {
+            continue;
+        }
+        int client = accept(serverSocket, nullptr, nullptr);
+        if (client < 0) {
+            continue;
+        }
+        //Give an HTTP client a moment to send its request, plain readers send nothing
+        char request[512];
+        ssize_t got = 0;
+        pollfd reading = {client, POLLIN, 0};
+        if (poll(&reading, 1, 50) > 0) {
+            got = recv(client, request, sizeof(request), 0);
+        }
+        string body = toPrometheus();
+        string reply;
+        if (got >= 3 && string(request, 3) == "GET") {
+            reply = "HTTP/1.0 200 OK\r\n"
+                    "Content-Type: text/plain; version=0.0.4\r\n"
+                    "Content-Length: " + std::to_string(body.size()) + "\r\n\r\n";
+        }
+        reply += body;
+        size_t sent = 0;
+        while (sent < reply.size()) {
+            ssize_t n = send(client, reply.data() + sent, reply.size() - sent, MSG_NOSIGNAL);
+            if (n <= 0) {
+                break;
+            }
+            sent += n;
+        }
+        close(client);
+    }
+}
+#else
+bool Metrics::serve(const string&) {
+    return false;
+}
+
+void Metrics::serveLoop() {}
+#endif
+
+void Metrics::stop() {
+    {
+        lock_guard<mutex> lock(stopMutex);
+        running = false;
+    }
+    stopSignal.notify_all();
+    if (fileThread.joinable()) {
+        fileThread.join();
+    }
+    if (serveThread.joinable()) {
+        serveThread.join();
+    }
+#ifndef _WIN32
+    if (serverSocket >= 0) {
+        close(serverSocket);
+        unlink(socketPath.c_str());
+        serverSocket = -1;
+    }
+#endif
+}
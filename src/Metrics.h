@@ -0,0 +1,100 @@
+/*Sarah Allen & Joshua Lindquist
+CS132 Winter 2022
+Final Project: Simulation
+
+Class main author: Josh
+
+Header for the Metrics class, which keeps live numbers about a running simulation (ticks per
+second, tick latency, populations, and whatever gauges the GUI registers) and exposes them in the
+Prometheus text format, either from a local Unix-domain socket or a file that is rewritten every
+few seconds. Recording is a handful of atomic adds per tick; the text is only built when someone
+scrapes it.*/
+
+#ifndef _METRICS_H
+#define _METRICS_H
+
+#include <atomic>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "entitytypes.h"
+using namespace std;
+
+class Metrics {
+public:
+    //Returns the single Metrics object for this process, creating it if needed
+    static Metrics* instance();
+
+    //Called by the Model each time a tick is committed, with the time spent computing it
+    void recordTick(double tickMs);
+
+    //Called by the Model with the number of each Species seen during the last tick
+    void setPopulation(Species species, long count);
+
+    //Adds a gauge whose value is read by calling value() only when the metrics are scraped, so
+    //it costs nothing in between. The function may run on the exporter's thread.
+    void addGauge(const string& name, const string& help, function<double()> value);
+
+    //Returns every metric in the Prometheus text exposition format
+    string toPrometheus();
+
+    //Writes toPrometheus() to path, replacing the old file in one step so readers never see half
+    //of it. Returns false if the file could not be written.
+    bool writeFile(const string& path);
+
+    //Starts a background thread that calls writeFile(path) every periodMs milliseconds
+    void startFileExporter(const string& path, int periodMs);
+
+    //Starts a background thread serving toPrometheus() on a Unix-domain socket at path. Plain
+    //connections just get the text; an HTTP GET gets it with a response header. Returns false if
+    //the socket could not be opened (or on platforms without Unix sockets).
+    bool serve(const string& socketPath);
+
+    //Stops the exporter threads and removes the socket file
+    void stop();
+
+private:
+    Metrics();
+
+    //Exporter thread bodies
+    void fileLoop(string path, int periodMs);
+    void serveLoop();
+
+    //Appends the text for one gauge to out
+    static void appendGauge(string& out, const string& name, const string& help, double value);
+
+    //Tick latency histogram bucket bounds, in milliseconds (the last bucket is +Inf)
+    static const int BUCKET_COUNT = 12;
+    static const double BUCKETS[BUCKET_COUNT];
+
+    struct Gauge {
+        string name;
+        string help;
+        function<double()> value;
+    };
+
+    static Metrics* _instance;
+
+    atomic<unsigned long long> ticks;
+    atomic<unsigned long long> tickBuckets[BUCKET_COUNT + 1];
+    atomic<unsigned long long> tickMicrosSum;
+    atomic<double> ticksPerSecond;    //moving average over recent ticks
+    atomic<long long> lastTickNanos;  //steady clock time of the last committed tick
+    vector<atomic<long>> population;
+
+    mutex gaugeMutex;
+    vector<Gauge> gauges;
+
+    atomic<bool> running;
+    mutex stopMutex;
+    condition_variable stopSignal;
+    thread fileThread;
+    thread serveThread;
+    int serverSocket;
+    string socketPath;
+};
+
+#endif
@@ -7,14 +7,28 @@ Class main author:
 */
 
 #include "Model.h"
+#include <algorithm>
+#include "BehaviorCounters.h"
+#include "PerfCounters.h"
+#include "SimRandom.h"
+#include "TrajectoryRecorder.h"
 
 using namespace std;
 
+vector<int> Model::footprintWidths;
+vector<int> Model::footprintHeights;
+const int Model::MAX_FOOTPRINT;
+StencilShape Model::perceptionShape = STENCIL_SQUARE;
+int Model::perceptionRadius = 0;
+
+//Index of the FREE plane in layers and nextLayers, after the Species
+static const int FREE = SPECIES_LIMIT;
+
 vector<vector<Entity*>>* Model::createNewVillage(int modelSize) {
     vector<vector<Entity*>>* EntityMap = new vector<vector<Entity*>>();
  
-    // adding size inner vectors to the outer vector
-    for(int i = 0; i < modelSize; i++) {
+    // adding an inner vector for every row (owned and ghost) to the outer vector
+    for(int i = 0; i < ownedRows + 2 * firstRow; i++) {
         vector<Entity*> row;
         // adding nullptr to every spot so it is the right size
         for(int j = 0; j < modelSize; j++) {
@@ -25,50 +39,68 @@ vector<vector<Entity*>>* Model::createNewVillage(int modelSize) {
     return EntityMap;
 }
 
-Model::Model(int modelSize, int tigerNum, int huntNum, int lumbNum, int treeNum, int deerNum) {
+Model::Model(int modelSize, int tigerNum, int huntNum, int lumbNum, int treeNum, int deerNum)
+        : Model(modelSize, 0, modelSize, tigerNum, huntNum, lumbNum, treeNum, deerNum) {}
+
+Model::Model(int modelSize, int firstOwnedRow, int ownedRows, int tigerNum, int huntNum,
+             int lumbNum, int treeNum, int deerNum) {
     this->size = modelSize;
     this->tigerNum = tigerNum;
     this->huntNum = huntNum;
     this->treeNum = treeNum;
     this->deerNum = deerNum;
     this->lumbNum = lumbNum;
+    this->rowOffset = firstOwnedRow;
+    this->ownedRows = ownedRows;
+    //Owning only part of the world means keeping a ghost row on either side of it
+    this->firstRow = ownedRows == modelSize ? 0 : 1;
+    tick = 0;
     map = createNewVillage(modelSize);
+    layers.assign(FREE + 1, OccupancyMap(map->size(), modelSize));
+    layers[EMPTY].setAll();
+    layers[FREE].setAll();
+    nextLayers = layers;
+    covered = new OccupancyMap(map->size(), modelSize);
+    perception = nullptr;
+    oldMap = nullptr;
+    nextMap = nullptr;
+    spareMap = nullptr;
+    blocks = nullptr;
+    focused = false;
+    focusChanged = false;
+    focusRow = 0;
+    focusCol = 0;
+    focusRows = 0;
+    focusCols = 0;
+    unplaced = 0;
+    updating = false;
+    sliceRow = firstRow;
+    sliceCol = 0;
+    tickMs = 0;
+    speciesCount.resize(SPECIES_COUNT);
     
-    //Randomly place each class, depending on how many (determined by initializer)
-    for (int i = 0; i < tigerNum; i++) {
-        int x = rand() % modelSize;
-        int y = rand() % modelSize;
-        Entity* tiger = new Tiger;
-        tiger->setPos(x,y);
-        (*map)[x][y] = tiger;
-    }
-    for (int i = 0; i < huntNum; i++) {
-        int x = rand() % modelSize;
-        int y = rand() % modelSize;
-        Entity* hunt = new Hunter;
-        hunt->setPos(x,y);
-        (*map)[x][y] = hunt;
-    }
-    for (int i = 0; i < treeNum; i++) {
-        int x = rand() % modelSize;
-        int y = rand() % modelSize;
-        Entity* tree = new Tree;
-        tree->setPos(x,y);
-        (*map)[x][y] = tree;
-    }
-    for (int i = 0; i < deerNum; i++) {
-        int x = rand() % modelSize;
-        int y = rand() % modelSize;
-        Entity* deer = new Deer;
-        deer->setPos(x,y);
-        (*map)[x][y] = deer;
-    }
-    for (int i = 0; i < lumbNum; i++) {
-        int x = rand() % modelSize;
-        int y = rand() % modelSize;
-        Entity* lumb = new Lumberjack;
-        lumb->setPos(x,y);
-        (*map)[x][y] = lumb;
+    //Randomly place each class, depending on how many (determined by initializer). Every
+    //Model draws all of the positions, so a Model owning part of the world ends up with
+    //exactly the Entities the whole world would have in those rows.
+    SimRandom::atCell(-1, 0, 0, 0);
+    int counts[] = {tigerNum, huntNum, treeNum, deerNum, lumbNum};
+    Species kinds[] = {TIGER, HUNTER, TREE, DEER, LUMBERJACK};
+    for (int k = 0; k < 5; k++) {
+        for (int i = 0; i < counts[k]; i++) {
+            int x = SimRandom::below(modelSize);
+            int y = SimRandom::below(modelSize);
+            if (x < rowOffset || x >= rowOffset + ownedRows) {
+                continue;
+            }
+            x += firstRow - rowOffset;
+            if (covered->test(x, y)) { //Part of a bigger Entity placed earlier
+                continue;
+            }
+            Entity* thing = typeTranslator(kinds[k]);
+            thing->setPos(x,y);
+            applyFootprint(x, y, thing);
+            setCell(x, y, thing);
+        }
     }
 }
 
@@ -76,62 +108,204 @@ int Model::getSize() {
     return size;
 }
 
-//Entity* Model::typeTranslator(string type){}
+Entity* Model::typeTranslator(string type) {
+    for (int i = 1; i < SPECIES_COUNT; i++) {
+        if (type == to_string((Species) i)) {
+            return typeTranslator((Species) i);
+        }
+    }
+    return nullptr;
+}
 
-void Model::mate(Entity* creature1) {
-    cout << "Reached mate!" << endl;
-    //We need to add a new baby
-    //For humans, baby will always take after creature1
-    string creature1Type = creature1->getType();
-    cout << "Got type: " << creature1Type << endl;
-    Entity* baby = new Creature; //Not null? Please don't break?
-    cout << "Got baby" << endl;
-
-    //Get baby's class
-    if (creature1Type == "Deer") {
-        baby = new Deer();
-    } else if (creature1Type == "Hunter") {
-        baby = new Hunter();
-    } else if (creature1Type == "Lumberjack") {
-        baby = new Lumberjack();
-    } else if (creature1Type == "Tiger") {
-        baby = new Tiger();
-    }
-
-cout << "Got baby type: " << baby->getType() << endl;
+Entity* Model::typeTranslator(Species species) {
+    switch (species) {
+        case BUILDING:   return new Building;
+        case DEER:       return new Deer;
+        case HUNTER:     return new Hunter;
+        case LUMBERJACK: return new Lumberjack;
+        case TIGER:      return new Tiger;
+        case TREE:       return new Tree;
+        case ENTITY:     return new Entity;
+        default:         return nullptr;
+    }
+}
+
+long Model::getTick() {
+    return tick;
+}
+
+const OccupancyMap& Model::getLayer(Species species) {
+    return layers[species];
+}
+
+void Model::setFootprint(Species species, int width, int height) {
+    if (footprintWidths.empty()) {
+        footprintWidths.assign(SPECIES_COUNT, 1);
+        footprintHeights.assign(SPECIES_COUNT, 1);
+    }
+    footprintWidths[species] = max(1, min(width, MAX_FOOTPRINT));
+    footprintHeights[species] = max(1, min(height, MAX_FOOTPRINT));
+}
+
+void Model::getFootprint(Species species, int& width, int& height) {
+    width = footprintWidths.empty() ? 1 : footprintWidths[species];
+    height = footprintHeights.empty() ? 1 : footprintHeights[species];
+}
+
+void Model::setPerception(StencilShape shape, int radius) {
+    perceptionShape = shape;
+    perceptionRadius = max(0, min(radius, Perception::MAX_RADIUS));
+}
+
+bool Model::hasPerception() {
+    return perceptionRadius > 0;
+}
+
+bool Model::hasFootprints() {
+    for (int i = 0; i < (int) footprintWidths.size(); i++) {
+        if (footprintWidths[i] > 1 || footprintHeights[i] > 1) {
+            return true;
+        }
+    }
+    return false;
+}
+
+void Model::setCell(int row, int col, Entity* thing) {
+    //A bigger Entity loses its footprint when something else takes one of its cells, or when
+    //its own cell is emptied
+    int anchorRow;
+    int anchorCol;
+    Entity* owner = footprintOwner(map, row, col, anchorRow, anchorCol);
+    if (owner != nullptr && owner != thing
+            && (thing != nullptr || (anchorRow == row && anchorCol == col))) {
+        uncover(anchorRow, anchorCol, owner->getWidth(), owner->getHeight());
+        owner->setFootprint(1, 1);
+    }
+    vector<OccupancyMap>& planes = map == nextMap ? nextLayers : layers;
+    Entity* old = (*map)[row][col];
+    planes[old == nullptr ? EMPTY : old->getSpecies()].reset(row, col);
+    (*map)[row][col] = thing;
+    planes[thing == nullptr ? EMPTY : thing->getSpecies()].set(row, col);
+    if (thing == nullptr && !covered->test(row, col)) {
+        planes[FREE].set(row, col);
+    } else {
+        planes[FREE].reset(row, col);
+    }
+    if (thing != nullptr && (thing->getWidth() > 1 || thing->getHeight() > 1)) {
+        cover(row, col, thing->getWidth(), thing->getHeight());
+    }
+}
+
+void Model::cover(int row, int col, int rowCount, int colCount) {
+    covered->setRect(row, col, rowCount, colCount);
+    layers[FREE].clearRect(row, col, rowCount, colCount);
+    nextLayers[FREE].clearRect(row, col, rowCount, colCount);
+}
+
+void Model::uncover(int row, int col, int rowCount, int colCount) {
+    covered->clearRect(row, col, rowCount, colCount);
+    int rows = map->size();
+    for (vector<OccupancyMap>* planes : {&layers, &nextLayers}) {
+        for (int i = 0; i < rowCount; i++) {
+            for (int j = 0; j < colCount; j++) {
+                int r = (row + i) % rows;
+                int c = (col + j) % size;
+                if ((*planes)[EMPTY].test(r, c)) {
+                    (*planes)[FREE].set(r, c);
+                }
+            }
+        }
+    }
+}
+
+void Model::applyFootprint(int row, int col, Entity* thing) {
+    int width;
+    int height;
+    getFootprint(thing->getSpecies(), width, height);
+    thing->setFootprint(1, 1);
+    if ((width == 1 && height == 1) || width > (int) map->size() || height > size) {
+        return;
+    }
+    //Every covered cell but the Entity's own has to be empty and outside other footprints
+    const OccupancyMap& empty = (map == nextMap ? nextLayers : layers)[EMPTY];
+    int taken = width * height - empty.count(row, col, width, height)
+                - (empty.test(row, col) ? 0 : 1);
+    if (taken == 0 && !covered->any(row, col, width, height)) {
+        thing->setFootprint(width, height);
+    }
+}
+
+Entity* Model::footprintOwner(vector<vector<Entity*>>* grid, int row, int col, int& anchorRow,
+                              int& anchorCol) {
+    if (!covered->test(row, col)) {
+        return nullptr;
+    }
+    //The owner's own cell is at most MAX_FOOTPRINT - 1 rows and columns back
+    int rows = grid->size();
+    for (int dr = 0; dr < MAX_FOOTPRINT; dr++) {
+        for (int dc = 0; dc < MAX_FOOTPRINT; dc++) {
+            int r = (row - dr + rows) % rows;
+            int c = (col - dc + size) % size;
+            Entity* thing = (*grid)[r][c];
+            if (thing != nullptr && (thing->getWidth() > 1 || thing->getHeight() > 1)
+                    && thing->getWidth() > dr && thing->getHeight() > dc) {
+                anchorRow = r;
+                anchorCol = c;
+                return thing;
+            }
+        }
+    }
+    return nullptr;
+}
+
+Entity* Model::mate(Entity* creature1) {
     //Place baby in available empty spot.
     int x = creature1->getX();
     int y = creature1->getY();
-    if (modelNeighbor(x, y, NORTH) == nullptr) {
-        (*map)[x][y] = baby;
-        baby->setPos(x, y);
-    } else if (modelNeighbor(x, y, SOUTH) == nullptr) {
-        (*map)[x][y] = baby;
-        baby->setPos(x, y);
-    } else if (modelNeighbor(x, y, WEST) == nullptr) {
-        (*map)[x][y] = baby;
-        baby->setPos(x, y);
-    } else if (modelNeighbor(x, y, EAST) == nullptr) {
-        (*map)[x][y] = baby;
-        baby->setPos(x, y);
-    } //If none available the baby died from childbirth complications :'(
-        cout << "Got to end of mate" << endl;
+    //One bit of the EMPTY plane per neighbor instead of asking each cell for its Entity
+    const OccupancyMap& empty = (map == nextMap ? nextLayers : layers)[EMPTY];
+    bool room = false;
+    for (Direction dir : {NORTH, SOUTH, WEST, EAST}) {
+        int newRow;
+        int newCol;
+        neighborCell(x, y, dir, newRow, newCol);
+        room = room || empty.test(newRow, newCol);
+    }
+    if (!room) { //If none available the baby died from childbirth complications :'(
+        return nullptr;
+    }
+
+    //We need to add a new baby
+    //For humans, baby will always take after creature1
+    Entity* baby;
+    switch (creature1->getSpecies()) {
+        case DEER:       baby = new Deer(); break;
+        case HUNTER:     baby = new Hunter(); break;
+        case LUMBERJACK: baby = new Lumberjack(); break;
+        case TIGER:      baby = new Tiger(); break;
+        default:         baby = new Creature; break;
+    }
+    setCell(x, y, baby);
+    baby->setPos(x, y);
+    return baby;
 }
 
 Entity* Model::fight(Entity* creature1, Entity* creature2) {
+    Attack weapon1;
+    Attack weapon2;
+    return fight(creature1, creature2, weapon1, weapon2);
+}
+
+Entity* Model::fight(Entity* creature1, Entity* creature2, Attack& weapon1, Attack& weapon2) {
     //get the weapons for each creature
-    cout << "Reached fight function!" << endl;
-    Attack weapon1 = creature1->fight();
-    cout << "Got first weapon: " << creature1->getType() << weapon1 << endl;
-    Attack weapon2 = creature2->fight();
-    cout << "Got second weapon: " << weapon2 << endl;
+    weapon1 = creature1->fight();
+    weapon2 = creature2->fight();
 
     Entity* winner;
-    cout << "Weapons: " << weapon1 << " " << weapon2 << endl;
     if ((weapon2 == FORFEIT) || (weapon1 == BITE && weapon2 == CHOP)) {
         winner = creature1;
     } else if ((weapon1 == STAB && weapon2 == BITE) || (weapon1 == BITE && weapon2 == STAB)) {
-        winner = rand() % 2 == 0 ? creature1 : creature2;
+        winner = SimRandom::below(2) == 0 ? creature1 : creature2;
     } else {
         winner = creature2;
     }
@@ -139,144 +313,519 @@ Entity* Model::fight(Entity* creature1, Entity* creature2) {
     return winner;
 }
 
+void Model::emitEvent(EventType type, Species species, Entity* actor, Entity* other,
+                      Entity* result, int row, int col, Attack attack, Attack otherAttack) {
+    Event event;
+    event.tick = tick + 1;
+    event.type = type;
+    event.species = species;
+    event.otherSpecies = other->getSpecies();
+    event.actor = actor->getId();
+    event.other = other->getId();
+    event.result = result->getId();
+    event.x = row - firstRow + rowOffset;
+    event.y = col;
+    event.attack = attack;
+    event.otherAttack = otherAttack;
+    EventStream::emit(event);
+    if (TrajectoryRecorder::isRecording() && ownedRows == size) {
+        TrajectoryRecorder::instance()->recordEvent(event);
+    }
+}
+
 Entity* Model::getEntity(int row, int col) {
     return (*map)[row][col];
 }
 
-Entity* Model::modelNeighbor(int row, int col, Direction dir) {
-    int newRow;
-    int newCol;
-    Entity* neighbor;
+void Model::neighborCell(int row, int col, Direction dir, int& newRow, int& newCol) {
+    int rows = map->size();
+    newRow = row;
+    newCol = col;
     if(dir == WEST) {
-        newRow = row - 1 < 0? map->size() - 1 : row - 1;
-        return neighbor = (*map)[newRow][col];
+        newRow = row - 1 < 0? rows - 1 : row - 1;
     } else if (dir == EAST) {
-       newRow = (row + 1) % map->size();
-       return neighbor = (*map)[newRow][col];
+        newRow = (row + 1) % rows;
     } else if (dir == SOUTH) {
-        newCol = (col + 1) % map->size();
-        return neighbor = (*map)[row][newCol];
+        newCol = (col + 1) % size;
     } else if (dir == NORTH) {
-        newCol = col - 1 < 0? map->size() - 1 : col - 1;
-        return neighbor = (*map)[row][newCol];
-    }else {
-        return neighbor = nullptr;
+        newCol = col - 1 < 0? size - 1 : col - 1;
     }
 }
 
-void Model::addEntity(int row, int col, Entity* thing, vector<vector<Entity*>>* oldMap) {
-    cout << thing->getType();                                                                   //ERASE THIS
-        Direction dir = thing->getMove();
-        string neighbor = "";
+Entity* Model::modelNeighbor(int row, int col, Direction dir) {
+    if (dir == CENTER) {
+        return nullptr;
+    }
+    int newRow;
+    int newCol;
+    neighborCell(row, col, dir, newRow, newCol);
+    return (*map)[newRow][newCol];
+}
+
+void Model::addEntity(int row, int col, Entity* thing) {
+    moveEntity(row, col, thing, thing->getMove());
+}
+
+void Model::moveEntity(int row, int col, Entity* thing, Direction dir) {
+    Species neighbor = EMPTY;
+    //gets new row and new col for the rest of this function to work
+    int newRow;
+    int newCol;
+    neighborCell(row, col, dir, newRow, newCol);
     if (dir != CENTER) { //Entity can't be its own neighbor
-        Entity* neighborEnt = modelNeighbor(row, col, dir);
+        //Moving onto any cell of a bigger Entity means meeting it on its own cell. Those never
+        //move, so the last tick's map says where that is.
+        int anchorRow;
+        int anchorCol;
+        Entity* owner = footprintOwner(oldMap != nullptr ? oldMap : map, newRow, newCol,
+                                       anchorRow, anchorCol);
+        if (owner != nullptr && owner != thing) {
+            newRow = anchorRow;
+            newCol = anchorCol;
+        }
+        Entity* neighborEnt = (*map)[newRow][newCol];
         if (neighborEnt != nullptr) { //if the neighbor exists
-            neighbor = neighborEnt->getType();
+            neighbor = neighborEnt->getSpecies();
         }
-        thing->setNeighbor(dir, neighbor);
+        thing->setNeighborSpecies(dir, neighbor);
     }
-    int newRow = row;
-    int newCol = col;
-
-    //gets new row and new col for the rest of this function to work
-    if(dir == WEST) {
-        newRow = row - 1 < 0? map->size() - 1 : row - 1;
-    } else if (dir == EAST) {
-       newRow = (row + 1) % map->size();
-    } else if (dir == SOUTH) {
-        newCol = (col + 1) % map->size();
-    } else if (dir == NORTH) {
-        newCol = col - 1 < 0? map->size() - 1 : col - 1;
-    }else {
-        (*map)[row][col] = thing;
+    if (dir == CENTER) {
+        setCell(row, col, thing);
     }
 
-    cout << " Neighbor: " << neighbor << endl;
-    if(neighbor != "") {
+    if(neighbor != EMPTY) {
         //Entity* otherThing = (*oldMap)[newRow][newCol];
         //Entity* otherThing = modelNeighbor(row, col, dir);
-        Entity* otherThing = modelNeighbor(newRow, newCol, dir);
+        //The neighbor was read from the target cell, so that is who we meet
+        Entity* otherThing = (*map)[newRow][newCol];
         
-        if (neighbor == thing->getType() //If matching Entities or both humans
-        || (neighbor == "Hunter" && thing->getType() == "Lumberjack") 
-        || (neighbor == "Lumberjack" && thing->getType() == "Hunter")) {
-            mate(thing);
+        Species species = thing->getSpecies();
+        if (neighbor == species //If matching Entities or both humans
+        || (neighbor == HUNTER && species == LUMBERJACK)
+        || (neighbor == LUMBERJACK && species == HUNTER)) {
+            Entity* baby = mate(thing);
+            if (baby != nullptr) {
+                emitEvent(EVENT_BIRTH, baby->getSpecies(), thing, otherThing, baby,
+                          baby->getX(), baby->getY());
+            }
             thing->onMate();
             otherThing->onMate();
         } else {
-            Entity* winner = fight(thing, otherThing);
+            Attack weapon1;
+            Attack weapon2;
+            Entity* winner = fight(thing, otherThing, weapon1, weapon2);
             winner->onWin();
+            emitEvent(EVENT_FIGHT, thing->getSpecies(), thing, otherThing, winner, newRow, newCol,
+                      weapon1, weapon2);
 
             //Build house with lumber
-            if (otherThing->getType() == "Tree") { 
-            (*map)[newRow][newCol] = new Building;
-            (*map)[row][col] = winner;
+            if (otherThing->getSpecies() == TREE) {
+            //The Building goes up on the whole of the Tree's footprint
+            Entity* building = new Building;
+            building->setFootprint(otherThing->getWidth(), otherThing->getHeight());
+            setCell(newRow, newCol, building);
+            setCell(row, col, winner);
+            emitEvent(EVENT_BUILD, thing->getSpecies(), thing, otherThing,
+                      (*map)[newRow][newCol], newRow, newCol);
             } else {
             //Winner takes the spot:
-            (*map)[newRow][newCol] = winner;
+            setCell(newRow, newCol, winner);
             }
         }
     } else {
-        (*map)[newRow][newCol] = thing;
+        setCell(newRow, newCol, thing);
     }
 }
 
 void Model::update() {
-    // create a new map 
-    vector<vector<Entity*>>* newMap = createNewVillage(map->size());
-    // creates a temporary pointer to point at the old state of the map
-    // and points the member variable at the empty new map
-    vector<vector<Entity*>>* oldMap = map;
-    map = newMap;
-
-    //
-    for(int row = 0; row < map->size(); row++) {
-        for(int col = 0; col < map->size(); col++) {
-            Entity* thing = (*oldMap)[row][col];
-           
-            // when you come accross a Entity....
-            if(thing != nullptr) {
-               
-                //Ensures each thing knows where it is
-                thing->setPos(row, col);
-                cout << "Thing pos: "<< thing->getX() << ", " << thing->getY() << endl;
-                
-                //Checks each direction for neighbors, would be good to make this a new function.
-                for (Direction dir : {CENTER, NORTH, EAST, SOUTH, WEST}) {
-                    Entity* neighbor;
-                    int newRow = row;
-                    int newCol = col;
-                    if(dir == WEST) {
-                        newRow = row - 1 < 0? map->size() - 1 : row - 1;
-                    } else if (dir == EAST) {
-                        newRow = (row + 1) % map->size();
-                    } else if (dir == SOUTH) {
-                        newCol = (col + 1) % map->size();
-                    } else if (dir == NORTH) {
-                        newCol = col - 1 < 0? map->size() - 1 : col - 1;
-                    }else {
-                        neighbor = (*oldMap)[row][col];
-                    }
-                    
-                    neighbor = (*oldMap)[newRow][newCol]; 
-                    
-                    if (neighbor != nullptr) {
-                        string neighborName = neighbor->getType();
-                        thing->setNeighbor(dir, neighborName);
-                    } else {
-                        thing->setNeighbor(dir, "");
-                    }
+    //Runs the whole tick as one slice with no time limit
+    while (!stepUpdate(-1)) {}
+}
+
+bool Model::stepUpdate(double budgetMs) {
+    auto start = chrono::steady_clock::now();
+    PerfCounters::Sample phaseStart;
+    if (!updating) {
+        PerfCounters::read(phaseStart);
+        beginTick();
+        PerfCounters::add(PHASE_BEGIN, phaseStart);
+        sliceRow = firstRow;
+        sliceCol = 0;
+        tickMs = 0;
+    }
+
+    //While a slice runs the member variable points at the map being built, the same as a
+    //whole update(). In between slices it points back at the last committed map.
+    vector<vector<Entity*>>* committed = map;
+    map = nextMap;
+    int checked = 0;
+    int endRow = firstRow + ownedRows;
+    PerfCounters::read(phaseStart);
+    while (sliceRow < endRow) {
+        //Coarse blocks have no Entities to move, so skip straight past them
+        if (blocks != nullptr && blocks->isCoarse(sliceRow, sliceCol)) {
+            sliceCol = blocks->blockEnd(sliceCol);
+        } else {
+            updateCell(sliceRow, sliceCol);
+            sliceCol++;
+        }
+        if (sliceCol == size) {
+            sliceCol = 0;
+            sliceRow++;
+        }
+        //Only look at the clock every few cells, it costs more than an empty cell
+        if (budgetMs >= 0 && ++checked == SLICE_CHECK && sliceRow < endRow) {
+            checked = 0;
+            chrono::duration<double, milli> spent = chrono::steady_clock::now() - start;
+            if (spent.count() >= budgetMs) {
+                PerfCounters::add(PHASE_MOVE, phaseStart);
+                map = committed;
+                tickMs += spent.count();
+                return false;
+            }
+        }
+    }
+    PerfCounters::add(PHASE_MOVE, phaseStart);
+    if (blocks != nullptr) {
+        PerfCounters::read(phaseStart);
+        updateBlocks();
+        PerfCounters::add(PHASE_BLOCKS, phaseStart);
+    }
+    map = committed;
+    chrono::duration<double, milli> spent = chrono::steady_clock::now() - start;
+    tickMs += spent.count();
+    PerfCounters::read(phaseStart);
+    commitUpdate();
+    PerfCounters::add(PHASE_COMMIT, phaseStart);
+    return true;
+}
+
+bool Model::isUpdating() {
+    return updating;
+}
+
+void Model::beginTick() {
+    if (focusChanged) {
+        applyFocus();
+    }
+    // create a new map and remember the old state of the map
+    // for the rest of the tick to read from
+    oldMap = map;
+    if (spareMap != nullptr) {
+        nextMap = spareMap;
+        spareMap = nullptr;
+        for (vector<Entity*>& line : *nextMap) {
+            fill(line.begin(), line.end(), nullptr);
+        }
+    } else {
+        nextMap = createNewVillage(size);
+    }
+    //Everything sees the map the tick starts from, so count it all before anything moves
+    if (hasPerception()) {
+        if (perception == nullptr || perception->getShape() != perceptionShape
+                || perception->getRadius() != perceptionRadius) {
+            delete perception;
+            perception = new Perception(perceptionShape, perceptionRadius, map->size(), size);
+        }
+        perception->compute(layers);
+    }
+    for (OccupancyMap& plane : nextLayers) {
+        plane.clearAll();
+    }
+    nextLayers[EMPTY].setAll();
+    nextLayers[FREE].setAll();
+    nextLayers[FREE].andNot(*covered);
+    speciesCount.assign(SPECIES_COUNT, 0);
+    updating = true;
+}
+
+void Model::commitUpdate() {
+    map = nextMap;
+    layers.swap(nextLayers);
+    //Entities live on in the new map; the old grid is kept to be the next tick's nextMap
+    spareMap = oldMap;
+    oldMap = nullptr;
+    nextMap = nullptr;
+    updating = false;
+    tick++;
+
+    BehaviorCounters::instance()->mergeTick();
+    //Strips of a DomainRunner only hold part of the world, so only whole Models are recorded
+    if (TrajectoryRecorder::isRecording() && ownedRows == size) {
+        TrajectoryRecorder::instance()->record(this);
+    }
+    Metrics* metrics = Metrics::instance();
+    metrics->recordTick(tickMs);
+    long updated = 0;
+    for (int i = 0; i < SPECIES_COUNT; i++) {
+        long coarse = blocks != nullptr ? blocks->total((Species) i) : 0;
+        metrics->setPopulation((Species) i, speciesCount[i] + coarse);
+        updated += speciesCount[i];
+    }
+    if (PerfCounters::isEnabled()) {
+        PerfCounters::instance()->addEntityUpdates(updated);
+    }
+}
+
+void Model::updateCell(int row, int col) {
+    // when you come accross a Entity....
+    if((*oldMap)[row][col] != nullptr) {
+        Direction dir = decideMove(row, col);
+        //Adds everything onto the map, this needs to be the last thing that happens here
+        resolveMove(row, col, dir);
+    }
+}
+
+Direction Model::decideMove(int row, int col) {
+    Entity* thing = (*oldMap)[row][col];
+    speciesCount[thing->getSpecies()]++;
+
+    //Ensures each thing knows where it is
+    thing->setPos(row, col);
+
+    //Checks each direction for neighbors
+    Surroundings around;
+    around.signature = 0;
+    for (Direction dir : {CENTER, NORTH, EAST, SOUTH, WEST}) {
+        int newRow;
+        int newCol;
+        neighborCell(row, col, dir, newRow, newCol);
+        Entity* neighbor = (*oldMap)[newRow][newCol];
+        if (neighbor == nullptr) {
+            //An empty cell can still be part of a bigger Entity
+            int anchorRow;
+            int anchorCol;
+            neighbor = footprintOwner(oldMap, newRow, newCol, anchorRow, anchorCol);
+            if (neighbor == thing) {
+                neighbor = nullptr;
+            }
+        }
+
+        around.neighbors[dir] = neighbor != nullptr ? neighbor->getSpecies() : EMPTY;
+        if (dir != CENTER) {
+            around.signature |= around.neighbors[dir] << ((dir - NORTH) * Entity::SIGNATURE_BITS);
+        }
+    }
+    around.counts = nullptr;
+    if (perception != nullptr && hasPerception()) {
+        perception->touching(row, col, around.touching);
+        around.counts = perception->counts(row, col);
+        thing->setSurroundings(around.counts, around.touching);
+    }
+    SimRandom::atCell(tick, row - firstRow + rowOffset, col, 0);
+    return thing->getMove(around);
+}
+
+void Model::resolveMove(int row, int col, Direction dir) {
+    SimRandom::atCell(tick, row - firstRow + rowOffset, col, 1);
+    moveEntity(row, col, (*oldMap)[row][col], dir);
+}
+
+const OccupancyMap& Model::freeCells() {
+    return (map == nextMap ? nextLayers : layers)[FREE];
+}
+
+void Model::setFocus(int row, int col, int rows, int cols) {
+    focused = true;
+    focusChanged = true;
+    focusRow = row;
+    focusCol = col;
+    focusRows = rows;
+    focusCols = cols;
+}
+
+void Model::clearFocus() {
+    focusChanged = focused;
+    focused = false;
+}
+
+bool Model::hasFocus() {
+    return focused;
+}
+
+long Model::getPopulation(Species species) {
+    return layers[species].count() + (blocks != nullptr ? blocks->total(species) : 0);
+}
+
+long Model::getUnplaced() {
+    return unplaced;
+}
+
+void Model::applyFocus() {
+    focusChanged = false;
+    if (blocks == nullptr) {
+        if (!focused) {
+            return;
+        }
+        blocks = new CoarseBlocks(size);
+    }
+    for (int b = 0; b < blocks->getBlockCount(); b++) {
+        int row;
+        int col;
+        int rows;
+        int cols;
+        blocks->bounds(b, row, col, rows, cols);
+        bool inView = !focused || (row < focusRow + focusRows && focusRow < row + rows
+                                   && col < focusCol + focusCols && focusCol < col + cols);
+        if (!inView && !blocks->isCoarseBlock(b)) {
+            coarsen(b);
+        } else if (inView && blocks->isCoarseBlock(b)) {
+            refine(b);
+        }
+    }
+    if (!focused) {
+        delete blocks;
+        blocks = nullptr;
+    }
+}
+
+void Model::coarsen(int block) {
+    int row;
+    int col;
+    int rows;
+    int cols;
+    blocks->bounds(block, row, col, rows, cols);
+    for (int r = row; r < row + rows; r++) {
+        for (int c = col; c < col + cols; c++) {
+            Entity* thing = (*map)[r][c];
+            if (thing != nullptr) {
+                Species species = thing->getSpecies();
+                blocks->setCount(block, species, blocks->getCount(block, species) + 1);
+                setCell(r, c, nullptr);
+                delete thing;
+            }
+        }
+    }
+    blocks->setCoarse(block, true);
+}
+
+void Model::refine(int block) {
+    int row;
+    int col;
+    int rows;
+    int cols;
+    blocks->bounds(block, row, col, rows, cols);
+    blocks->setCoarse(block, false);
+    cellScratch.clear();
+    for (int r = row; r < row + rows; r++) {
+        for (int c = col; c < col + cols; c++) {
+            cellScratch.push_back(r * size + c);
+        }
+    }
+    SimRandom::atCell(tick, -3, block, 0);
+    for (int s = EMPTY + 1; s < SPECIES_COUNT; s++) {
+        int count = blocks->getCount(block, (Species) s);
+        int placed = 0;
+        while (placed < count && placeAmong(cellScratch, (Species) s)) {
+            placed++;
+        }
+        unplaced += count - placed;
+        blocks->setCount(block, (Species) s, 0);
+    }
+}
+
+void Model::updateBlocks() {
+    //Nothing moves more than one cell, so whatever walked into a coarse block is on its edge
+    //next to a block that isn't coarse. If the coarse block is full it goes back to the edge
+    //it came from.
+    SimRandom::atCell(tick, -6, 0, 0);
+    for (int b = 0; b < blocks->getBlockCount(); b++) {
+        if (blocks->isCoarseBlock(b)) {
+            continue;
+        }
+        for (Direction dir : {NORTH, EAST, SOUTH, WEST}) {
+            int next = blocks->neighbor(b, dir);
+            if (!blocks->isCoarseBlock(next)) {
+                continue;
+            }
+            int row;
+            int col;
+            int rows;
+            int cols;
+            blocks->bounds(next, row, col, rows, cols);
+            //The edge of next facing b
+            int r = dir == WEST ? row + rows - 1 : row;
+            int c = dir == NORTH ? col + cols - 1 : col;
+            int steps = dir == EAST || dir == WEST ? cols : rows;
+            for (int i = 0; i < steps; i++) {
+                int cellRow = dir == EAST || dir == WEST ? r : r + i;
+                int cellCol = dir == EAST || dir == WEST ? c + i : c;
+                Entity* thing = (*map)[cellRow][cellCol];
+                if (thing == nullptr) {
+                    continue;
+                }
+                Species species = thing->getSpecies();
+                setCell(cellRow, cellCol, nullptr);
+                delete thing;
+                if (blocks->room(next) > 0) {
+                    blocks->setCount(next, species, blocks->getCount(next, species) + 1);
+                } else if (!placeOnEdge(b, dir, species)) {
+                    unplaced++;
                 }
-                //Adds everything onto the map, this needs to be the last thing that happens here
-                addEntity(row, col, thing, oldMap);
             }
         }
     }
+
+    arrivals.clear();
+    blocks->step(tick, arrivals);
+
+    //Creatures that walked out of coarse blocks come in on the edge they crossed. If it is full
+    //they stay in the block they were leaving.
+    SimRandom::atCell(tick, -5, 0, 0);
+    for (const Arrival& arrival : arrivals) {
+        if (placeOnEdge(arrival.block, arrival.side, arrival.species)) {
+            blocks->setCount(arrival.from, arrival.species,
+                             blocks->getCount(arrival.from, arrival.species) - 1);
+        }
+    }
 }
 
+bool Model::placeOnEdge(int block, Direction side, Species species) {
+    int row;
+    int col;
+    int rows;
+    int cols;
+    blocks->bounds(block, row, col, rows, cols);
+    cellScratch.clear();
+    if (side == WEST || side == EAST) {
+        int r = side == WEST ? row : row + rows - 1;
+        for (int c = col; c < col + cols; c++) {
+            cellScratch.push_back(r * size + c);
+        }
+    } else {
+        int c = side == NORTH ? col : col + cols - 1;
+        for (int r = row; r < row + rows; r++) {
+            cellScratch.push_back(r * size + c);
+        }
+    }
+    return placeAmong(cellScratch, species);
+}
+
+bool Model::placeAmong(vector<int>& cells, Species species) {
+    const OccupancyMap& free = freeCells();
+    while (!cells.empty()) {
+        int i = SimRandom::below(cells.size());
+        int cell = cells[i];
+        cells[i] = cells.back();
+        cells.pop_back();
+        int row = cell / size;
+        int col = cell % size;
+        if (free.test(row, col)) {
+            Entity* thing = typeTranslator(species);
+            thing->setPos(row, col);
+            placeEntity(row, col, thing);
+            return true;
+        }
+    }
+    return false;
+}
 
 void Model::placeEntity(int i, int j, Entity* e) {
-    (*map)[i][j] = e;
+    setCell(i, j, nullptr);
+    if (e != nullptr) {
+        applyFootprint(i, j, e);
+        setCell(i, j, e);
+    }
 }
 
 ostream& operator<< (ostream& out, Entity* e) {
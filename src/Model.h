@@ -11,6 +11,7 @@ maintaining a grid of Entities and determining the outcome of their actions.*/
 #define _MODEL_H
 
 #include <vector>
+#include <chrono>
 #include "Entity.h"
 #include "Tiger.h"
 #include "Hunter.h"
@@ -20,15 +21,22 @@ maintaining a grid of Entities and determining the outcome of their actions.*/
 #include "Building.h"
 #include "entitytypes.h"
 #include "Creature.h"
+#include "EventStream.h"
+#include "Metrics.h"
+#include "OccupancyMap.h"
+#include "Perception.h"
+#include "CoarseBlocks.h"
 
 class Model {
+    friend class DomainRunner;
+
 public:
     //Constructor, populates vector of vectors with entities
     Model(int modelSize, int tigerNum, int huntNum, int lumbNum, int treeNum, int deerNum);   
 
     //Calls the Entity's getMove() return, then moves it to its new spot on the map. If the move
     //would place the Entity out of bounds, it will wrap around to the opposite side of the map.
-    void addEntity(int row, int col, Entity* animal, vector<vector<Entity*>>* oldMap);
+    void addEntity(int row, int col, Entity* animal);
         
     //Returns a pointer to the Entity stored in the specified spot in the map
     Entity* getEntity(int row, int col);
@@ -39,30 +47,211 @@ public:
     //Calls for every Entity's move, and determines the outcome of every move and interaction
     void update();
 
+    //Processes the current tick in slices: starts a new tick if none is in progress, then updates
+    //cells until budgetMs milliseconds have passed (a negative budget means no limit). Returns true
+    //only when the last slice finished and the tick was committed. Until then getEntity() keeps
+    //returning the previous tick's map, so the GUI can redraw between slices.
+    bool stepUpdate(double budgetMs);
+
+    //Returns true while a tick started by stepUpdate() has not been committed yet
+    bool isUpdating();
+
     //Determines the outcome of two creatures fighting, using the creatures' Attack returns
     Entity* fight(Entity* creature1, Entity* creature2);
    
-    //Calls for mating behavior between the two entities
-    void mate(Entity* creature1);
+    //Calls for mating behavior between the two entities. Returns the baby, or nullptr if there
+    //was no room for it.
+    Entity* mate(Entity* creature1);
 
     //Function for the load/save feature, to place a creature in a specific spot on the map
     void placeEntity(int i, int j, Entity* e);
 
     Entity* modelNeighbor(int row, int col, Direction dir);
 
+    //Returns a new Entity of the named type ("Deer", "Tree", ...), or nullptr for an unknown name
     Entity* typeTranslator(string type);
 
+    //Returns a new Entity of the given Species, or nullptr for EMPTY
+    static Entity* typeTranslator(Species species);
+
+    //Returns the number of ticks committed so far
+    long getTick();
+
+    //Returns the bit-plane of the current map for species: a cell is set if it holds that
+    //species, and the EMPTY plane has every empty cell set. With OccupancyMap's shifted(), &, |
+    //and count() a rule about neighbors is checked for the whole grid at once, for example
+    //(getLayer(DEER) & getLayer(HUNTER).shifted(EAST)).count() counts deer with a hunter east.
+    const OccupancyMap& getLayer(Species species);
+
+    //Sets the footprint (see Entity::setFootprint) Entities of species get when they are placed,
+    //up to MAX_FOOTPRINT by MAX_FOOTPRINT. An Entity only gets it if nothing else is in the way,
+    //otherwise it stays 1 by 1. Only Entities that never move (Trees, Buildings) should be
+    //given one. Buildings take the footprint of the Tree they were built from.
+    static void setFootprint(Species species, int width, int height);
+
+    //Returns the footprint Entities of species get, 1 by 1 unless setFootprint() was called
+    static void getFootprint(Species species, int& width, int& height);
+
+    //Returns true if any species has a footprint bigger than 1 by 1
+    static bool hasFootprints();
+
+    //Biggest footprint width or height
+    static const int MAX_FOOTPRINT = 4;
+
+    //Makes every Model count what each Entity can see through a stencil of shape and radius
+    //(see Perception) once per tick, and hand it to Entity::getMove() in its Surroundings.
+    //A radius of 0, the default, turns it off.
+    static void setPerception(StencilShape shape, int radius);
+
+    //Returns true if setPerception() turned a stencil on
+    static bool hasPerception();
+
+    //Keeps Entities only in and around the rows by cols window of cells starting at (row, col).
+    //Every block of the map (see CoarseBlocks) that doesn't touch the window is made coarse:
+    //its Entities are counted and deleted, and from then on it is run from the counts. Blocks
+    //that come into the window get Entities again, placed at random in the block. Takes effect
+    //when the next tick starts.
+    void setFocus(int row, int col, int rows, int cols);
+
+    //Gives every block its Entities back when the next tick starts
+    void clearFocus();
+
+    //Returns true while setFocus() is in effect
+    bool hasFocus();
+
+    //Returns the number of Entities of species in the world, coarse blocks included
+    long getPopulation(Species species);
+
+    //Returns how many Entities have been lost so far because there was no free cell to put
+    //them on: when a coarse block came into view, or when one walked into a full coarse block
+    //and the edge it came from had filled up behind it
+    long getUnplaced();
+
 private:
+    //Constructor for a Model that only owns world rows firstOwnedRow to firstOwnedRow+ownedRows-1,
+    //used by DomainRunner. Unless it owns every row, its map has a ghost row above and below the
+    //owned rows (map row 0 and ownedRows+1) that the runner fills in from its neighbors.
+    Model(int modelSize, int firstOwnedRow, int ownedRows, int tigerNum, int huntNum, int lumbNum,
+          int treeNum, int deerNum);
+
     //Helper function to fill vector of vector with nullptrs, sets the vectors to the correct size
     vector<vector<Entity*>>* createNewVillage(int modelSize);
 
+    //Finds the cell next to (row, col) in direction dir, wrapping around the edges of the map
+    void neighborCell(int row, int col, Direction dir, int& newRow, int& newCol);
+
+    //Moves the Entity at (row, col) of oldMap onto the map being built, the body of one tick
+    void updateCell(int row, int col);
+
+    //First half of updateCell: tells the Entity at (row, col) of oldMap what is around it and
+    //returns its move. Only reads oldMap, so cells can decide in any order.
+    Direction decideMove(int row, int col);
+
+    //Second half of updateCell: carries out the move on the map being built, fighting or mating
+    //with whatever is already there. Cells have to resolve in row by row order.
+    void resolveMove(int row, int col, Direction dir);
+
+    //Places thing on the map being built after it moves from (row, col) in direction dir
+    void moveEntity(int row, int col, Entity* thing, Direction dir);
+
+    //fight(), also handing back the weapons the two creatures used
+    Entity* fight(Entity* creature1, Entity* creature2, Attack& weapon1, Attack& weapon2);
+
+    //Sends an EventStream Event about the map cell (row, col) for the tick being built
+    void emitEvent(EventType type, Species species, Entity* actor, Entity* other, Entity* result,
+                   int row, int col, Attack attack = FORFEIT, Attack otherAttack = FORFEIT);
+
+    //Starts a tick: remembers the current map as oldMap and makes an empty nextMap
+    void beginTick();
+
+    //Swaps the finished map in as the current one and throws the old grid away
+    void commitUpdate();
+
+    //Puts thing (or nullptr) in the map cell (row, col), keeping the occupancy bits up to date.
+    //A bigger Entity that was there gives up its footprint.
+    void setCell(int row, int col, Entity* thing);
+
+    //Gives thing, which is about to be placed at (row, col), its species' footprint if the
+    //cells it would cover are free
+    void applyFootprint(int row, int col, Entity* thing);
+
+    //Returns the cells of the map being changed that are empty and not under a footprint
+    const OccupancyMap& freeCells();
+
+    //Marks a footprint's rectangle as covered, so none of it is free
+    void cover(int row, int col, int rowCount, int colCount);
+
+    //Marks a footprint's rectangle as no longer covered; its empty cells are free again
+    void uncover(int row, int col, int rowCount, int colCount);
+
+    //Makes blocks coarse or gives them Entities back to match the focus, between ticks
+    void applyFocus();
+
+    //Counts and deletes the Entities of a block of the current map and makes it coarse
+    void coarsen(int block);
+
+    //Places a coarse block's counts as Entities at random free cells of the block
+    void refine(int block);
+
+    //End of a tick with a focus: Entities that walked into coarse blocks join their counts, the
+    //coarse blocks take their step, and what walked out of them is placed on the map being built
+    void updateBlocks();
+
+    //Puts a new Entity of species at a random free cell of cells, which it takes out of cells.
+    //Returns false if none of them is free.
+    bool placeAmong(vector<int>& cells, Species species);
+
+    //Puts a new Entity of species at a random free cell along the side of a block, using
+    //cellScratch. Returns false if none of them is free.
+    bool placeOnEdge(int block, Direction side, Species species);
+
+    //Returns the bigger Entity of grid whose footprint covers (row, col) and sets anchorRow and
+    //anchorCol to its own cell, or returns nullptr if covered says no footprint is there
+    Entity* footprintOwner(vector<vector<Entity*>>* grid, int row, int col, int& anchorRow,
+                           int& anchorCol);
+
     //Member variables:
     vector<vector<Entity*>>* map;
-    vector<vector<Entity*>>* oldMap;
+    vector<vector<Entity*>>* oldMap;   //map the current tick reads from, while updating
+    vector<vector<Entity*>>* nextMap;  //map the current tick writes to, while updating
+    vector<vector<Entity*>>* spareMap; //last tick's oldMap, emptied and reused as the next nextMap
+    //One bit-plane per Species for map and for nextMap, so every cell is set in exactly one
+    //plane of each, then the FREE plane: EMPTY without the covered cells. DomainRunner writes
+    //the halo rows straight into oldMap, so those two rows of a strip's planes are out of date.
+    vector<OccupancyMap> layers;
+    vector<OccupancyMap> nextLayers;
+    //Cells covered by a footprint bigger than 1 by 1 (its own cell included). Footprints only
+    //change when bigger Entities are placed or beaten, so this is shared by every tick.
+    OccupancyMap* covered;
+    static vector<int> footprintWidths;   //by Species
+    static vector<int> footprintHeights;
+    Perception* perception;               //what every cell of oldMap sees, if there is a stencil
+    static StencilShape perceptionShape;
+    static int perceptionRadius;
+    CoarseBlocks* blocks;                 //nullptr until there is a focus
+    bool focused;
+    bool focusChanged;                    //applyFocus() has work to do
+    int focusRow;
+    int focusCol;
+    int focusRows;
+    int focusCols;
+    vector<Arrival> arrivals;             //scratch for updateBlocks()
+    long unplaced;                        //see getUnplaced()
+    vector<int> cellScratch;              //scratch lists of cells, row * size + col
+    bool updating;
+    int sliceRow; //next cell to update in the current tick
+    int sliceCol;
+    double tickMs;                 //time spent on the slices of the current tick so far
+    vector<long> speciesCount;     //Entities of each Species seen so far this tick
+    static const int SLICE_CHECK = 64; //cells updated between clock checks
     const int row = 100;
     const int col = 100;
     const int startEntNum = 25; //Starting number of entities
     int size;
+    int rowOffset;   //world row of the first row this Model owns
+    int firstRow;    //map row of the first owned row, 1 if there is a ghost row above it
+    int ownedRows;   //number of rows this Model updates
+    long tick;       //number of committed ticks
     const int centerX = row/2;
     const int centerY = col/2;
     int tigerNum;
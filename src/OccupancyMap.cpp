@@ -0,0 +1,309 @@
+/*Joshua Lindquist & Sarah Allen
+CS132 Winter 2022
+Final Project: Simulation
+
+Cpp file for the OccupancyMap class*/
+
+#include "OccupancyMap.h"
+#include <algorithm>
+
+OccupancyMap::OccupancyMap(int rows, int cols) {
+    this->rows = rows;
+    this->cols = cols;
+    words = (cols + 63) / 64;
+    bits.assign((size_t) rows * words, 0);
+    summaryWords = (words + 63) / 64;
+    summary.assign((size_t) rows * summaryWords, 0);
+    rowCounts.assign(rows, 0);
+    tileCounts.assign((rows + 63) / 64, 0);
+}
+
+void OccupancyMap::setRect(int row, int col, int rowCount, int colCount) {
+    rect(row, col, rowCount, colCount, SET);
+}
+
+void OccupancyMap::clearRect(int row, int col, int rowCount, int colCount) {
+    rect(row, col, rowCount, colCount, CLEAR);
+}
+
+int OccupancyMap::count(int row, int col, int rowCount, int colCount) const {
+    //Counting doesn't change anything, it just shares the walk with the other two
+    return const_cast<OccupancyMap*>(this)->rect(row, col, rowCount, colCount, COUNT);
+}
+
+bool OccupancyMap::any(int row, int col, int rowCount, int colCount) const {
+    return count(row, col, rowCount, colCount) > 0;
+}
+
+void OccupancyMap::clearAll() {
+    fill(bits.begin(), bits.end(), 0);
+    fill(summary.begin(), summary.end(), 0);
+    fill(rowCounts.begin(), rowCounts.end(), 0);
+    fill(tileCounts.begin(), tileCounts.end(), 0);
+}
+
+void OccupancyMap::setAll() {
+    fill(bits.begin(), bits.end(), ~(uint64_t) 0);
+    for (int row = 0; row < rows; row++) {
+        bits[(size_t) row * words + words - 1] &= lastMask();
+    }
+    reindex(0, rows);
+}
+
+int OccupancyMap::count() const {
+    int total = 0;
+    for (int tileCount : tileCounts) {
+        total += tileCount;
+    }
+    return total;
+}
+
+bool OccupancyMap::nearest(int row, int col, int& foundRow, int& foundCol) const {
+    //Rows further away than the best cell so far can't have anything closer
+    int best = -1;
+    for (int d = 0; d <= rows / 2 && (best < 0 || d < best); d++) {
+        for (int r : {(row - d + rows) % rows, (row + d) % rows}) {
+            if (rowCounts[r] == 0) {
+                continue;
+            }
+            int found;
+            int distance = d + nearestInRow(r, col, found);
+            if (best < 0 || distance < best) {
+                best = distance;
+                foundRow = r;
+                foundCol = found;
+            }
+        }
+    }
+    return best >= 0;
+}
+
+bool OccupancyMap::pick(unsigned long long draw, int& row, int& col) const {
+    int total = count();
+    if (total == 0) {
+        return false;
+    }
+    //Skip whole tiles, then whole rows, then whole words, then bits
+    int left = draw % total;
+    int tile = 0;
+    while (left >= tileCounts[tile]) {
+        left -= tileCounts[tile++];
+    }
+    row = tile << 6;
+    while (left >= rowCounts[row]) {
+        left -= rowCounts[row++];
+    }
+    const uint64_t* line = &bits[(size_t) row * words];
+    int word = 0;
+    while (left >= __builtin_popcountll(line[word])) {
+        left -= __builtin_popcountll(line[word++]);
+    }
+    uint64_t bitsLeft = line[word];
+    for (; left > 0; left--) {
+        bitsLeft &= bitsLeft - 1;
+    }
+    col = (word << 6) + __builtin_ctzll(bitsLeft);
+    return true;
+}
+
+OccupancyMap OccupancyMap::shifted(Direction dir) const {
+    OccupancyMap result(rows, cols);
+    for (int row = 0; row < rows; row++) {
+        uint64_t* out = &result.bits[(size_t) row * words];
+        if (dir == EAST || dir == WEST) {
+            //Rows move as a whole
+            int from = dir == EAST ? (row + 1) % rows : (row - 1 + rows) % rows;
+            const uint64_t* in = &bits[(size_t) from * words];
+            copy(in, in + words, out);
+            continue;
+        }
+        const uint64_t* in = &bits[(size_t) row * words];
+        int last = words - 1;
+        if (dir == SOUTH) {
+            //Cell col takes col + 1: every bit moves down one, the first one wraps to the end
+            for (int i = 0; i < last; i++) {
+                out[i] = (in[i] >> 1) | (in[i + 1] << 63);
+            }
+            out[last] = in[last] >> 1;
+            out[(cols - 1) >> 6] |= (in[0] & 1) << ((cols - 1) & 63);
+        } else if (dir == NORTH) {
+            //Cell col takes col - 1: every bit moves up one, the last one wraps to the start
+            for (int i = last; i > 0; i--) {
+                out[i] = (in[i] << 1) | (in[i - 1] >> 63);
+            }
+            out[0] = in[0] << 1;
+            out[0] |= (in[(cols - 1) >> 6] >> ((cols - 1) & 63)) & 1;
+            out[last] &= lastMask();
+        } else {
+            copy(in, in + words, out);
+        }
+    }
+    result.reindex(0, rows);
+    return result;
+}
+
+OccupancyMap& OccupancyMap::operator&=(const OccupancyMap& other) {
+    for (size_t i = 0; i < bits.size(); i++) {
+        bits[i] &= other.bits[i];
+    }
+    reindex(0, rows);
+    return *this;
+}
+
+OccupancyMap& OccupancyMap::operator|=(const OccupancyMap& other) {
+    for (size_t i = 0; i < bits.size(); i++) {
+        bits[i] |= other.bits[i];
+    }
+    reindex(0, rows);
+    return *this;
+}
+
+OccupancyMap& OccupancyMap::andNot(const OccupancyMap& other) {
+    for (size_t i = 0; i < bits.size(); i++) {
+        bits[i] &= ~other.bits[i];
+    }
+    reindex(0, rows);
+    return *this;
+}
+
+OccupancyMap& OccupancyMap::invert() {
+    for (size_t i = 0; i < bits.size(); i++) {
+        bits[i] = ~bits[i];
+    }
+    for (int row = 0; row < rows; row++) {
+        bits[(size_t) row * words + words - 1] &= lastMask();
+    }
+    reindex(0, rows);
+    return *this;
+}
+
+uint64_t OccupancyMap::lastMask() const {
+    int used = cols - ((words - 1) << 6);
+    return used == 64 ? ~(uint64_t) 0 : ((uint64_t) 1 << used) - 1;
+}
+
+void OccupancyMap::reindex(int first, int count) {
+    for (int i = 0; i < min(count, rows); i++) {
+        int row = (first + i) % rows;
+        const uint64_t* line = &bits[(size_t) row * words];
+        int total = 0;
+        for (int word = 0; word < words; word++) {
+            markWord(row, word, line[word] != 0);
+            total += __builtin_popcountll(line[word]);
+        }
+        tileCounts[row >> 6] += total - rowCounts[row];
+        rowCounts[row] = total;
+    }
+}
+
+int OccupancyMap::nextWord(int row, int word) const {
+    const uint64_t* marks = &summary[(size_t) row * summaryWords];
+    for (int i = word >> 6; i < summaryWords; i++) {
+        uint64_t left = marks[i];
+        if (i == word >> 6) {
+            left &= ~(uint64_t) 0 << (word & 63);
+        }
+        if (left != 0) {
+            return (i << 6) + __builtin_ctzll(left);
+        }
+    }
+    return -1;
+}
+
+int OccupancyMap::previousWord(int row, int word) const {
+    const uint64_t* marks = &summary[(size_t) row * summaryWords];
+    for (int i = word >> 6; i >= 0; i--) {
+        uint64_t left = marks[i];
+        if (i == word >> 6 && (word & 63) < 63) {
+            left &= ((uint64_t) 1 << ((word & 63) + 1)) - 1;
+        }
+        if (left != 0) {
+            return (i << 6) + 63 - __builtin_clzll(left);
+        }
+    }
+    return -1;
+}
+
+int OccupancyMap::nearestInRow(int row, int col, int& found) const {
+    const uint64_t* line = &bits[(size_t) row * words];
+    int word = col >> 6;
+    int bit = col & 63;
+
+    //First set cell at or after col, going round to the start if need be
+    int after;
+    uint64_t high = line[word] & (~(uint64_t) 0 << bit);
+    if (high != 0) {
+        after = (word << 6) + __builtin_ctzll(high);
+    } else {
+        int next = word + 1 < words ? nextWord(row, word + 1) : -1;
+        if (next < 0) {
+            next = nextWord(row, 0);
+        }
+        after = (next << 6) + __builtin_ctzll(line[next]);
+    }
+
+    //Last set cell at or before col, going round to the end if need be
+    int before;
+    uint64_t low = line[word] & (bit == 63 ? ~(uint64_t) 0 : ((uint64_t) 1 << (bit + 1)) - 1);
+    if (low != 0) {
+        before = (word << 6) + 63 - __builtin_clzll(low);
+    } else {
+        int previous = word > 0 ? previousWord(row, word - 1) : -1;
+        if (previous < 0) {
+            previous = previousWord(row, words - 1);
+        }
+        before = (previous << 6) + 63 - __builtin_clzll(line[previous]);
+    }
+
+    int forward = (after - col + cols) % cols;
+    int backward = (col - before + cols) % cols;
+    found = forward <= backward ? after : before;
+    return min(forward, backward);
+}
+
+int OccupancyMap::getRows() const {
+    return rows;
+}
+
+int OccupancyMap::getCols() const {
+    return cols;
+}
+
+int OccupancyMap::rect(int row, int col, int rowCount, int colCount, Op op) {
+    int total = 0;
+    int inRow = min(colCount, cols - col);
+    for (int i = 0; i < rowCount; i++) {
+        int r = (row + i) % rows;
+        total += span(r, col, inRow, op);
+        if (inRow < colCount) {
+            total += span(r, 0, colCount - inRow, op);
+        }
+    }
+    if (op != COUNT) {
+        reindex(row, rowCount);
+    }
+    return total;
+}
+
+int OccupancyMap::span(int row, int first, int count, Op op) {
+    int total = 0;
+    uint64_t* line = &bits[(size_t) row * words];
+    int end = first + count;
+    while (first < end) {
+        //The part of the span that falls in this word
+        int word = first >> 6;
+        int low = first & 63;
+        int high = min(64, end - (word << 6));
+        uint64_t mask = (high == 64 ? ~(uint64_t) 0 : ((uint64_t) 1 << high) - 1)
+                        & ~(((uint64_t) 1 << low) - 1);
+        if (op == SET) {
+            line[word] |= mask;
+        } else if (op == CLEAR) {
+            line[word] &= ~mask;
+        } else {
+            total += __builtin_popcountll(line[word] & mask);
+        }
+        first = (word + 1) << 6;
+    }
+    return total;
+}
@@ -0,0 +1,184 @@
+/*Sarah Allen & Joshua Lindquist
+CS132 Winter 2022
+Final Project: Simulation
+
+Class main author: Josh
+
+Header for the OccupancyMap class, one bit per cell of a grid that wraps around its edges like the
+Model's map. Each row is packed into 64-bit words, so asking whether a rectangle is free, or
+marking one as taken, works on whole words at a time instead of looking at every cell. Whole maps
+combine the same way: shifted() lines every cell up with its neighbor, and &, |, ~ and count()
+then answer questions like "deer with a hunter to the east" for 64 cells per instruction.
+On top of the cells the map keeps two smaller levels up to date: a bit per word saying whether
+it has anything set, and a count of set cells per row and per tile of 64 rows. With those,
+finding the nearest set cell or picking one at random skips empty words and rows wholesale, so
+it stays quick even when almost nothing is set.*/
+
+#ifndef _OCCUPANCYMAP_H
+#define _OCCUPANCYMAP_H
+
+#include <cstdint>
+#include <vector>
+#include "entitytypes.h"
+using namespace std;
+
+class OccupancyMap {
+public:
+    //Makes a map of rows by cols cells, all clear
+    OccupancyMap(int rows, int cols);
+
+    //Returns true if the cell at (row, col) is set
+    bool test(int row, int col) const;
+
+    //Sets or clears one cell
+    void set(int row, int col);
+    void reset(int row, int col);
+
+    //Sets or clears the rowCount by colCount rectangle whose first cell is (row, col). The
+    //rectangle wraps around the edges, and can't be bigger than the map.
+    void setRect(int row, int col, int rowCount, int colCount);
+    void clearRect(int row, int col, int rowCount, int colCount);
+
+    //Returns how many cells of the rectangle are set
+    int count(int row, int col, int rowCount, int colCount) const;
+
+    //Returns true if any cell of the rectangle is set
+    bool any(int row, int col, int rowCount, int colCount) const;
+
+    //Clears every cell
+    void clearAll();
+
+    //Sets every cell
+    void setAll();
+
+    //Returns how many cells of the whole map are set
+    int count() const;
+
+    //Returns a map whose cell (row, col) is this map's cell in direction dir from (row, col),
+    //wrapping around the edges the same way the Model does. So a.shifted(EAST) has a cell set
+    //wherever the cell east of it is set in a.
+    OccupancyMap shifted(Direction dir) const;
+
+    //Cell by cell and, or, and not, of two maps the same size
+    OccupancyMap& operator&=(const OccupancyMap& other);
+    OccupancyMap& operator|=(const OccupancyMap& other);
+    OccupancyMap& andNot(const OccupancyMap& other);
+
+    //Flips every cell
+    OccupancyMap& invert();
+
+    //Calls visit(row, col) for every set cell, row by row
+    template <typename F>
+    void forEach(F visit) const;
+
+    //Finds the set cell fewest steps along rows and columns from (row, col), wrapping around
+    //the edges, and puts it in foundRow and foundCol. Returns false if nothing is set.
+    bool nearest(int row, int col, int& foundRow, int& foundCol) const;
+
+    //Picks set cell number draw % count(), counting row by row, so a random draw picks one
+    //evenly. Returns false if nothing is set.
+    bool pick(unsigned long long draw, int& row, int& col) const;
+
+    int getRows() const;
+    int getCols() const;
+
+private:
+    enum Op {SET, CLEAR, COUNT};
+
+    //Does op to columns first to first+count-1 of one row, which must not wrap. Returns the
+    //number of set cells for COUNT.
+    int span(int row, int first, int count, Op op);
+
+    //Does op to every row and both halves of a rectangle that wraps around the right edge
+    int rect(int row, int col, int rowCount, int colCount, Op op);
+
+    //Returns the bits of the last word of a row that are inside the map
+    uint64_t lastMask() const;
+
+    //Marks whether word of row has anything set in the level above the cells
+    void markWord(int row, int word, bool any);
+
+    //Works out the upper levels again for rows first to first+count-1 (wrapping), after the
+    //cells were changed a word at a time
+    void reindex(int first, int count);
+
+    //Returns the first word at or after word (the last at or before it) of row that has
+    //anything set, or -1 if there isn't one
+    int nextWord(int row, int word) const;
+    int previousWord(int row, int word) const;
+
+    //Returns how many columns away the set cell of row closest to col is, and puts it in found
+    int nearestInRow(int row, int col, int& found) const;
+
+    int rows;
+    int cols;
+    int words;              //words per row
+    vector<uint64_t> bits;  //row by row, column c in bit c % 64 of word c / 64
+    int summaryWords;       //words of summary per row
+    vector<uint64_t> summary;  //row by row, bit w set if word w of the row has anything set
+    vector<int> rowCounts;     //set cells in each row
+    vector<int> tileCounts;    //set cells in each tile of 64 rows
+};
+
+inline bool OccupancyMap::test(int row, int col) const {
+    return (bits[(size_t) row * words + (col >> 6)] >> (col & 63)) & 1;
+}
+
+inline void OccupancyMap::markWord(int row, int word, bool any) {
+    uint64_t& mark = summary[(size_t) row * summaryWords + (word >> 6)];
+    uint64_t bit = (uint64_t) 1 << (word & 63);
+    mark = any ? mark | bit : mark & ~bit;
+}
+
+inline void OccupancyMap::set(int row, int col) {
+    uint64_t& word = bits[(size_t) row * words + (col >> 6)];
+    uint64_t bit = (uint64_t) 1 << (col & 63);
+    if (!(word & bit)) {
+        if (word == 0) {
+            markWord(row, col >> 6, true);
+        }
+        word |= bit;
+        rowCounts[row]++;
+        tileCounts[row >> 6]++;
+    }
+}
+
+inline void OccupancyMap::reset(int row, int col) {
+    uint64_t& word = bits[(size_t) row * words + (col >> 6)];
+    uint64_t bit = (uint64_t) 1 << (col & 63);
+    if (word & bit) {
+        word &= ~bit;
+        if (word == 0) {
+            markWord(row, col >> 6, false);
+        }
+        rowCounts[row]--;
+        tileCounts[row >> 6]--;
+    }
+}
+
+inline OccupancyMap operator&(OccupancyMap a, const OccupancyMap& b) {
+    return a &= b;
+}
+
+inline OccupancyMap operator|(OccupancyMap a, const OccupancyMap& b) {
+    return a |= b;
+}
+
+inline OccupancyMap operator~(OccupancyMap a) {
+    return a.invert();
+}
+
+template <typename F>
+void OccupancyMap::forEach(F visit) const {
+    for (int row = 0; row < rows; row++) {
+        const uint64_t* line = &bits[(size_t) row * words];
+        for (int word = 0; word < words; word++) {
+            //Skip straight from one set bit to the next
+            for (uint64_t left = line[word]; left != 0; left &= left - 1) {
+                visit(row, (word << 6) + __builtin_ctzll(left));
+            }
+        }
+    }
+}
+
+#endif
@@ -0,0 +1,115 @@
+/*Joshua Lindquist & Sarah Allen
+CS132 Winter 2022
+Final Project: Simulation
+
+Cpp file for the Perception class*/
+
+#include "Perception.h"
+#include <algorithm>
+#include <cstring>
+
+std::string to_string(StencilShape shape) {
+    switch (shape) {
+        case STENCIL_DIAMOND: return "diamond";
+        case STENCIL_SQUARE:  return "square";
+        default:              return "unknown";
+    }
+}
+int STENCIL_SHAPE_COUNT = 2;
+
+const int Perception::MAX_RADIUS;
+
+Perception::Perception(StencilShape shape, int radius, int rows, int cols) {
+    this->shape = shape;
+    this->radius = max(1, min(radius, MAX_RADIUS));
+    this->rows = rows;
+    this->cols = cols;
+    stride = cols + 2 * this->radius + 1;
+    types.assign((size_t) rows * cols, EMPTY);
+    sums.assign((size_t) SPECIES_COUNT * rows * stride, 0);
+    column.assign((size_t) SPECIES_COUNT * cols, 0);
+    padded.assign(cols + 2 * this->radius, EMPTY);
+    result.assign((size_t) rows * cols * SPECIES_COUNT, 0);
+}
+
+void Perception::compute(const vector<OccupancyMap>& layers) {
+    int k = radius;
+    for (int s = 0; s < SPECIES_COUNT; s++) {
+        layers[s].forEach([&](int row, int col) {
+            types[(size_t) row * cols + col] = s;
+        });
+    }
+
+    //Running sums of each Species along every row, starting k cells early and going k cells
+    //past the end, so the cells within j of column c add up to sums[c+k+j+1] - sums[c+k-j]
+    for (int row = 0; row < rows; row++) {
+        const unsigned char* line = &types[(size_t) row * cols];
+        for (int j = 0; j < cols + 2 * k; j++) {
+            padded[j] = line[((j - k) % cols + cols) % cols];
+        }
+        for (int s = 0; s < SPECIES_COUNT; s++) {
+            uint32_t* sum = &sums[((size_t) s * rows + row) * stride];
+            sum[0] = 0;
+            for (int j = 0; j < cols + 2 * k; j++) {
+                sum[j + 1] = sum[j] + (padded[j] == s);
+            }
+        }
+    }
+
+    //Then down the columns: a square adds the same width from every row, so each row's counts
+    //are the last row's plus the row coming in minus the row going out. A diamond is narrower
+    //the further a row is from the middle, so it adds its 2k + 1 rows up one by one.
+    auto rowSums = [&](int s, int row) -> const uint32_t* {
+        return &sums[((size_t) s * rows + ((row % rows) + rows) % rows) * stride];
+    };
+    for (int row = 0; row < rows; row++) {
+        for (int s = 0; s < SPECIES_COUNT; s++) {
+            uint16_t* count = &column[(size_t) s * cols];
+            if (shape == STENCIL_SQUARE && row > 0) {
+                const uint32_t* in = rowSums(s, row + k);
+                const uint32_t* out = rowSums(s, row - k - 1);
+                for (int c = 0; c < cols; c++) {
+                    count[c] += (in[c + 2 * k + 1] - in[c]) - (out[c + 2 * k + 1] - out[c]);
+                }
+            } else {
+                fill(count, count + cols, 0);
+                for (int dr = -k; dr <= k; dr++) {
+                    int j = shape == STENCIL_SQUARE ? k : k - abs(dr);
+                    const uint32_t* sum = rowSums(s, row + dr);
+                    for (int c = 0; c < cols; c++) {
+                        count[c] += sum[c + k + j + 1] - sum[c + k - j];
+                    }
+                }
+            }
+            unsigned char* out = &result[(size_t) row * cols * SPECIES_COUNT + s];
+            for (int c = 0; c < cols; c++) {
+                out[(size_t) c * SPECIES_COUNT] = min((int) count[c], 255);
+            }
+        }
+        //The stencil doesn't include the cell itself
+        for (int c = 0; c < cols; c++) {
+            size_t cell = (size_t) row * cols + c;
+            result[cell * SPECIES_COUNT + types[cell]]--;
+        }
+    }
+}
+
+void Perception::touching(int row, int col, unsigned char* touching) const {
+    //Clockwise from NORTH (one column back), the same way round as Direction
+    static const int rowSteps[] = {0, 1, 1, 1, 0, -1, -1, -1};
+    static const int colSteps[] = {-1, -1, 0, 1, 1, 1, 0, -1};
+    memset(touching, 0, SPECIES_COUNT);
+    for (int i = 0; i < 8; i++) {
+        int r = (row + rowSteps[i] + rows) % rows;
+        int c = (col + colSteps[i] + cols) % cols;
+        touching[types[(size_t) r * cols + c]] |= 1 << i;
+    }
+}
+
+StencilShape Perception::getShape() const {
+    return shape;
+}
+
+int Perception::getRadius() const {
+    return radius;
+}
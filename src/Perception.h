@@ -0,0 +1,75 @@
+/*Sarah Allen & Joshua Lindquist
+CS132 Winter 2022
+Final Project: Simulation
+
+Class main author: Josh
+
+Header for the Perception class, which works out what every cell of the map can see through a
+stencil bigger than the four cells getNeighbor() reports: the eight cells around it (Moore), or
+every cell within some radius as a diamond or a square. It is done for the whole map at once from
+the Model's species bit-planes, as a count of each Species per cell, using running sums along the
+rows and down the columns so a bigger radius costs little more than radius 1. Which of the eight
+touching cells hold each Species is available as a bitmask too.*/
+
+#ifndef _PERCEPTION_H
+#define _PERCEPTION_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "entitytypes.h"
+#include "OccupancyMap.h"
+using namespace std;
+
+//Shapes of stencil
+enum StencilShape {
+    STENCIL_DIAMOND,  //cells at most radius steps away going only along rows and columns;
+                      //radius 1 is the four getNeighbor() directions
+    STENCIL_SQUARE    //cells at most radius rows and radius columns away; radius 1 is Moore
+};
+std::string to_string(StencilShape shape);
+extern int STENCIL_SHAPE_COUNT;
+
+class Perception {
+public:
+    //Makes an empty Perception for a map of rows by cols cells. radius is kept between 1 and
+    //MAX_RADIUS.
+    Perception(StencilShape shape, int radius, int rows, int cols);
+
+    //Counts what is around every cell of the map whose bit-planes (one per Species, see
+    //Model::getLayer()) are layers. Cells covered by a footprint count as empty.
+    void compute(const vector<OccupancyMap>& layers);
+
+    //Returns the SPECIES_COUNT counts for the cell at (row, col) from the last compute(): how
+    //many cells of the stencil around it, not counting itself, hold each Species
+    const unsigned char* counts(int row, int col) const;
+
+    //Fills touching, SPECIES_COUNT bytes, with which of the eight cells around (row, col) hold
+    //each Species: bit 0 for NORTH, then clockwise to bit 7 for north-west
+    void touching(int row, int col, unsigned char* touching) const;
+
+    StencilShape getShape() const;
+    int getRadius() const;
+
+    //Biggest radius; a square that big still counts in a byte
+    static const int MAX_RADIUS = 7;
+
+private:
+    StencilShape shape;
+    int radius;
+    int rows;
+    int cols;
+    int stride;                //length of one row of sums
+    vector<unsigned char> types;   //Species of every cell
+    vector<uint32_t> sums;         //by Species and row, running sums along the row, which
+                                   //starts radius cells early and wraps around
+    vector<uint16_t> column;       //counts of one Species for one row while adding up rows
+    vector<unsigned char> padded;  //one row of types, starting radius cells early and wrapping
+    vector<unsigned char> result;  //SPECIES_COUNT counts per cell
+};
+
+inline const unsigned char* Perception::counts(int row, int col) const {
+    return &result[((size_t) row * cols + col) * SPECIES_COUNT];
+}
+
+#endif
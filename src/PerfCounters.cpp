@@ -0,0 +1,247 @@
+/*Joshua Lindquist & Sarah Allen
+CS132 Winter 2022
+Final Project: Simulation
+
+Cpp file for the PerfCounters class*/
+
+#include "PerfCounters.h"
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+std::string to_string(HardwareCounter counter) {
+    switch (counter) {
+        case COUNTER_CYCLES:        return "cycles";
+        case COUNTER_INSTRUCTIONS:  return "instructions";
+        case COUNTER_L1D_MISSES:    return "l1d_misses";
+        case COUNTER_LLC_MISSES:    return "llc_misses";
+        case COUNTER_BRANCH_MISSES: return "branch_misses";
+        default:                    return "unknown";
+    }
+}
+int HARDWARE_COUNTER_COUNT = 5;
+
+std::string to_string(TickPhase phase) {
+    switch (phase) {
+        case PHASE_BEGIN:  return "begin";
+        case PHASE_MOVE:   return "move";
+        case PHASE_BLOCKS: return "blocks";
+        case PHASE_COMMIT: return "commit";
+        default:           return "unknown";
+    }
+}
+int TICK_PHASE_COUNT = 4;
+
+const int PerfCounters::MAX_COUNTERS;
+
+PerfCounters* PerfCounters::_instance = nullptr;
+string PerfCounters::_runPath = "";
+atomic<bool> PerfCounters::enabled(false);
+
+PerfCounters::ThreadCounters::ThreadCounters() {
+    for (int i = 0; i < MAX_COUNTERS; i++) {
+        files[i] = -1;
+    }
+#ifdef __linux__
+    //Each counter is opened on its own, so one the CPU doesn't have doesn't take the rest with it
+    unsigned long long configs[MAX_COUNTERS][2] = {
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+        {PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+                             | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+        {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES}
+    };
+    for (int i = 0; i < HARDWARE_COUNTER_COUNT; i++) {
+        perf_event_attr attr = perf_event_attr();
+        attr.size = sizeof(attr);
+        attr.type = configs[i][0];
+        attr.config = configs[i][1];
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        //With more counters than the CPU has, the kernel takes turns; these say how long each
+        //one really counted
+        attr.read_format = PERF_FORMAT_TOTAL_TIME_ENABLED | PERF_FORMAT_TOTAL_TIME_RUNNING;
+        files[i] = syscall(__NR_perf_event_open, &attr, 0, -1, -1, PERF_FLAG_FD_CLOEXEC);
+    }
+#endif
+}
+
+PerfCounters::ThreadCounters::~ThreadCounters() {
+#ifdef __linux__
+    for (int i = 0; i < MAX_COUNTERS; i++) {
+        if (files[i] >= 0) {
+            close(files[i]);
+        }
+    }
+#endif
+}
+
+PerfCounters::PerfCounters() {
+    for (int i = 0; i < MAX_COUNTERS; i++) {
+        available[i] = false;
+    }
+    totals.assign(TICK_PHASE_COUNT * MAX_COUNTERS, 0);
+    entityUpdates = 0;
+}
+
+PerfCounters* PerfCounters::instance() {
+    if (!_instance) {
+        _instance = new PerfCounters();
+    }
+    return _instance;
+}
+
+PerfCounters::ThreadCounters* PerfCounters::local() {
+    thread_local ThreadCounters counters;
+    return &counters;
+}
+
+bool PerfCounters::enable() {
+    ThreadCounters* counters = local();
+    bool any = false;
+    for (int i = 0; i < HARDWARE_COUNTER_COUNT; i++) {
+        available[i] = counters->files[i] >= 0;
+        any = any || available[i];
+    }
+    enabled = any;
+    return any;
+}
+
+bool PerfCounters::isAvailable(HardwareCounter counter) {
+    return available[counter];
+}
+
+void PerfCounters::read(Sample& sample) {
+    sample.valid = isEnabled();
+    for (int i = 0; i < MAX_COUNTERS; i++) {
+        sample.values[i] = 0;
+    }
+    if (!sample.valid) {
+        return;
+    }
+#ifdef __linux__
+    ThreadCounters* counters = local();
+    for (int i = 0; i < HARDWARE_COUNTER_COUNT; i++) {
+        unsigned long long reading[3];  //value, time enabled, time running
+        if (counters->files[i] < 0
+                || ::read(counters->files[i], reading, sizeof(reading)) != sizeof(reading)) {
+            continue;
+        }
+        sample.values[i] = reading[2] == 0 ? 0 : reading[2] >= reading[1] ? reading[0]
+                         : (unsigned long long) ((double) reading[0] * reading[1] / reading[2]);
+    }
+#endif
+}
+
+void PerfCounters::add(TickPhase phase, const Sample& start) {
+    if (!start.valid) {
+        return;
+    }
+    Sample end;
+    read(end);
+    PerfCounters* all = instance();
+    lock_guard<mutex> lock(all->totalMutex);
+    for (int i = 0; i < HARDWARE_COUNTER_COUNT; i++) {
+        //A scaled estimate can come out a little lower than the one before it
+        if (end.values[i] > start.values[i]) {
+            all->totals[phase * MAX_COUNTERS + i] += end.values[i] - start.values[i];
+        }
+    }
+}
+
+void PerfCounters::addEntityUpdates(long updates) {
+    lock_guard<mutex> lock(totalMutex);
+    entityUpdates += updates;
+}
+
+unsigned long long PerfCounters::getTotal(TickPhase phase, HardwareCounter counter) {
+    lock_guard<mutex> lock(totalMutex);
+    return totals[phase * MAX_COUNTERS + counter];
+}
+
+double PerfCounters::getPerEntityUpdate(TickPhase phase, HardwareCounter counter) {
+    lock_guard<mutex> lock(totalMutex);
+    if (entityUpdates == 0) {
+        return 0;
+    }
+    return (double) totals[phase * MAX_COUNTERS + counter] / entityUpdates;
+}
+
+string PerfCounters::toPrometheus() {
+    if (!isEnabled()) {
+        return "";
+    }
+    ostringstream out;
+    out.precision(15);
+    out << "# HELP sim_hardware_counter_available Whether each hardware counter could be opened.\n";
+    out << "# TYPE sim_hardware_counter_available gauge\n";
+    for (int c = 0; c < HARDWARE_COUNTER_COUNT; c++) {
+        out << "sim_hardware_counter_available{counter=\"" << to_string((HardwareCounter) c)
+            << "\"} " << (available[c] ? 1 : 0) << "\n";
+    }
+    lock_guard<mutex> lock(totalMutex);
+    out << "# HELP sim_entity_updates_total Entities updated since the simulation started.\n";
+    out << "# TYPE sim_entity_updates_total counter\n";
+    out << "sim_entity_updates_total " << entityUpdates << "\n";
+    out << "# HELP sim_tick_phase_events_total Hardware events counted during each phase of a tick.\n";
+    out << "# TYPE sim_tick_phase_events_total counter\n";
+    for (int p = 0; p < TICK_PHASE_COUNT; p++) {
+        for (int c = 0; c < HARDWARE_COUNTER_COUNT; c++) {
+            if (available[c]) {
+                out << "sim_tick_phase_events_total{phase=\"" << to_string((TickPhase) p)
+                    << "\",counter=\"" << to_string((HardwareCounter) c) << "\"} "
+                    << totals[p * MAX_COUNTERS + c] << "\n";
+            }
+        }
+    }
+    out << "# HELP sim_tick_phase_events_per_entity_update Hardware events per Entity updated.\n";
+    out << "# TYPE sim_tick_phase_events_per_entity_update gauge\n";
+    for (int p = 0; p < TICK_PHASE_COUNT && entityUpdates > 0; p++) {
+        for (int c = 0; c < HARDWARE_COUNTER_COUNT; c++) {
+            if (available[c]) {
+                out << "sim_tick_phase_events_per_entity_update{phase=\""
+                    << to_string((TickPhase) p) << "\",counter=\""
+                    << to_string((HardwareCounter) c) << "\"} "
+                    << (double) totals[p * MAX_COUNTERS + c] / entityUpdates << "\n";
+            }
+        }
+    }
+    return out.str();
+}
+
+bool PerfCounters::writeRun(const string& path) {
+    ofstream file(path);
+    if (!file.good()) {
+        return false;
+    }
+    file << "phase,counter,total,per_entity_update" << endl;
+    lock_guard<mutex> lock(totalMutex);
+    for (int p = 0; p < TICK_PHASE_COUNT; p++) {
+        for (int c = 0; c < HARDWARE_COUNTER_COUNT; c++) {
+            if (!available[c]) {
+                continue;
+            }
+            unsigned long long total = totals[p * MAX_COUNTERS + c];
+            file << to_string((TickPhase) p) << "," << to_string((HardwareCounter) c) << ","
+                 << total << "," << (entityUpdates == 0 ? 0 : (double) total / entityUpdates)
+                 << endl;
+        }
+    }
+    return file.good();
+}
+
+void PerfCounters::writeRunAtExit(const string& path) {
+    if (_runPath == "") {
+        atexit([] {
+            instance()->writeRun(_runPath);
+        });
+    }
+    _runPath = path;
+}
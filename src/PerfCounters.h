@@ -0,0 +1,126 @@
+/*Sarah Allen & Joshua Lindquist
+CS132 Winter 2022
+Final Project: Simulation
+
+Class main author: Josh
+
+Header for the PerfCounters class, which reads the CPU's hardware counters (cycles, instructions,
+cache misses and branch misses) around each phase of a tick, so a change to the Model can be
+judged by what it did to the caches and branch predictor and not just by the clock. The totals
+are divided by the number of Entities updated, exported with the other Metrics and can be
+written out at the end of a run.
+
+The counters come from Linux's perf_event_open() and only count this process in user mode. They
+are off until enable() is called. A counter the CPU or kernel doesn't offer (in a VM, or with
+kernel.perf_event_paranoid set too high) is left out and reported as unavailable; if none of them
+can be opened, or on other platforms, everything still runs and only the counters are missing.*/
+
+#ifndef _PERFCOUNTERS_H
+#define _PERFCOUNTERS_H
+
+#include <atomic>
+#include <mutex>
+#include <string>
+#include <vector>
+using namespace std;
+
+//The hardware events counted
+enum HardwareCounter {
+    COUNTER_CYCLES,
+    COUNTER_INSTRUCTIONS,
+    COUNTER_L1D_MISSES,     //level 1 data cache read misses
+    COUNTER_LLC_MISSES,     //last level cache misses
+    COUNTER_BRANCH_MISSES
+};
+std::string to_string(HardwareCounter counter);
+extern int HARDWARE_COUNTER_COUNT;
+
+//The parts of Model::stepUpdate() counted separately
+enum TickPhase {
+    PHASE_BEGIN,   //beginTick(): perception, clearing the next map
+    PHASE_MOVE,    //deciding and resolving every Entity's move
+    PHASE_BLOCKS,  //stepping the coarse blocks outside the focus window
+    PHASE_COMMIT   //commitUpdate(): swapping maps, recording and metrics
+};
+std::string to_string(TickPhase phase);
+extern int TICK_PHASE_COUNT;
+
+class PerfCounters {
+public:
+    static const int MAX_COUNTERS = 5;
+
+    //The counters' values at one moment, on one thread
+    struct Sample {
+        bool valid;  //false if the counters were off when it was taken
+        unsigned long long values[MAX_COUNTERS];
+    };
+
+    //Returns the single PerfCounters object for this process, creating it if needed
+    static PerfCounters* instance();
+
+    //Turns the counters on. Returns false if none of them could be opened, and then they stay
+    //off.
+    bool enable();
+
+    //Returns true once enable() has succeeded. A single relaxed load, so cheap enough to ask
+    //on every phase.
+    static bool isEnabled();
+
+    //Returns true if counter could be opened
+    bool isAvailable(HardwareCounter counter);
+
+    //Reads the calling thread's counters into sample, or marks it invalid if they are off
+    static void read(Sample& sample);
+
+    //Adds everything the calling thread counted since start to phase
+    static void add(TickPhase phase, const Sample& start);
+
+    //Adds updates Entity updates to the total the counts are divided by. The Model calls this
+    //when a tick is committed.
+    void addEntityUpdates(long updates);
+
+    //Returns the total count of counter during phase since the run started
+    unsigned long long getTotal(TickPhase phase, HardwareCounter counter);
+
+    //Returns getTotal() divided by the Entity updates so far, 0 before there are any
+    double getPerEntityUpdate(TickPhase phase, HardwareCounter counter);
+
+    //Returns the run totals and per Entity update rates in the Prometheus text format, for
+    //Metrics to export. Empty while the counters are off.
+    string toPrometheus();
+
+    //Writes phase,counter,total,per_entity_update lines. Returns false if the file failed.
+    bool writeRun(const string& path);
+
+    //Calls writeRun(path) when the program exits
+    void writeRunAtExit(const string& path);
+
+private:
+    PerfCounters();
+
+    //One thread's open counters, -1 for the ones that couldn't be opened. Closed when the
+    //thread ends.
+    struct ThreadCounters {
+        int files[MAX_COUNTERS];
+        ThreadCounters();
+        ~ThreadCounters();
+    };
+
+    //Returns the calling thread's counters, opening them on first use
+    static ThreadCounters* local();
+
+    static PerfCounters* _instance;
+    static string _runPath;
+    static atomic<bool> enabled;
+
+    atomic<bool> available[MAX_COUNTERS];
+    mutex totalMutex;
+    vector<unsigned long long> totals;  //by phase, MAX_COUNTERS each
+    long long entityUpdates;
+};
+
+inline bool PerfCounters::isEnabled() {
+    return enabled.load(memory_order_relaxed);
+}
+
+#endif
@@ -0,0 +1,142 @@
+/*Joshua Lindquist & Sarah Allen
+CS132 Winter 2022
+Final Project: Simulation
+
+Cpp file for the PopulationChart class*/
+
+#include "PopulationChart.h"
+#include <algorithm>
+
+const int PopulationChart::KEEP;
+
+PopulationChart::PopulationChart(int width, int height) {
+    //Wider than KEEP would need a level that has been dropped
+    this->width = max(1, min(width, KEEP));
+    this->height = max(2, height);
+    length = 0;
+    highest = 0;
+    canvas = new GCanvas(this->width, this->height, "white");
+    //Everything is drawn at once in draw(), then shown with one repaint
+    canvas->setAutoRepaint(false);
+    canvas->setFont("Arial-9");
+}
+
+PopulationChart::~PopulationChart() {
+    delete canvas;
+}
+
+GCanvas* PopulationChart::getCanvas() {
+    return canvas;
+}
+
+int PopulationChart::addSeries(const string& color) {
+    Series line;
+    line.color = color;
+    series.push_back(line);
+    return series.size() - 1;
+}
+
+void PopulationChart::addPoint(const vector<double>& values) {
+    for (int i = 0; i < series.size() && i < values.size(); i++) {
+        float value = values[i];
+        push(series[i], 0, Bucket {value, value, value, value});
+        highest = max(highest, values[i]);
+    }
+    length++;
+}
+
+void PopulationChart::reset() {
+    for (Series& line : series) {
+        line.levels.clear();
+    }
+    length = 0;
+    highest = 0;
+}
+
+long PopulationChart::getLength() {
+    return length;
+}
+
+void PopulationChart::push(Series& series, int level, const Bucket& bucket) {
+    //Every second bucket of a level finishes one of the level above, and so on up
+    Bucket next = bucket;
+    for (bool carry = true; carry; level++) {
+        if (level == series.levels.size()) {
+            series.levels.push_back(Level {vector<Bucket>(), next, false, false});
+        }
+        Level& here = series.levels[level];
+        if (!here.dropped) {
+            here.buckets.push_back(next);
+            if (here.buckets.size() > KEEP) {
+                here.dropped = true;
+                vector<Bucket>().swap(here.buckets);
+            }
+        }
+        carry = here.hasPending;
+        if (carry) {
+            next = merge(here.pending, next);
+        } else {
+            here.pending = next;
+        }
+        here.hasPending = !carry;
+    }
+}
+
+PopulationChart::Bucket PopulationChart::merge(const Bucket& a, const Bucket& b) {
+    return Bucket {a.first, b.last, min(a.low, b.low), max(a.high, b.high)};
+}
+
+void PopulationChart::draw() {
+    canvas->clear();
+    if (length == 0 || highest <= 0) {
+        canvas->repaint();
+        return;
+    }
+    //The finest level that fits one bucket per pixel
+    int level = 0;
+    while ((length >> level) > width) {
+        level++;
+    }
+    long whole = (length >> level) << level;  //ticks covered by finished buckets of level
+    double xScale = (double) width / length;
+    double yScale = (height - 1) / highest;
+
+    for (Series& line : series) {
+        if (level >= line.levels.size()) {
+            continue;
+        }
+        //The last few ticks haven't made a whole bucket of level yet; they are waiting in the
+        //levels below it, older ones higher up
+        const vector<Bucket>& buckets = line.levels[level].buckets;
+        bool hasTail = false;
+        Bucket tail = Bucket {0, 0, 0, 0};
+        for (int below = level - 1; below >= 0; below--) {
+            const Level& part = line.levels[below];
+            if (part.hasPending) {
+                tail = hasTail ? merge(tail, part.pending) : part.pending;
+                hasTail = true;
+            }
+        }
+
+        canvas->setColor(line.color);
+        double lastX = 0;
+        double lastY = 0;
+        for (int i = 0; i <= buckets.size(); i++) {
+            if (i == buckets.size() && !hasTail) {
+                break;
+            }
+            const Bucket& b = i < buckets.size() ? buckets[i] : tail;
+            double x = (i < buckets.size() ? (double) ((long) i << level) : whole) * xScale;
+            double firstY = height - 1 - b.first * yScale;
+            if (i > 0) {
+                canvas->drawLine(lastX, lastY, x, firstY);
+            }
+            canvas->drawLine(x, height - 1 - b.low * yScale, x, height - 1 - b.high * yScale);
+            lastX = x;
+            lastY = height - 1 - b.last * yScale;
+        }
+    }
+    canvas->setColor("black");
+    canvas->drawString(to_string((long) highest), 2, 10);
+    canvas->repaint();
+}
@@ -0,0 +1,86 @@
+/*Sarah Allen & Joshua Lindquist
+CS132 Winter 2022
+Final Project: Simulation
+
+Class main author: Sarah
+
+Header for the PopulationChart class, a canvas that plots how many of each Species there have
+been over the whole run. Every series keeps its history as a pyramid: level 0 holds one bucket
+per tick, and each level above holds one bucket per two of the level below, with the first,
+last, lowest and highest value in it. Adding a tick only ever finishes one bucket per level, so
+it is cheap no matter how long the run has been, and drawing picks the finest level with no more
+buckets than the chart is pixels wide. A bucket is drawn as a line from the last bucket's last
+value to its first, and one from its lowest to its highest, which looks the same as drawing every
+tick but costs the same after ten million ticks as after ten.*/
+
+#ifndef _POPULATIONCHART_H
+#define _POPULATIONCHART_H
+
+#include <string>
+#include <vector>
+#include "gcanvas.h"
+using namespace std;
+using namespace sgl;
+
+class PopulationChart {
+public:
+    //Makes an empty chart width by height pixels
+    PopulationChart(int width, int height);
+    ~PopulationChart();
+
+    //Returns the canvas the chart is drawn on, to add to a window
+    GCanvas* getCanvas();
+
+    //Adds a line to the chart drawn in color. Returns its number for addPoint().
+    int addSeries(const string& color);
+
+    //Adds the next tick to every series, values[i] to series i
+    void addPoint(const vector<double>& values);
+
+    //Forgets every point, keeping the series
+    void reset();
+
+    //Returns the number of points added to each series
+    long getLength();
+
+    //Clears the canvas and draws every series
+    void draw();
+
+private:
+    struct Bucket {
+        float first;
+        float last;
+        float low;
+        float high;
+    };
+
+    struct Level {
+        vector<Bucket> buckets;  //finished buckets, unless dropped
+        Bucket pending;          //first half of the next bucket of the level above
+        bool hasPending;
+        bool dropped;            //too long to ever be drawn, so no longer kept
+    };
+
+    struct Series {
+        string color;
+        vector<Level> levels;
+    };
+
+    //Adds bucket to level of series and finishes a bucket of the level above if it can
+    void push(Series& series, int level, const Bucket& bucket);
+
+    //Returns a and b, in that order, as one bucket
+    static Bucket merge(const Bucket& a, const Bucket& b);
+
+    //Levels with more buckets than this are dropped; no chart is wide enough to draw them
+    static const int KEEP = 1 << 14;
+
+    GCanvas* canvas;
+    int width;
+    int height;
+    vector<Series> series;
+    long length;
+    double highest;  //biggest value so far, the top of the chart
+};
+
+#endif
@@ -0,0 +1,226 @@
+/*Joshua Lindquist & Sarah Allen
+CS132 Winter 2022
+Final Project: Simulation
+
+Cpp file for the SaveLoader class*/
+
+#include "SaveLoader.h"
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <thread>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+//The characters >> skips between words
+static inline bool blank(char c) {
+    return c == ' ' || (c >= '\t' && c <= '\r');
+}
+
+SaveLoader::SaveLoader(const string& path) {
+    text = nullptr;
+    length = 0;
+    body = 0;
+    mapped = false;
+    windowSize = 0;
+    squareSize = 0;
+    open = false;
+
+#ifndef _WIN32
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return;
+    }
+    struct stat info;
+    if (fstat(fd, &info) == 0 && info.st_size > 0) {
+        void* memory = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (memory != MAP_FAILED) {
+            madvise(memory, info.st_size, MADV_SEQUENTIAL);
+            text = (const char*) memory;
+            length = info.st_size;
+            mapped = true;
+        }
+    }
+    close(fd);
+#endif
+    if (!mapped) {
+        ifstream file(path, ios::binary);
+        if (!file.good()) {
+            return;
+        }
+        buffer.assign(istreambuf_iterator<char>(file), istreambuf_iterator<char>());
+        text = buffer.data();
+        length = buffer.size();
+    }
+    open = readHeader();
+}
+
+SaveLoader::~SaveLoader() {
+#ifndef _WIN32
+    if (mapped) {
+        munmap((void*) text, length);
+    }
+#endif
+}
+
+bool SaveLoader::isOpen() {
+    return open;
+}
+
+int SaveLoader::getWindowSize() {
+    return windowSize;
+}
+
+int SaveLoader::getSquareSize() {
+    return squareSize;
+}
+
+int SaveLoader::getSize() {
+    return windowSize / squareSize;
+}
+
+bool SaveLoader::readHeader() {
+    //The same as reading two ints with >>
+    size_t at = 0;
+    int* sizes[] = {&windowSize, &squareSize};
+    for (int* value : sizes) {
+        while (at < length && blank(text[at])) {
+            at++;
+        }
+        bool negative = at < length && text[at] == '-';
+        if (at < length && (text[at] == '-' || text[at] == '+')) {
+            at++;
+        }
+        if (at == length || text[at] < '0' || text[at] > '9') {
+            return false;
+        }
+        long number = 0;
+        while (at < length && text[at] >= '0' && text[at] <= '9' && number < 1000000000L) {
+            number = number * 10 + (text[at++] - '0');
+        }
+        *value = negative ? -number : number;
+    }
+    body = at;
+    return windowSize >= 0 && squareSize > 0;
+}
+
+int SaveLoader::lookup(const char* word, size_t length) {
+    //The old loader took "X," and "{X," and "X}" for every name X, and nothing else
+    if (length >= 2 && word[0] == '{') {
+        if (word[length - 1] != ',') {
+            return -1;
+        }
+        word++;
+        length -= 2;
+    } else if (length >= 1 && (word[length - 1] == ',' || word[length - 1] == '}')) {
+        length--;
+    } else {
+        return -1;
+    }
+    if (length == 0) {
+        return -1;
+    }
+
+    //The first letter and the length pick a different slot for each of the names
+    struct Name {
+        const char* text;
+        size_t length;
+        int species;
+    };
+    static const vector<Name> table = [] {
+        vector<Name> slots(16, Name {"", 0, -1});
+        static const Species named[] = {EMPTY, BUILDING, DEER, HUNTER, LUMBERJACK, TIGER, TREE};
+        static string names[7];
+        for (int i = 0; i < 7; i++) {
+            names[i] = to_string(named[i]);
+            size_t slot = (((unsigned char) names[i][0] * 7 + names[i].size() * 3) >> 1) & 15;
+            slots[slot] = Name {names[i].c_str(), names[i].size(), named[i]};
+        }
+        return slots;
+    }();
+    const Name& name = table[(((unsigned char) word[0] * 7 + length * 3) >> 1) & 15];
+    if (name.length != length || memcmp(name.text, word, length) != 0) {
+        return -1;
+    }
+    return name.species;
+}
+
+size_t SaveLoader::countWords(size_t begin, size_t end) {
+    //A word starts wherever something that isn't blank follows a blank
+    size_t words = begin < end && !blank(text[begin]) ? 1 : 0;
+    for (size_t i = begin + 1; i < end; i++) {
+        words += blank(text[i - 1]) && !blank(text[i]);
+    }
+    return words;
+}
+
+void SaveLoader::parseWords(size_t begin, size_t end, size_t first, vector<unsigned char>& grid) {
+    size_t cell = first;
+    size_t at = begin;
+    while (at < end && cell < grid.size()) {
+        while (at < end && blank(text[at])) {
+            at++;
+        }
+        size_t start = at;
+        while (at < end && !blank(text[at])) {
+            at++;
+        }
+        if (at > start) {
+            int species = lookup(text + start, at - start);
+            grid[cell++] = species < 0 ? EMPTY : species;
+        }
+    }
+}
+
+void SaveLoader::parse(vector<unsigned char>& grid, int threads) {
+    int size = getSize();
+    grid.assign((size_t) size * size, EMPTY);
+    if (threads <= 0) {
+        threads = thread::hardware_concurrency();
+    }
+    if (threads <= 0) {
+        threads = 1;
+    }
+
+    //Pieces end on a blank, so no word is split between two of them
+    vector<size_t> bounds(threads + 1);
+    size_t span = length - body;
+    for (int i = 0; i <= threads; i++) {
+        size_t at = body + span * i / threads;
+        while (i > 0 && at < length && !blank(text[at])) {
+            at++;
+        }
+        bounds[i] = max(at, i > 0 ? bounds[i - 1] : body);
+    }
+
+    //Count each piece's words to find the cell its first word is for, then fill the cells in
+    vector<size_t> firsts(threads + 1, 0);
+    vector<thread> workers;
+    for (int i = 0; i < threads; i++) {
+        workers.push_back(thread([this, &bounds, &firsts, i] {
+            firsts[i + 1] = countWords(bounds[i], bounds[i + 1]);
+        }));
+    }
+    for (thread& worker : workers) {
+        worker.join();
+    }
+    for (int i = 0; i < threads; i++) {
+        firsts[i + 1] += firsts[i];
+    }
+    workers.clear();
+    for (int i = 0; i < threads; i++) {
+        if (firsts[i] < grid.size()) {
+            workers.push_back(thread([this, &bounds, &firsts, &grid, i] {
+                parseWords(bounds[i], bounds[i + 1], firsts[i], grid);
+            }));
+        }
+    }
+    for (thread& worker : workers) {
+        worker.join();
+    }
+}
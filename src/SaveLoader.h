@@ -0,0 +1,65 @@
+/*Sarah Allen & Joshua Lindquist
+CS132 Winter 2022
+Final Project: Simulation
+
+Class main author: Josh
+
+Header for the SaveLoader class, which reads saved worlds (the window size, the square size, then
+one "{Deer," / "Tree," / ".}" style word per cell) fast enough for very big saves. The file is
+mapped into memory instead of read through a stream, split into one piece per thread at the spaces
+between words, and every piece is scanned by hand at the same time: first to count its words, so
+each piece knows which cell its first word belongs to, then to look every word up with a perfect
+hash of the species names. It fills in exactly the cells the old word by word loader did, including
+leaving a cell empty when its word isn't one it knew.*/
+
+#ifndef _SAVELOADER_H
+#define _SAVELOADER_H
+
+#include <string>
+#include <vector>
+#include "entitytypes.h"
+using namespace std;
+
+class SaveLoader {
+public:
+    //Opens the saved world at path. Check isOpen() before using it.
+    SaveLoader(const string& path);
+    ~SaveLoader();
+
+    //Returns true if the file could be read and starts with a usable window and square size
+    bool isOpen();
+
+    int getWindowSize();
+    int getSquareSize();
+
+    //Returns the world's width in cells, windowSize / squareSize
+    int getSize();
+
+    //Works out the Species of every cell, row by row, into grid, using threads threads (0 for
+    //one per core). Cells with no word, or a word that isn't a cell, come out EMPTY.
+    void parse(vector<unsigned char>& grid, int threads = 0);
+
+private:
+    //Returns the Species a cell word names, or -1 if the old loader would have skipped it
+    static int lookup(const char* word, size_t length);
+
+    //Counts the words in text[begin, end)
+    size_t countWords(size_t begin, size_t end);
+
+    //Puts the Species of the words in text[begin, end) into grid, starting at cell first
+    void parseWords(size_t begin, size_t end, size_t first, vector<unsigned char>& grid);
+
+    //Reads the two sizes at the front of the file. Returns false if they aren't there.
+    bool readHeader();
+
+    const char* text;   //the whole file
+    size_t length;
+    size_t body;        //where the cell words start
+    bool mapped;        //text is mapped, rather than in buffer
+    vector<char> buffer;
+    int windowSize;
+    int squareSize;
+    bool open;
+};
+
+#endif
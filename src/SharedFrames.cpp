@@ -0,0 +1,229 @@
+/*Joshua Lindquist & Sarah Allen
+CS132 Winter 2022
+Final Project: Simulation
+
+Cpp file for the SharedFrames class*/
+
+#include "SharedFrames.h"
+#include "Model.h"
+#include <cstring>
+#include <new>
+
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+//Slots start on their own cache line so the header and a slot never share one
+static const size_t ALIGN = 64;
+
+static size_t alignUp(size_t bytes) {
+    return (bytes + ALIGN - 1) / ALIGN * ALIGN;
+}
+
+SharedFrames::SharedFrames(const string& path, char* memory, size_t bytes, bool writer) {
+    this->path = path;
+    this->memory = memory;
+    this->bytes = bytes;
+    this->writer = writer;
+    fileId = 0;
+    header = (Header*) memory;
+    nextSlot = 0;
+}
+
+#ifndef _WIN32
+
+SharedFrames* SharedFrames::create(const string& path, int size) {
+    if (size <= 0 || SPECIES_COUNT > MAX_SPECIES) {
+        return nullptr;
+    }
+    size_t slotBytes = alignUp(sizeof(Slot) + (size_t) size * size);
+    size_t bytes = alignUp(sizeof(Header)) + SLOT_COUNT * slotBytes;
+
+    //A fresh file, so viewers still mapping an old one aren't handed a half built header
+    unlink(path.c_str());
+    int fd = ::open(path.c_str(), O_RDWR | O_CREAT | O_EXCL, 0644);
+    if (fd < 0) {
+        return nullptr;
+    }
+    if (ftruncate(fd, bytes) != 0) {
+        close(fd);
+        unlink(path.c_str());
+        return nullptr;
+    }
+    void* memory = mmap(nullptr, bytes, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+    close(fd);
+    if (memory == MAP_FAILED) {
+        unlink(path.c_str());
+        return nullptr;
+    }
+
+    SharedFrames* frames = new SharedFrames(path, (char*) memory, bytes, true);
+    Header* header = new (memory) Header;
+    header->size = size;
+    header->slotCount = SLOT_COUNT;
+    header->slotBytes = slotBytes;
+    header->latest = -1;
+    header->latestTick = -1;
+    for (int i = 0; i < SLOT_COUNT; i++) {
+        Slot* slot = new (frames->slot(i)) Slot;
+        slot->sequence = 0;
+    }
+    frames->scratch.resize((size_t) size * size);
+    //Written last: a viewer ignores the file until the magic number shows up
+    atomic_thread_fence(memory_order_release);
+    header->magic = MAGIC;
+    return frames;
+}
+
+SharedFrames* SharedFrames::open(const string& path) {
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        return nullptr;
+    }
+    struct stat info;
+    if (fstat(fd, &info) != 0 || (size_t) info.st_size < sizeof(Header)) {
+        close(fd);
+        return nullptr;
+    }
+    size_t bytes = info.st_size;
+    void* memory = mmap(nullptr, bytes, PROT_READ, MAP_SHARED, fd, 0);
+    close(fd);
+    if (memory == MAP_FAILED) {
+        return nullptr;
+    }
+
+    //Check the file really is a frame ring of the size it claims before trusting it
+    const Header* header = (const Header*) memory;
+    bool usable = header->magic == MAGIC && header->size > 0 && header->slotCount > 0
+            && header->slotBytes >= (long long) (sizeof(Slot) + (size_t) header->size * header->size)
+            && alignUp(sizeof(Header)) + (size_t) header->slotCount * header->slotBytes <= bytes;
+    if (!usable) {
+        munmap(memory, bytes);
+        return nullptr;
+    }
+    atomic_thread_fence(memory_order_acquire);
+    SharedFrames* frames = new SharedFrames(path, (char*) memory, bytes, false);
+    frames->fileId = info.st_ino;
+    return frames;
+}
+
+bool SharedFrames::isReplaced() {
+    struct stat info;
+    return stat(path.c_str(), &info) != 0 || (unsigned long long) info.st_ino != fileId;
+}
+
+SharedFrames::~SharedFrames() {
+    munmap(memory, bytes);
+    if (writer) {
+        unlink(path.c_str());
+    }
+}
+
+#else
+
+SharedFrames* SharedFrames::create(const string& path, int size) {
+    return nullptr;
+}
+
+SharedFrames* SharedFrames::open(const string& path) {
+    return nullptr;
+}
+
+bool SharedFrames::isReplaced() {
+    return true;
+}
+
+SharedFrames::~SharedFrames() {
+}
+
+#endif
+
+SharedFrames::Slot* SharedFrames::slot(int i) {
+    return (Slot*) (memory + alignUp(sizeof(Header)) + (size_t) i * header->slotBytes);
+}
+
+void SharedFrames::publish(Model* model) {
+    int size = header->size;
+    if (!writer || model->getSize() != size) {
+        return;
+    }
+    for (int row = 0; row < size; row++) {
+        for (int col = 0; col < size; col++) {
+            Entity* thing = model->getEntity(row, col);
+            scratch[(size_t) row * size + col] = thing ? thing->getSpecies() : EMPTY;
+        }
+    }
+    publish(scratch.data(), model->getTick());
+}
+
+void SharedFrames::publish(const unsigned char* grid, long tick) {
+    if (!writer) {
+        return;
+    }
+    size_t cells = (size_t) header->size * header->size;
+    long population[MAX_SPECIES] = {0};
+    for (size_t i = 0; i < cells; i++) {
+        if (grid[i] < SPECIES_COUNT) {
+            population[grid[i]]++;
+        }
+    }
+
+    //The ring always has a slot nobody is pointed at, so the writer never has to wait for
+    //readers. A reader still copying a slot when the ring comes round to it sees the sequence
+    //number change and goes back for the newer frame.
+    int i = nextSlot;
+    nextSlot = (nextSlot + 1) % header->slotCount;
+    Slot* target = slot(i);
+    unsigned int sequence = target->sequence.load(memory_order_relaxed);
+    target->sequence.store(sequence + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    target->tick = tick;
+    memcpy(target->population, population, sizeof(population));
+    memcpy((char*) (target + 1), grid, cells);
+    target->sequence.store(sequence + 2, memory_order_release);
+
+    header->latest.store(i, memory_order_release);
+    header->latestTick.store(tick, memory_order_release);
+}
+
+bool SharedFrames::readLatest(Frame& frame) {
+    int size = header->size;
+    size_t cells = (size_t) size * size;
+    for (int tries = 0; tries < READ_TRIES; tries++) {
+        int i = header->latest.load(memory_order_acquire);
+        if (i < 0 || i >= header->slotCount) {
+            return false;
+        }
+        Slot* source = slot(i);
+        unsigned int before = source->sequence.load(memory_order_acquire);
+        if (before & 1) {
+            continue;
+        }
+        long tick;
+        long population[MAX_SPECIES];
+        frame.grid.resize(cells);
+        memcpy(&tick, &source->tick, sizeof(tick));
+        memcpy(population, source->population, sizeof(population));
+        memcpy(frame.grid.data(), source + 1, cells);
+        atomic_thread_fence(memory_order_acquire);
+        if (source->sequence.load(memory_order_relaxed) != before) {
+            continue;
+        }
+        frame.tick = tick;
+        frame.size = size;
+        frame.population.assign(population, population + SPECIES_COUNT);
+        return true;
+    }
+    return false;
+}
+
+long SharedFrames::getLatestTick() {
+    return header->latestTick.load(memory_order_acquire);
+}
+
+int SharedFrames::getSize() {
+    return header->size;
+}
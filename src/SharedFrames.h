@@ -0,0 +1,103 @@
+/*Sarah Allen & Joshua Lindquist
+CS132 Winter 2022
+Final Project: Simulation
+
+Class main author: Josh
+
+Header for the SharedFrames class, which lets viewers in other processes watch a running
+simulation. After every tick the simulation publishes a frame (the Species of every cell plus the
+population counts) into a ring of slots in a memory-mapped file. Each slot has a sequence number
+that is odd while it is being written (a seqlock), so readers can tell a torn copy from a good one
+and simply try again. The writer never waits for anybody, and any number of viewers can map the
+file read-only and pick up the latest whole frame whenever they like.*/
+
+#ifndef _SHAREDFRAMES_H
+#define _SHAREDFRAMES_H
+
+#include <atomic>
+#include <string>
+#include <vector>
+#include "entitytypes.h"
+using namespace std;
+
+class Model;
+
+//One published tick, as copied out by a reader
+struct Frame {
+    long tick;
+    int size;                   //the world is size x size cells
+    vector<unsigned char> grid; //Species of every cell, row by row
+    vector<long> population;    //number of Entities of each Species
+};
+
+class SharedFrames {
+public:
+    //Creates (or replaces) the frame file at path for a size x size world and maps it for
+    //writing. Returns nullptr if the file could not be made.
+    static SharedFrames* create(const string& path, int size);
+
+    //Maps an existing frame file read-only. Returns nullptr if there is no usable file at path.
+    static SharedFrames* open(const string& path);
+
+    //Unmaps the file; the writer also removes it
+    ~SharedFrames();
+
+    //Publishes the Model's current map as the frame for its current tick
+    void publish(Model* model);
+
+    //Publishes a grid of Species codes (row by row, size * size of them) as the frame for tick
+    void publish(const unsigned char* grid, long tick);
+
+    //Copies the newest complete frame into frame. Returns false if nothing has been published
+    //yet or the writer kept overwriting the frame while it was being copied.
+    bool readLatest(Frame& frame);
+
+    //Returns the tick of the newest published frame, or -1 if there is none yet
+    long getLatestTick();
+
+    //Returns true if the file this reader has mapped has since been removed or replaced, as
+    //happens when the simulation exits or restarts
+    bool isReplaced();
+
+    // returns the number of columns wide / rows tall of the world
+    int getSize();
+
+private:
+    static const unsigned int MAGIC = 0x53494d46; //"SIMF"
+    static const int SLOT_COUNT = 4;
+    static const int MAX_SPECIES = 16;
+    static const int READ_TRIES = 8;
+
+    //Start of the file
+    struct Header {
+        unsigned int magic;
+        int size;
+        int slotCount;
+        long long slotBytes;
+        atomic<int> latest;       //slot holding the newest frame, -1 for none
+        atomic<long> latestTick;  //a long, so 32 bit readers can load it without a write
+    };
+
+    //Start of every slot, followed by the grid
+    struct Slot {
+        atomic<unsigned int> sequence; //odd while the writer is in the middle of the slot
+        long tick;
+        long population[MAX_SPECIES];
+    };
+
+    SharedFrames(const string& path, char* memory, size_t bytes, bool writer);
+
+    //Returns slot number i
+    Slot* slot(int i);
+
+    string path;
+    char* memory;
+    size_t bytes;
+    bool writer;
+    unsigned long long fileId; //reader only: inode of the mapped file
+    Header* header;
+    int nextSlot;                  //writer only: slot the next frame goes into
+    vector<unsigned char> scratch; //writer only: grid built from a Model
+};
+
+#endif
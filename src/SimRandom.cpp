@@ -0,0 +1,85 @@
+/*Joshua Lindquist & Sarah Allen
+CS132 Winter 2022
+Final Project: Simulation
+
+Cpp file for the SimRandom class*/
+
+#include "SimRandom.h"
+
+unsigned long long SimRandom::_seed = 1;
+
+//Each thread has its own position and buffer, so threads never fight over the generator
+static thread_local unsigned long long state = 0;
+static thread_local unsigned long long batch[SimRandom::BATCH];
+static thread_local int left = 0;   //numbers of batch not used yet
+//The part of the position that only depends on the seed and the tick, kept from the last cell
+static thread_local unsigned long long tickKey = 0;
+static thread_local long keyTick = 0;
+static thread_local unsigned long long keySeed = 0;
+static thread_local bool keyed = false;
+
+static const unsigned long long GAMMA = 0x9E3779B97F4A7C15ULL;
+const int SimRandom::BATCH;
+
+//SplitMix64 step: mixes x into a well spread 64 bit value
+static unsigned long long mix(unsigned long long x) {
+    x = (x ^ (x >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    x = (x ^ (x >> 27)) * 0x94D049BB133111EBULL;
+    return x ^ (x >> 31);
+}
+
+void SimRandom::seed(unsigned long long seed) {
+    _seed = seed;
+}
+
+unsigned long long SimRandom::getSeed() {
+    return _seed;
+}
+
+void SimRandom::atCell(long tick, int row, int col, int stream) {
+    //Cells of the same tick share most of the work
+    if (!keyed || keyTick != tick || keySeed != _seed) {
+        tickKey = mix(mix(_seed) ^ (unsigned long long) tick);
+        keyTick = tick;
+        keySeed = _seed;
+        keyed = true;
+    }
+    unsigned long long key = mix(tickKey ^ ((unsigned long long) (unsigned int) row << 32 | (unsigned int) col));
+    state = mix(key ^ (unsigned long long) stream);
+    left = 0;
+}
+
+void SimRandom::refill() {
+    //Number i only depends on the position, not on number i - 1, so they can all be worked on
+    //at once. They come out the same as stepping the position one at a time.
+    for (int i = 0; i < BATCH; i++) {
+        batch[i] = mix(state + (unsigned long long) (i + 1) * GAMMA);
+    }
+    state += (unsigned long long) BATCH * GAMMA;
+    left = BATCH;
+}
+
+unsigned int SimRandom::next32() {
+    if (left == 0) {
+        refill();
+    }
+    return (unsigned int) (batch[BATCH - left--] >> 32);
+}
+
+int SimRandom::next() {
+    return (int) (next32() >> 1);
+}
+
+int SimRandom::below(int bound) {
+    //Scale 32 random bits up to bound (Lemire's method). The few draws that would make some
+    //results come up once more than others are thrown away, which the low half catches.
+    unsigned int range = bound;
+    unsigned long long scaled = (unsigned long long) next32() * range;
+    if ((unsigned int) scaled < range) {
+        unsigned int threshold = (0u - range) % range;
+        while ((unsigned int) scaled < threshold) {
+            scaled = (unsigned long long) next32() * range;
+        }
+    }
+    return (int) (scaled >> 32);
+}
@@ -0,0 +1,50 @@
+/*Sarah Allen & Joshua Lindquist
+CS132 Winter 2022
+Final Project: Simulation
+
+Class main author: Josh
+
+Header for the SimRandom class, the random numbers the simulation uses instead of rand(). Before an
+Entity moves, the Model points the generator at that Entity's cell and tick, so the numbers it gets
+only depend on the seed and where and when it is, not on how many numbers were drawn before it.
+That lets a world split across several processes (see DomainRunner) make exactly the same choices
+as one process would. Numbers are made a few at a time into a buffer owned by the calling thread,
+so there is no lock and no chain of work from one number to the next.*/
+
+#ifndef _SIMRANDOM_H
+#define _SIMRANDOM_H
+
+class SimRandom {
+public:
+    //Sets the seed every stream is derived from (the default is 1, like rand())
+    static void seed(unsigned long long seed);
+
+    //Returns the current seed
+    static unsigned long long getSeed();
+
+    //Points the calling thread's generator at the numbers for one cell during one tick. Each
+    //cell has a few separate streams, so deciding a move and resolving it don't share numbers.
+    static void atCell(long tick, int row, int col, int stream);
+
+    //Returns the next number of the current stream, between 0 and 2^31 - 1 like rand()
+    static int next();
+
+    //Returns the next number of the current stream between 0 and bound - 1, every one equally
+    //likely (next() % bound favors the small ones unless bound is a power of two)
+    static int below(int bound);
+
+    //How many numbers are made at once. Every cell starts a new stream and most use one or two
+    //numbers, so a bigger batch costs more than it saves.
+    static const int BATCH = 2;
+
+private:
+    //Returns the next 32 random bits of the current stream
+    static unsigned int next32();
+
+    //Makes the next BATCH numbers of the current stream
+    static void refill();
+
+    static unsigned long long _seed;
+};
+
+#endif
@@ -0,0 +1,90 @@
+/*Sarah Allen & Joshua Lindquist
+CS132 Winter 2022
+Final Project: Simulation
+
+Class main author: Josh
+
+Header for the SpscQueue class template, a fixed size ring for handing values from exactly one
+producer thread to exactly one consumer thread without locks. Each side only writes its own index
+(kept on separate cache lines), so push() and pop() never wait; they report a full or empty
+queue instead and leave it to the caller what to do about it.*/
+
+#ifndef _SPSCQUEUE_H
+#define _SPSCQUEUE_H
+
+#include <atomic>
+#include <cstddef>
+#include <vector>
+using namespace std;
+
+template <typename T>
+class SpscQueue {
+public:
+    //Makes a queue holding at least capacity values (rounded up to a power of two)
+    SpscQueue(size_t capacity);
+
+    //Producer only: adds value at the back. Returns false, and leaves the queue alone, if full.
+    bool push(const T& value);
+
+    //Consumer only: takes the front value into value. Returns false if the queue is empty.
+    bool pop(T& value);
+
+    //Returns about how many values are waiting; exact only when neither side is busy
+    size_t size() const;
+
+    //Returns the most values the queue can hold
+    size_t capacity() const;
+
+private:
+    vector<T> slots;
+    size_t mask;
+    char padding1[64];
+    atomic<size_t> head; //next slot to pop, written by the consumer
+    char padding2[64];
+    atomic<size_t> tail; //next slot to push, written by the producer
+    char padding3[64];
+};
+
+template <typename T>
+SpscQueue<T>::SpscQueue(size_t capacity) : head(0), tail(0) {
+    size_t size = 1;
+    while (size < capacity) {
+        size *= 2;
+    }
+    slots.resize(size);
+    mask = size - 1;
+}
+
+template <typename T>
+bool SpscQueue<T>::push(const T& value) {
+    size_t back = tail.load(memory_order_relaxed);
+    if (back - head.load(memory_order_acquire) > mask) {
+        return false;
+    }
+    slots[back & mask] = value;
+    tail.store(back + 1, memory_order_release);
+    return true;
+}
+
+template <typename T>
+bool SpscQueue<T>::pop(T& value) {
+    size_t front = head.load(memory_order_relaxed);
+    if (front == tail.load(memory_order_acquire)) {
+        return false;
+    }
+    value = slots[front & mask];
+    head.store(front + 1, memory_order_release);
+    return true;
+}
+
+template <typename T>
+size_t SpscQueue<T>::size() const {
+    return tail.load(memory_order_acquire) - head.load(memory_order_acquire);
+}
+
+template <typename T>
+size_t SpscQueue<T>::capacity() const {
+    return mask + 1;
+}
+
+#endif
@@ -7,45 +7,18 @@ Cpp file for the Tiger class*/
 #include "Tiger.h"
 
 Tiger::Tiger() {
-    stepCount = 0;
-    currentDir = 'n';
+    memory = Behavior::start();
     hasMated = false;
 }
+
 Direction Tiger::getMove() {
-    vector<Direction> look {NORTH,EAST,SOUTH,WEST}; 
-    //Don't hit trees or houses
-    for (int i = 0; i < look.size(); i++) {
-        if (getNeighbor(look[i]) == "Tree" || getNeighbor(look[i]) == "Building") {
-            int chance = rand() % 2;
-            if (chance == 0) {
-                return look[(i+1) % 4];
-            } else {
-                return look[(i-1) % 4];
-            }
-        }
-    }
-   //Check for anything nearby and exclude other Cats if the Cat has mated.
-   for (int i = 0; i < 4; i++) {
-        if ((getNeighbor(look[i]) == "\xF0\x9F\x90\x85" && !hasMated) || (getNeighbor(look[i]) != "" && getNeighbor(look[i]) != "\xF0\x9F\x90\x86")) {
-            //cout << "getNeighbor: " << look[i] << endl;
-            return look[i];
-        }
-   }
-   //if after checking each direction it finds nothing then move randomly up to 5 spaces in a random direction
-   if (stepCount == 0) {
-       stepCount = 5;
-       currentDir = rand() % 4;
-   }
-    stepCount--;
-   if (currentDir == 0) {
-       return NORTH;
-   } else if (currentDir == 1) {
-       return EAST;
-   } else if (currentDir == 2) {
-       return SOUTH;
-   } else {
-       return WEST;
-   }
+    Branch branch;
+    return Behavior::forSpecies(TIGER)->move(getSignature(), memory, branch);
+}
+
+Direction Tiger::getMove(const Surroundings& around) {
+    Branch branch;
+    return Behavior::forSpecies(TIGER)->move(around.signature, memory, branch);
 }
 
 Attack Tiger::fight() const{
@@ -56,10 +29,31 @@ string Tiger::getType() {
     return "Tiger";
 }
 
+Species Tiger::getSpecies() {
+    return TIGER;
+}
+
 string Tiger::toString() {
    return "\xF0\x9F\x90\x85";
 }
 
 string Tiger::getColor() {
     return "blue";
-}
\ No newline at end of file
+}
+
+void Tiger::saveState(int* state) const {
+    Entity::saveState(state);
+    state[0] = memory.steps;
+    state[1] = memory.heading;
+    state[2] = hasMated;
+    state[3] = memory.flee;
+    state[4] = memory.rest;
+}
+
+void Tiger::loadState(const int* state) {
+    memory.steps = state[0];
+    memory.heading = (Direction) state[1];
+    hasMated = state[2] != 0;
+    memory.flee = state[3];
+    memory.rest = state[4];
+}
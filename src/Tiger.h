@@ -12,29 +12,41 @@ to hunt villagers and deer by using a bite attack.*/
 #define _TIGER_H
 
 #include "Creature.h"
+#include "Behavior.h"
 
 class Tiger : public Creature {
 public:
     //Constructor
     Tiger();
 
-    //Searches for prey (Deer and villagers), can't enter buildings
+    //Searches for prey (Deer and villagers), can't enter buildings, following the Tiger Behavior
     virtual Direction getMove();
 
+    //The same, from what the Model shows it, without going through getNeighbor()
+    virtual Direction getMove(const Surroundings& around);
+
     //Always returns BITE
     virtual Attack fight() const;
 
     //Returns "Tiger"
     virtual string getType();
 
+    //Returns TIGER
+    virtual Species getSpecies();
+
     //Returns image of a tiger using a UTC-8 hex code
     virtual string toString();
 
     //Returns display color of the tiger
     virtual string getColor();
+    //Copies the Tiger's wander steps, heading, hasMated, flee and rest into state
+    virtual void saveState(int* state) const;
+
+    //Restores what saveState() wrote
+    virtual void loadState(const int* state);
+
 private:
-    int stepCount;
-    int currentDir;
+    BehaviorMemory memory;
     bool hasMated;
 };
 
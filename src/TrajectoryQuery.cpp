@@ -0,0 +1,498 @@
+/*Joshua Lindquist & Sarah Allen
+CS132 Winter 2022
+Final Project: Simulation
+
+Cpp file for the TrajectoryQuery class*/
+
+#include "TrajectoryQuery.h"
+#include <atomic>
+#include <climits>
+#include <functional>
+#include <sstream>
+#include <thread>
+
+TrajectoryQuery::TrajectoryQuery(const TrajectoryReader& reader) : reader(reader) {
+    firstTick = LONG_MIN;
+    lastTick = LONG_MAX;
+    near = false;
+    nearX = 0;
+    nearY = 0;
+    radius = 0;
+    speciesMask = 0;
+    byId = false;
+    id = 0;
+    eventMask = 0;
+    between = false;
+    betweenFirst = EMPTY;
+    betweenSecond = EMPTY;
+    threads = thread::hardware_concurrency();
+    if (threads < 1) {
+        threads = 1;
+    }
+    chunksRead = 0;
+    chunksFailed = 0;
+}
+
+void TrajectoryQuery::setTicks(long first, long last) {
+    firstTick = first;
+    lastTick = last;
+}
+
+void TrajectoryQuery::setNear(int x, int y, int radius) {
+    near = true;
+    nearX = x;
+    nearY = y;
+    this->radius = radius;
+}
+
+void TrajectoryQuery::addSpecies(Species species) {
+    speciesMask |= 1u << species;
+}
+
+void TrajectoryQuery::setId(long id) {
+    byId = true;
+    this->id = id;
+}
+
+void TrajectoryQuery::addEventType(EventType type) {
+    eventMask |= 1u << type;
+}
+
+void TrajectoryQuery::setBetween(Species first, Species second) {
+    between = true;
+    betweenFirst = first;
+    betweenSecond = second;
+}
+
+bool TrajectoryQuery::isEventQuery() {
+    return eventMask != 0 || between;
+}
+
+void TrajectoryQuery::setThreads(int threads) {
+    this->threads = threads < 1 ? 1 : threads;
+}
+
+//Finds the Species named name, as to_string() writes it. Returns false if there is none.
+static bool parseSpecies(const string& name, Species& species, string& error) {
+    for (int s = 0; s < SPECIES_COUNT; s++) {
+        if (to_string((Species) s) == name) {
+            species = (Species) s;
+            return true;
+        }
+    }
+    error = "unknown species \"" + name + "\"";
+    return false;
+}
+
+bool TrajectoryQuery::parse(const string& text, string& error) {
+    istringstream words(text);
+    string word;
+    while (words >> word) {
+        size_t equals = word.find('=');
+        if (equals == string::npos) {
+            error = "expected key=value, got \"" + word + "\"";
+            return false;
+        }
+        string key = word.substr(0, equals);
+        string value = word.substr(equals + 1);
+        istringstream in(value);
+        char separator;
+        if (key == "ticks") {
+            long first;
+            long last;
+            if (!(in >> first >> separator >> last) || separator != '-') {
+                error = "ticks should look like ticks=100-200";
+                return false;
+            }
+            setTicks(first, last);
+        } else if (key == "near") {
+            int x;
+            int y;
+            int r;
+            char separator2;
+            if (!(in >> x >> separator >> y >> separator2 >> r) || separator != ','
+                    || separator2 != ',') {
+                error = "near should look like near=row,col,radius";
+                return false;
+            }
+            setNear(x, y, r);
+        } else if (key == "species") {
+            string name;
+            while (getline(in, name, ',')) {
+                Species species;
+                if (!parseSpecies(name, species, error)) {
+                    return false;
+                }
+                addSpecies(species);
+            }
+        } else if (key == "id") {
+            long value;
+            if (!(in >> value)) {
+                error = "id should be a number";
+                return false;
+            }
+            setId(value);
+        } else if (key == "events") {
+            string name;
+            while (getline(in, name, ',')) {
+                int t = 0;
+                while (t < EVENT_TYPE_COUNT && to_string((EventType) t) != name) {
+                    t++;
+                }
+                if (t == EVENT_TYPE_COUNT) {
+                    error = "unknown event \"" + name + "\", expected birth, fight or build";
+                    return false;
+                }
+                addEventType((EventType) t);
+            }
+        } else if (key == "between") {
+            string first;
+            string second;
+            Species firstSpecies;
+            Species secondSpecies;
+            if (!getline(in, first, ',') || !getline(in, second)) {
+                error = "between should look like between=Tiger,Hunter";
+                return false;
+            }
+            if (!parseSpecies(first, firstSpecies, error)
+                    || !parseSpecies(second, secondSpecies, error)) {
+                return false;
+            }
+            setBetween(firstSpecies, secondSpecies);
+        } else {
+            error = "unknown condition \"" + key + "\"";
+            return false;
+        }
+    }
+    return true;
+}
+
+bool TrajectoryQuery::mightMatch(const ChunkInfo& chunk, bool lifetime) {
+    if (speciesMask != 0 && (chunk.speciesMask & speciesMask) == 0) {
+        return false;
+    }
+    return lifetime || inRange(chunk);
+}
+
+bool TrajectoryQuery::mightHoldEvents(const ChunkInfo& chunk) {
+    if (eventMask != 0 && (chunk.eventMask & eventMask) == 0) {
+        return false;
+    }
+    if (speciesMask != 0 && (chunk.speciesMask & speciesMask) == 0) {
+        return false;
+    }
+    unsigned int pair = 1u << betweenFirst | 1u << betweenSecond;
+    if (between && (chunk.speciesMask & pair) != pair) {
+        return false;
+    }
+    return inRange(chunk);
+}
+
+bool TrajectoryQuery::inRange(const ChunkInfo& chunk) {
+    if (chunk.lastTick < firstTick || chunk.firstTick > lastTick) {
+        return false;
+    }
+    if (near) {
+        //Distance from the spot to the nearest point of the chunk's bounding box
+        long long dx = max(0, max(chunk.minX - nearX, nearX - chunk.maxX));
+        long long dy = max(0, max(chunk.minY - nearY, nearY - chunk.maxY));
+        if (dx * dx + dy * dy > (long long) radius * radius) {
+            return false;
+        }
+    }
+    return true;
+}
+
+unsigned int TrajectoryQuery::filterColumns() {
+    unsigned int columns = 0;
+    if (firstTick != LONG_MIN || lastTick != LONG_MAX) {
+        columns |= 1u << COLUMN_TICK;
+    }
+    if (near) {
+        columns |= 1u << COLUMN_X | 1u << COLUMN_Y;
+    }
+    if (speciesMask != 0) {
+        columns |= 1u << COLUMN_SPECIES;
+    }
+    if (byId) {
+        columns |= 1u << COLUMN_ID;
+    }
+    return columns;
+}
+
+unsigned int TrajectoryQuery::eventFilterColumns() {
+    unsigned int columns = 0;
+    if (firstTick != LONG_MIN || lastTick != LONG_MAX) {
+        columns |= 1u << EVENT_COLUMN_TICK;
+    }
+    if (near) {
+        columns |= 1u << EVENT_COLUMN_X | 1u << EVENT_COLUMN_Y;
+    }
+    if (eventMask != 0) {
+        columns |= 1u << EVENT_COLUMN_TYPE;
+    }
+    if (speciesMask != 0 || between) {
+        columns |= 1u << EVENT_COLUMN_SPECIES;
+    }
+    if (between) {
+        columns |= 1u << EVENT_COLUMN_OTHER_SPECIES;
+    }
+    if (byId) {
+        columns |= 1u << EVENT_COLUMN_ACTOR | 1u << EVENT_COLUMN_OTHER | 1u << EVENT_COLUMN_RESULT;
+    }
+    return columns;
+}
+
+bool TrajectoryQuery::matches(const TrajectoryChunk& chunk, long long j) {
+    const vector<vector<long long>>& c = chunk.columns;
+    if ((firstTick != LONG_MIN || lastTick != LONG_MAX)
+            && (c[COLUMN_TICK][j] < firstTick || c[COLUMN_TICK][j] > lastTick)) {
+        return false;
+    }
+    if (near) {
+        long long dx = c[COLUMN_X][j] - nearX;
+        long long dy = c[COLUMN_Y][j] - nearY;
+        if (dx * dx + dy * dy > (long long) radius * radius) {
+            return false;
+        }
+    }
+    if (speciesMask != 0 && !(speciesMask & 1u << c[COLUMN_SPECIES][j])) {
+        return false;
+    }
+    return !byId || c[COLUMN_ID][j] == id;
+}
+
+bool TrajectoryQuery::eventMatches(const TrajectoryChunk& chunk, long long j) {
+    const vector<vector<long long>>& c = chunk.columns;
+    if ((firstTick != LONG_MIN || lastTick != LONG_MAX)
+            && (c[EVENT_COLUMN_TICK][j] < firstTick || c[EVENT_COLUMN_TICK][j] > lastTick)) {
+        return false;
+    }
+    if (near) {
+        long long dx = c[EVENT_COLUMN_X][j] - nearX;
+        long long dy = c[EVENT_COLUMN_Y][j] - nearY;
+        if (dx * dx + dy * dy > (long long) radius * radius) {
+            return false;
+        }
+    }
+    if (eventMask != 0 && !(eventMask & 1u << c[EVENT_COLUMN_TYPE][j])) {
+        return false;
+    }
+    if (speciesMask != 0 && !(speciesMask & 1u << c[EVENT_COLUMN_SPECIES][j])) {
+        return false;
+    }
+    if (between) {
+        long long actor = c[EVENT_COLUMN_SPECIES][j];
+        long long other = c[EVENT_COLUMN_OTHER_SPECIES][j];
+        if (!(actor == betweenFirst && other == betweenSecond)
+                && !(actor == betweenSecond && other == betweenFirst)) {
+            return false;
+        }
+    }
+    return !byId || c[EVENT_COLUMN_ACTOR][j] == id || c[EVENT_COLUMN_OTHER][j] == id
+            || c[EVENT_COLUMN_RESULT][j] == id;
+}
+
+vector<int> TrajectoryQuery::candidates(ChunkKind kind, bool lifetime) {
+    vector<int> chunks;
+    for (int i = 0; i < reader.getChunkCount(); i++) {
+        const ChunkInfo& chunk = reader.getChunk(i);
+        if (chunk.kind != kind) {
+            continue;
+        }
+        if (kind == CHUNK_EVENTS ? mightHoldEvents(chunk) : mightMatch(chunk, lifetime)) {
+            chunks.push_back(i);
+        }
+    }
+    chunksRead = chunks.size();
+    chunksFailed = 0;
+    return chunks;
+}
+
+void TrajectoryQuery::forChunks(int count, function<void(int)> search) {
+    //Workers take the next unsearched chunk until there are none left
+    atomic<int> next(0);
+    auto work = [&] {
+        for (int k = next++; k < count; k = next++) {
+            search(k);
+        }
+    };
+    vector<thread> workers;
+    for (int t = 1; t < min(threads, count); t++) {
+        workers.push_back(thread(work));
+    }
+    work();
+    for (thread& worker : workers) {
+        worker.join();
+    }
+}
+
+template <typename Row, typename Match, typename Make>
+vector<Row> TrajectoryQuery::search(const vector<int>& chunks, unsigned int filter, Match match,
+                                    Make make) {
+    vector<vector<Row>> found(chunks.size());
+
+    forChunks(chunks.size(), [&](int k) {
+        TrajectoryChunk chunk;
+        //First only the columns the conditions need...
+        if (!reader.readChunk(chunks[k], chunk, filter)) {
+            chunksFailed++;
+            return;
+        }
+        vector<long long> hits;
+        for (long long j = 0; j < chunk.info.rows; j++) {
+            if (match(chunk, j)) {
+                hits.push_back(j);
+            }
+        }
+        if (hits.empty()) {
+            return;
+        }
+        //...and the rest only for chunks that have a match
+        TrajectoryChunk rest;
+        if (!reader.readChunk(chunks[k], rest, ALL_COLUMNS & ~filter)) {
+            chunksFailed++;
+            return;
+        }
+        for (int c = 0; c < columnCount(rest.info); c++) {
+            if (filter & 1u << c) {
+                rest.columns[c].swap(chunk.columns[c]);
+            }
+        }
+        for (long long j : hits) {
+            found[k].push_back(make(rest.columns, j));
+        }
+    });
+
+    vector<Row> rows;
+    for (vector<Row>& chunkRows : found) {
+        rows.insert(rows.end(), chunkRows.begin(), chunkRows.end());
+    }
+    return rows;
+}
+
+vector<TrajectoryRow> TrajectoryQuery::run() {
+    return search<TrajectoryRow>(candidates(CHUNK_SAMPLES, false), filterColumns(),
+            [this](const TrajectoryChunk& chunk, long long j) {
+        return matches(chunk, j);
+    }, [](const vector<vector<long long>>& c, long long j) {
+        TrajectoryRow row;
+        row.tick = c[COLUMN_TICK][j];
+        row.id = c[COLUMN_ID][j];
+        row.x = c[COLUMN_X][j];
+        row.y = c[COLUMN_Y][j];
+        row.species = (Species) c[COLUMN_SPECIES][j];
+        for (int s = 0; s < Entity::STATE_SIZE; s++) {
+            row.state[s] = c[COLUMN_STATE + s][j];
+        }
+        return row;
+    });
+}
+
+vector<Event> TrajectoryQuery::events() {
+    return search<Event>(candidates(CHUNK_EVENTS, false), eventFilterColumns(),
+            [this](const TrajectoryChunk& chunk, long long j) {
+        return eventMatches(chunk, j);
+    }, [](const vector<vector<long long>>& c, long long j) {
+        Event event;
+        event.tick = c[EVENT_COLUMN_TICK][j];
+        event.type = (EventType) c[EVENT_COLUMN_TYPE][j];
+        event.species = (Species) c[EVENT_COLUMN_SPECIES][j];
+        event.otherSpecies = (Species) c[EVENT_COLUMN_OTHER_SPECIES][j];
+        event.actor = c[EVENT_COLUMN_ACTOR][j];
+        event.other = c[EVENT_COLUMN_OTHER][j];
+        event.result = c[EVENT_COLUMN_RESULT][j];
+        event.x = c[EVENT_COLUMN_X][j];
+        event.y = c[EVENT_COLUMN_Y][j];
+        event.attack = (Attack) c[EVENT_COLUMN_ATTACK][j];
+        event.otherAttack = (Attack) c[EVENT_COLUMN_OTHER_ATTACK][j];
+        return event;
+    });
+}
+
+map<long, Lifetime> TrajectoryQuery::lifetimes() {
+    vector<int> chunks = candidates(CHUNK_SAMPLES, true);
+    vector<map<long, Lifetime>> found(chunks.size());
+    unsigned int columns = 1u << COLUMN_TICK | 1u << COLUMN_ID | 1u << COLUMN_X
+            | 1u << COLUMN_Y | 1u << COLUMN_SPECIES;
+
+    forChunks(chunks.size(), [&](int k) {
+        TrajectoryChunk chunk;
+        if (!reader.readChunk(chunks[k], chunk, columns)) {
+            chunksFailed++;
+            return;
+        }
+        const vector<vector<long long>>& c = chunk.columns;
+        map<long, Lifetime>& seen = found[k];
+        for (long long j = 0; j < chunk.info.rows; j++) {
+            if (speciesMask != 0 && !(speciesMask & 1u << c[COLUMN_SPECIES][j])) {
+                continue;
+            }
+            //Samples are in tick order within a chunk, so the first one seen is the earliest
+            auto inserted = seen.insert(make_pair((long) c[COLUMN_ID][j], Lifetime()));
+            Lifetime& life = inserted.first->second;
+            if (inserted.second) {
+                life.species = (Species) c[COLUMN_SPECIES][j];
+                life.firstTick = c[COLUMN_TICK][j];
+                life.firstX = c[COLUMN_X][j];
+                life.firstY = c[COLUMN_Y][j];
+            }
+            life.lastTick = c[COLUMN_TICK][j];
+        }
+    });
+
+    //Chunks are in recording order, so an id's first chunk has its first sample
+    map<long, Lifetime> lives;
+    for (map<long, Lifetime>& chunkLives : found) {
+        for (auto& entry : chunkLives) {
+            auto inserted = lives.insert(entry);
+            if (!inserted.second) {
+                inserted.first->second.lastTick = entry.second.lastTick;
+            }
+        }
+    }
+    for (auto it = lives.begin(); it != lives.end();) {
+        const Lifetime& life = it->second;
+        long long dx = life.firstX - nearX;
+        long long dy = life.firstY - nearY;
+        bool keep = life.firstTick >= firstTick && life.firstTick <= lastTick
+                && (!near || dx * dx + dy * dy <= (long long) radius * radius)
+                && (!byId || it->first == id);
+        it = keep ? next(it) : lives.erase(it);
+    }
+    return lives;
+}
+
+void TrajectoryQuery::writeCsv(ostream& out, const vector<TrajectoryRow>& rows) {
+    for (int c = 0; c < COLUMN_COUNT; c++) {
+        out << (c > 0 ? "," : "") << to_string((Column) c);
+    }
+    out << endl;
+    for (const TrajectoryRow& row : rows) {
+        out << row.tick << "," << row.id << "," << row.x << "," << row.y << ","
+            << to_string(row.species);
+        for (int s = 0; s < Entity::STATE_SIZE; s++) {
+            out << "," << row.state[s];
+        }
+        out << "\n";
+    }
+}
+
+void TrajectoryQuery::writeEventCsv(ostream& out, const vector<Event>& events) {
+    EventStream::writeCsvHeader(out);
+    for (const Event& event : events) {
+        EventStream::writeCsvLine(out, event);
+    }
+}
+
+int TrajectoryQuery::getChunksRead() {
+    return chunksRead;
+}
+
+int TrajectoryQuery::getChunksFailed() {
+    return chunksFailed;
+}
+
+int TrajectoryQuery::getChunkCount() {
+    return reader.getChunkCount();
+}
@@ -0,0 +1,161 @@
+/*Sarah Allen & Joshua Lindquist
+CS132 Winter 2022
+Final Project: Simulation
+
+Class main author: Josh
+
+Header for the TrajectoryQuery class, which answers questions about a recorded run (see
+TrajectoryRecorder) without replaying it: which samples fall in a range of ticks, near a spot,
+of some species or of one Entity, how long Entities lived, and which births, fights and new
+Buildings happened there and between which species. Every chunk's ticks, bounding box, species
+and event types are in the file's index, so chunks that can't match are never read, and of the rest
+only the columns the conditions need are decoded until a row actually matches. Chunks are
+searched in parallel; results still come back in the order they were recorded.*/
+
+#ifndef _TRAJECTORYQUERY_H
+#define _TRAJECTORYQUERY_H
+
+#include <atomic>
+#include <functional>
+#include <map>
+#include <string>
+#include <vector>
+#include "EventStream.h"
+#include "TrajectoryReader.h"
+using namespace std;
+
+//One recorded sample
+struct TrajectoryRow {
+    long tick;
+    long id;
+    int x;
+    int y;
+    Species species;
+    int state[Entity::STATE_SIZE];
+};
+
+//When one Entity was first and last recorded, and where it was first seen
+struct Lifetime {
+    Species species;
+    long firstTick;
+    long lastTick;
+    int firstX;
+    int firstY;
+};
+
+class TrajectoryQuery {
+public:
+    //Makes a query matching every sample of the file reader has open
+    TrajectoryQuery(const TrajectoryReader& reader);
+
+    //Only matches samples from tick first to tick last, inclusive
+    void setTicks(long first, long last);
+
+    //Only matches samples within radius cells (straight line, not wrapping around the edges)
+    //of row x, column y
+    void setNear(int x, int y, int radius);
+
+    //Only matches samples of species; call again to allow more than one
+    void addSpecies(Species species);
+
+    //Only matches samples of the Entity with this id
+    void setId(long id);
+
+    //Only matches Events of type; call again to allow more than one. Makes this an Event query.
+    void addEventType(EventType type);
+
+    //Only matches Events between an Entity of species first and one of species second, whichever
+    //of them was the actor. Makes this an Event query.
+    void setBetween(Species first, Species second);
+
+    //Returns true if the conditions are about Events, so events() should be run, not run()
+    bool isEventQuery();
+
+    //Sets how many threads search chunks (the default is the number of cores)
+    void setThreads(int threads);
+
+    //Reads conditions from text like "ticks=5000-6000 near=25,25,10 species=Tiger,Hunter id=12",
+    //or for Events "events=fight between=Tiger,Hunter near=25,25,10 ticks=5000-6000". Returns
+    //false, with a message in error, if something can't be understood.
+    bool parse(const string& text, string& error);
+
+    //Returns every matching sample, in the order they were recorded
+    vector<TrajectoryRow> run();
+
+    //Returns the lifetime of every Entity of the chosen species whose first sample matches the
+    //other conditions, so "deer first seen near (25, 25) after tick 100" is a lifetime query with
+    //those conditions. Only the tick, id, position and species columns are read.
+    map<long, Lifetime> lifetimes();
+
+    //Returns every matching Event, in the order they happened. The tick and place conditions are
+    //checked against where the Event happened, species against its actor (the baby for a birth),
+    //and id against its actor, other and result.
+    vector<Event> events();
+
+    //Writes rows as CSV with a header line
+    static void writeCsv(ostream& out, const vector<TrajectoryRow>& rows);
+
+    //Writes Events as CSV with a header line, like EventStream::writeCsv()
+    static void writeEventCsv(ostream& out, const vector<Event>& events);
+
+    //Returns how many chunks the last run(), lifetimes() or events() decoded any columns of, out of
+    //how many are in the file
+    int getChunksRead();
+    int getChunkCount();
+
+    //Returns how many of the chunks the last run(), lifetimes() or events() read were damaged or
+    //cut short. Their rows are missing from the results, so anything but 0 means they are partial.
+    int getChunksFailed();
+
+private:
+    //Returns true if the index says chunk i might hold a match. Lifetime searches ignore the
+    //tick and place conditions, since an Entity's first sample can be anywhere.
+    bool mightMatch(const ChunkInfo& chunk, bool lifetime);
+
+    //Returns true if the index says chunk i might hold a matching Event
+    bool mightHoldEvents(const ChunkInfo& chunk);
+
+    //Returns true if the chunk's ticks and bounding box meet the tick and place conditions
+    bool inRange(const ChunkInfo& chunk);
+
+    //Returns the columns the conditions look at, for samples and for Events
+    unsigned int filterColumns();
+    unsigned int eventFilterColumns();
+
+    //Returns true if row j of a chunk decoded with filterColumns() meets the conditions
+    bool matches(const TrajectoryChunk& chunk, long long j);
+
+    //Returns true if row j of a chunk of Events decoded with eventFilterColumns() meets them
+    bool eventMatches(const TrajectoryChunk& chunk, long long j);
+
+    //Returns the chunks of kind the index says might match, and counts them in chunksRead
+    vector<int> candidates(ChunkKind kind, bool lifetime);
+
+    //Calls search(k) for k from 0 to count - 1, spread over the threads
+    void forChunks(int count, function<void(int)> search);
+
+    //Decodes the filter columns of each chunk, and the rest only for chunks where match finds a
+    //row, then returns make() of every matching row in the order they were recorded
+    template <typename Row, typename Match, typename Make>
+    vector<Row> search(const vector<int>& chunks, unsigned int filter, Match match, Make make);
+
+    const TrajectoryReader& reader;
+    long firstTick;
+    long lastTick;
+    bool near;
+    int nearX;
+    int nearY;
+    int radius;
+    unsigned int speciesMask;  //0 for any species
+    bool byId;
+    long id;
+    unsigned int eventMask;    //0 for any EventType
+    bool between;
+    Species betweenFirst;
+    Species betweenSecond;
+    int threads;
+    int chunksRead;
+    atomic<int> chunksFailed;  //counted by every search thread
+};
+
+#endif
@@ -0,0 +1,119 @@
+/*Joshua Lindquist & Sarah Allen
+CS132 Winter 2022
+Final Project: Simulation
+
+Cpp file for the TrajectoryReader class*/
+
+#include "TrajectoryReader.h"
+
+template <typename T>
+static bool readValue(istream& in, T& value) {
+    return (bool) in.read((char*) &value, sizeof(value));
+}
+
+TrajectoryReader::TrajectoryReader(const string& path) {
+    this->path = path;
+    open = false;
+    ifstream in(path, ios::binary);
+    uint32_t magic;
+    uint32_t version;
+    if (!readValue(in, magic) || !readValue(in, version)
+            || magic != FILE_MAGIC || version != FORMAT_VERSION) {
+        return;
+    }
+    if (!readIndex(in)) {
+        in.clear();
+        scanChunks(in);
+    }
+    open = true;
+}
+
+bool TrajectoryReader::isOpen() const {
+    return open;
+}
+
+int TrajectoryReader::getChunkCount() const {
+    return chunks.size();
+}
+
+const ChunkInfo& TrajectoryReader::getChunk(int i) const {
+    return chunks[i];
+}
+
+bool TrajectoryReader::readIndex(ifstream& in) {
+    int64_t indexOffset;
+    uint32_t magic;
+    uint32_t count;
+    in.seekg(-(int) (sizeof(indexOffset) + sizeof(magic)), ios::end);
+    if (!readValue(in, indexOffset) || !readValue(in, magic) || magic != INDEX_MAGIC) {
+        return false;
+    }
+    in.seekg(indexOffset);
+    if (!readValue(in, magic) || magic != INDEX_MAGIC || !readValue(in, count)) {
+        return false;
+    }
+    chunks.resize(count);
+    for (uint32_t i = 0; i < count; i++) {
+        if (!readChunkInfo(in, chunks[i], true)) {
+            chunks.clear();
+            return false;
+        }
+    }
+    return true;
+}
+
+void TrajectoryReader::scanChunks(ifstream& in) {
+    chunks.clear();
+    in.seekg(0, ios::end);
+    streamoff fileSize = in.tellg();
+    in.seekg(sizeof(FILE_MAGIC) + sizeof(FORMAT_VERSION));
+    while (true) {
+        ChunkInfo info;
+        uint32_t magic;
+        info.offset = in.tellg();
+        if (!readValue(in, magic) || magic != CHUNK_MAGIC || !readChunkInfo(in, info, false)) {
+            return;
+        }
+        for (int i = 0; i < columnCount(info); i++) {
+            uint32_t bytes;
+            if (!readValue(in, bytes) || !in.seekg(bytes, ios::cur)) {
+                return;
+            }
+        }
+        //A chunk whose last column runs past the end of the file was never finished
+        if (in.tellg() > fileSize) {
+            return;
+        }
+        chunks.push_back(info);
+    }
+}
+
+bool TrajectoryReader::readChunk(int i, TrajectoryChunk& chunk, unsigned int columns) const {
+    //Each call has its own stream, so threads can read different chunks at the same time
+    ifstream in(path, ios::binary);
+    uint32_t magic;
+    in.seekg(chunks[i].offset);
+    if (!readValue(in, magic) || magic != CHUNK_MAGIC || !readChunkInfo(in, chunk.info, false)) {
+        return false;
+    }
+    chunk.info.offset = chunks[i].offset;
+    chunk.columns.resize(columnCount(chunk.info));
+    string bytes;
+    for (int c = 0; c < columnCount(chunk.info); c++) {
+        uint32_t size;
+        if (!readValue(in, size)) {
+            return false;
+        }
+        if (!(columns & (1u << c))) {
+            chunk.columns[c].clear();
+            in.seekg(size, ios::cur);
+            continue;
+        }
+        bytes.resize(size);
+        if (!in.read(&bytes[0], size)
+                || !decodeColumn(bytes.data(), bytes.data() + size, chunk.info.rows, chunk.columns[c])) {
+            return false;
+        }
+    }
+    return true;
+}
@@ -0,0 +1,52 @@
+/*Sarah Allen & Joshua Lindquist
+CS132 Winter 2022
+Final Project: Simulation
+
+Class main author: Josh
+
+Header for the TrajectoryReader class, which reads back the files TrajectoryRecorder writes. It
+loads the chunk index when opened (or rebuilds it from the chunk headers if the run was cut short
+before the index was written), and decodes chunks on demand, optionally only some of their
+columns. Reading chunks doesn't change the reader, so several threads can read one file at once.*/
+
+#ifndef _TRAJECTORYREADER_H
+#define _TRAJECTORYREADER_H
+
+#include <fstream>
+#include <string>
+#include <vector>
+#include "trajectoryformat.h"
+using namespace std;
+
+class TrajectoryReader {
+public:
+    //Opens the trajectory file at path and loads its chunk index
+    TrajectoryReader(const string& path);
+
+    //Returns true if the file was opened and its index could be read
+    bool isOpen() const;
+
+    //Returns the number of chunks in the file
+    int getChunkCount() const;
+
+    //Returns what chunk i covers
+    const ChunkInfo& getChunk(int i) const;
+
+    //Decodes chunk i into chunk. Only the columns whose bits (1 << Column, or 1 << EventColumn for
+    //a chunk of Events) are set in columns are decoded; the rest are left empty. Returns false if
+    //the chunk is damaged or cut short.
+    bool readChunk(int i, TrajectoryChunk& chunk, unsigned int columns = ALL_COLUMNS) const;
+
+private:
+    //Loads the index written at the end of the file. Returns false if there isn't one.
+    bool readIndex(ifstream& in);
+
+    //Rebuilds the index by walking the chunk headers from the start of the file
+    void scanChunks(ifstream& in);
+
+    string path;
+    bool open;
+    vector<ChunkInfo> chunks;
+};
+
+#endif
@@ -0,0 +1,272 @@
+/*Joshua Lindquist & Sarah Allen
+CS132 Winter 2022
+Final Project: Simulation
+
+Cpp file for the TrajectoryRecorder class*/
+
+#include "TrajectoryRecorder.h"
+#include "Metrics.h"
+#include "Model.h"
+#include <chrono>
+#include <cstdlib>
+
+TrajectoryRecorder* TrajectoryRecorder::_instance = nullptr;
+atomic<bool> TrajectoryRecorder::_recording(false);
+
+template <typename T>
+static void writeValue(ofstream& out, T value) {
+    out.write((const char*) &value, sizeof(value));
+}
+
+TrajectoryRecorder::TrajectoryRecorder() : full(BATCH_COUNT), empty(BATCH_COUNT),
+        columns(COLUMN_COUNT), eventColumns(EVENT_COLUMN_COUNT) {
+    stopping = false;
+    stalls = 0;
+    bytesWritten = 0;
+}
+
+TrajectoryRecorder* TrajectoryRecorder::instance() {
+    if (!_instance) {
+        _instance = new TrajectoryRecorder();
+        Metrics* metrics = Metrics::instance();
+        metrics->addGauge("trajectory_bytes_written", "Bytes of trajectory recorded so far.", [] {
+            return (double) _instance->getBytesWritten();
+        });
+        metrics->addGauge("trajectory_record_stalls", "Ticks that waited for the trajectory writer.", [] {
+            return (double) _instance->getStalls();
+        });
+    }
+    return _instance;
+}
+
+bool TrajectoryRecorder::start(const string& path) {
+    if (isRecording()) {
+        return false;
+    }
+    file.open(path, ios::binary | ios::trunc);
+    if (!file.good()) {
+        file.close();
+        return false;
+    }
+    writeValue(file, FILE_MAGIC);
+    writeValue(file, FORMAT_VERSION);
+    chunks.clear();
+    chunk.kind = CHUNK_SAMPLES;
+    chunk.rows = 0;
+    eventChunk.kind = CHUNK_EVENTS;
+    eventChunk.rows = 0;
+    events.clear();
+    stalls = 0;
+    bytesWritten = file.tellp();
+
+    for (int i = 0; i < BATCH_COUNT; i++) {
+        batches.push_back(new Batch);
+        empty.push(batches.back());
+    }
+    stopping = false;
+    writer = thread(&TrajectoryRecorder::writeLoop, this);
+    _recording = true;
+
+    static bool registered = false;
+    if (!registered) {
+        registered = true;
+        atexit([] {
+            instance()->stop();
+        });
+    }
+    return true;
+}
+
+void TrajectoryRecorder::record(Model* model) {
+    if (!isRecording()) {
+        return;
+    }
+    Batch* batch;
+    if (!empty.pop(batch)) {
+        stalls++;
+        while (!empty.pop(batch)) {
+            this_thread::yield();
+        }
+    }
+    batch->tick = model->getTick();
+    batch->samples.clear();
+    //The batch takes this tick's Events and leaves its old, emptied list to gather the next's
+    batch->events.swap(events);
+    events.clear();
+    int size = model->getSize();
+    for (int row = 0; row < size; row++) {
+        for (int col = 0; col < size; col++) {
+            //Entities are scattered over the heap, so ask for the ones a few cells on early
+            if (col + PREFETCH_DISTANCE < size) {
+                Entity* ahead = model->getEntity(row, col + PREFETCH_DISTANCE);
+                if (ahead != nullptr) {
+                    __builtin_prefetch(ahead);
+                }
+            }
+            Entity* thing = model->getEntity(row, col);
+            if (thing != nullptr) {
+                Sample sample;
+                sample.id = thing->getId();
+                sample.x = row;
+                sample.y = col;
+                sample.species = thing->getSpecies();
+                thing->saveState(sample.state);
+                batch->samples.push_back(sample);
+            }
+        }
+    }
+    //There are only BATCH_COUNT batches, so the queue always has room
+    full.push(batch);
+}
+
+void TrajectoryRecorder::recordEvent(const Event& event) {
+    if (isRecording()) {
+        events.push_back(event);
+    }
+}
+
+void TrajectoryRecorder::stop() {
+    if (!isRecording()) {
+        return;
+    }
+    _recording = false;
+    stopping = true;
+    writer.join();
+    Batch* batch;
+    while (empty.pop(batch)) {}
+    for (Batch* b : batches) {
+        delete b;
+    }
+    batches.clear();
+}
+
+long TrajectoryRecorder::getStalls() {
+    return stalls;
+}
+
+long long TrajectoryRecorder::getBytesWritten() {
+    return bytesWritten;
+}
+
+void TrajectoryRecorder::writeLoop() {
+    Batch* batch;
+    while (true) {
+        if (full.pop(batch)) {
+            gather(*batch);
+            gatherEvents(*batch);
+            empty.push(batch);
+        } else if (stopping) {
+            break;
+        } else {
+            this_thread::sleep_for(chrono::milliseconds(1));
+        }
+    }
+    //Anything queued between the last empty pop and seeing stopping
+    while (full.pop(batch)) {
+        gather(*batch);
+        gatherEvents(*batch);
+        empty.push(batch);
+    }
+    if (chunk.rows > 0) {
+        writeChunk(chunk, columns);
+    }
+    if (eventChunk.rows > 0) {
+        writeChunk(eventChunk, eventColumns);
+    }
+
+    //The index, then where it starts so a reader can find it from the end of the file
+    int64_t indexOffset = file.tellp();
+    writeValue(file, INDEX_MAGIC);
+    writeValue(file, (uint32_t) chunks.size());
+    for (const ChunkInfo& info : chunks) {
+        writeChunkInfo(file, info, true);
+    }
+    writeValue(file, indexOffset);
+    writeValue(file, INDEX_MAGIC);
+    bytesWritten = file.tellp();
+    file.close();
+}
+
+void TrajectoryRecorder::gather(const Batch& batch) {
+    for (const Sample& sample : batch.samples) {
+        if (chunk.rows == 0) {
+            chunk.firstTick = batch.tick;
+            chunk.minX = chunk.maxX = sample.x;
+            chunk.minY = chunk.maxY = sample.y;
+            chunk.speciesMask = 0;
+            chunk.eventMask = 0;
+        }
+        chunk.lastTick = batch.tick;
+        chunk.rows++;
+        chunk.minX = min(chunk.minX, sample.x);
+        chunk.maxX = max(chunk.maxX, sample.x);
+        chunk.minY = min(chunk.minY, sample.y);
+        chunk.maxY = max(chunk.maxY, sample.y);
+        chunk.speciesMask |= 1u << sample.species;
+
+        columns[COLUMN_TICK].push_back(batch.tick);
+        columns[COLUMN_ID].push_back(sample.id);
+        columns[COLUMN_X].push_back(sample.x);
+        columns[COLUMN_Y].push_back(sample.y);
+        columns[COLUMN_SPECIES].push_back(sample.species);
+        for (int i = 0; i < Entity::STATE_SIZE; i++) {
+            columns[COLUMN_STATE + i].push_back(sample.state[i]);
+        }
+        //Chunks may split a tick, which keeps their memory bounded in huge worlds
+        if (chunk.rows == CHUNK_ROWS) {
+            writeChunk(chunk, columns);
+        }
+    }
+}
+
+void TrajectoryRecorder::gatherEvents(const Batch& batch) {
+    for (const Event& event : batch.events) {
+        if (eventChunk.rows == 0) {
+            eventChunk.firstTick = event.tick;
+            eventChunk.minX = eventChunk.maxX = event.x;
+            eventChunk.minY = eventChunk.maxY = event.y;
+            eventChunk.speciesMask = 0;
+            eventChunk.eventMask = 0;
+        }
+        eventChunk.lastTick = event.tick;
+        eventChunk.rows++;
+        eventChunk.minX = min(eventChunk.minX, event.x);
+        eventChunk.maxX = max(eventChunk.maxX, event.x);
+        eventChunk.minY = min(eventChunk.minY, event.y);
+        eventChunk.maxY = max(eventChunk.maxY, event.y);
+        eventChunk.speciesMask |= 1u << event.species | 1u << event.otherSpecies;
+        eventChunk.eventMask |= 1u << event.type;
+
+        eventColumns[EVENT_COLUMN_TICK].push_back(event.tick);
+        eventColumns[EVENT_COLUMN_TYPE].push_back(event.type);
+        eventColumns[EVENT_COLUMN_SPECIES].push_back(event.species);
+        eventColumns[EVENT_COLUMN_OTHER_SPECIES].push_back(event.otherSpecies);
+        eventColumns[EVENT_COLUMN_ACTOR].push_back(event.actor);
+        eventColumns[EVENT_COLUMN_OTHER].push_back(event.other);
+        eventColumns[EVENT_COLUMN_RESULT].push_back(event.result);
+        eventColumns[EVENT_COLUMN_X].push_back(event.x);
+        eventColumns[EVENT_COLUMN_Y].push_back(event.y);
+        eventColumns[EVENT_COLUMN_ATTACK].push_back(event.attack);
+        eventColumns[EVENT_COLUMN_OTHER_ATTACK].push_back(event.otherAttack);
+    }
+    //Unlike samples, a chunk of Events only ends between ticks, so a tick's Events stay together
+    if (eventChunk.rows >= EVENT_CHUNK_ROWS) {
+        writeChunk(eventChunk, eventColumns);
+    }
+}
+
+void TrajectoryRecorder::writeChunk(ChunkInfo& info, vector<vector<long long>>& chunkColumns) {
+    info.offset = file.tellp();
+    writeValue(file, CHUNK_MAGIC);
+    writeChunkInfo(file, info, false);
+    for (size_t i = 0; i < chunkColumns.size(); i++) {
+        encoded.clear();
+        encodeColumn(chunkColumns[i].data(), chunkColumns[i].size(), encoded);
+        writeValue(file, (uint32_t) encoded.size());
+        file.write(encoded.data(), encoded.size());
+        chunkColumns[i].clear();
+    }
+    chunks.push_back(info);
+    info.rows = 0;
+    bytesWritten = file.tellp();
+}
@@ -0,0 +1,121 @@
+/*Sarah Allen & Joshua Lindquist
+CS132 Winter 2022
+Final Project: Simulation
+
+Class main author: Josh
+
+Header for the TrajectoryRecorder class, which records where every Entity is and what state it is
+in after every tick, and every birth, fight and new Building, for studying how things move and
+meet over a whole run. The simulation thread only copies each Entity's id, position, species and
+saveState(), and the tick's Events, into a reused batch and hands it over through a lock-free
+queue; a background thread turns the batches into the compressed columnar chunks described in
+trajectoryformat.h and writes them out. If the writer falls behind by more than a few ticks the
+simulation waits for it rather than dropping samples, and counts the stall.*/
+
+#ifndef _TRAJECTORYRECORDER_H
+#define _TRAJECTORYRECORDER_H
+
+#include <atomic>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+#include "EventStream.h"
+#include "SpscQueue.h"
+#include "trajectoryformat.h"
+using namespace std;
+
+class Model;
+
+class TrajectoryRecorder {
+public:
+    //Returns the single TrajectoryRecorder object for this process, creating it if needed
+    static TrajectoryRecorder* instance();
+
+    //Returns true between start() and stop(). Cheap enough to check every tick.
+    static bool isRecording();
+
+    //Starts recording into a new file at path, and makes sure it is finished when the program
+    //exits. Returns false if the file can't be written or a recording is already running.
+    bool start(const string& path);
+
+    //Queues one sample of every Entity on the model's map, at the model's tick. The Model calls
+    //this whenever it commits a tick.
+    void record(Model* model);
+
+    //Queues event to be written with the rest of its tick. The Model calls this for every Event
+    //it emits; Events of a tick that is never committed are not written.
+    void recordEvent(const Event& event);
+
+    //Writes out everything queued, adds the index and closes the file
+    void stop();
+
+    //Returns how many times record() had to wait for the writer thread
+    long getStalls();
+
+    //Returns the number of bytes written to the file so far
+    long long getBytesWritten();
+
+private:
+    TrajectoryRecorder();
+
+    //One Entity at one tick, as copied on the simulation thread
+    struct Sample {
+        long id;
+        int x;
+        int y;
+        int species;
+        int state[Entity::STATE_SIZE];
+    };
+
+    //Every Sample and Event of one tick
+    struct Batch {
+        long tick;
+        vector<Sample> samples;
+        vector<Event> events;
+    };
+
+    static const int BATCH_COUNT = 4;       //ticks that can be queued before record() waits
+    static const int CHUNK_ROWS = 1 << 16;  //samples gathered before a chunk is written
+    static const int EVENT_CHUNK_ROWS = 1 << 12; //Events gathered before a chunk of them is written
+    static const int PREFETCH_DISTANCE = 16; //cells ahead record() fetches Entities from
+
+    //Body of the writer thread
+    void writeLoop();
+
+    //Adds a batch to the columns of the chunk being gathered
+    void gather(const Batch& batch);
+
+    //Adds the Events of a batch to the chunk of Events being gathered
+    void gatherEvents(const Batch& batch);
+
+    //Encodes and writes a gathered chunk, then empties it for the next one
+    void writeChunk(ChunkInfo& info, vector<vector<long long>>& chunkColumns);
+
+    static TrajectoryRecorder* _instance;
+    static atomic<bool> _recording;
+
+    SpscQueue<Batch*> full;   //simulation thread to writer thread
+    SpscQueue<Batch*> empty;  //writer thread back to the simulation thread
+    vector<Batch*> batches;
+    thread writer;
+    atomic<bool> stopping;
+    atomic<long> stalls;
+    atomic<long long> bytesWritten;
+    vector<Event> events;                  //Events of the tick being built (simulation thread)
+
+    //Writer thread only:
+    ofstream file;
+    vector<ChunkInfo> chunks;
+    ChunkInfo chunk;                       //the chunk being gathered
+    vector<vector<long long>> columns;     //its columns
+    ChunkInfo eventChunk;                  //the chunk of Events being gathered
+    vector<vector<long long>> eventColumns;
+    string encoded;
+};
+
+inline bool TrajectoryRecorder::isRecording() {
+    return _recording.load(memory_order_relaxed);
+}
+
+#endif
@@ -13,6 +13,10 @@ string Tree::getType() {
     return "Tree";
 }
 
+Species Tree::getSpecies() {
+    return TREE;
+}
+
 string Tree::toString() {
     return "\xF0\x9F\x8C\xB2";
 }
@@ -20,6 +20,9 @@ public:
     //Returns "Tree"
     virtual string getType();
 
+    //Returns TREE
+    virtual Species getSpecies();
+
     //Returns image of a tree using a UTC-8 hex code
     virtual string toString();
 
@@ -0,0 +1,81 @@
+/*Joshua Lindquist & Sarah Allen
+CS132 Winter 2022
+Final Project: Simulation
+
+Cpp file for the Viewer class*/
+
+#include "Viewer.h"
+
+Viewer::Viewer(int windowSize, int squareSize, string path) {
+    this->path = path;
+    this->windowSize = windowSize;
+    this->squareSize = squareSize;
+    frames = nullptr;
+    frame.tick = -1;
+    frame.size = 0;
+    for (int i = 0; i < SPECIES_COUNT; i++) {
+        looks.push_back(Model::typeTranslator((Species) i));
+    }
+
+    window = new GWindow(windowSize, windowSize);
+    window->setExitOnClose(true);
+    window->setBackground("white");
+    window->setColor("black");
+    window->setFillColor("#00DDAA");
+    window->setFont("Arial-9-bold");
+    window->setTitle("Waiting for " + path);
+
+    update();
+    window->setTimerListener(FRAME_DELAY, [this] {
+        this->update();
+    });
+}
+
+void Viewer::draw() {
+    window->clearCanvasPixels();
+    window->setFillColor("#00DDAA");
+    window->drawRect(0, 0, windowSize, windowSize);
+    window->fillRect(0, 0, windowSize, windowSize);
+    for (int row = 0; row < frame.size; row++) {
+        for (int col = 0; col < frame.size; col++) {
+            unsigned char species = frame.grid[row * frame.size + col];
+            //Ignore empty cells and anything this build doesn't know
+            if (species < SPECIES_COUNT && looks[species] != nullptr) {
+                Entity* thing = looks[species];
+                string font = "Arial-" + to_string(thing->getFont()) + "-bold";
+                window->setColor(thing->getColor());
+                window->setFont(font);
+                window->drawString(thing->toString(), row * squareSize, col * squareSize);
+            }
+        }
+    }
+    string title = "Tick " + to_string(frame.tick);
+    for (int i = 0; i < SPECIES_COUNT; i++) {
+        if (i != EMPTY && frame.population[i] > 0) {
+            title += "  " + to_string((Species) i) + ": " + to_string(frame.population[i]);
+        }
+    }
+    window->setTitle(title);
+}
+
+void Viewer::update() {
+    if (frames == nullptr) {
+        frames = SharedFrames::open(path);
+        if (frames == nullptr) {
+            return;
+        }
+    }
+    if (frames->getLatestTick() == frame.tick) {
+        //Nothing new: if the simulation restarted it has a new file, so let go of the old one
+        if (!frames->isReplaced()) {
+            return;
+        }
+        delete frames;
+        frames = nullptr;
+        frame.tick = -1;
+        return;
+    }
+    if (frames->readLatest(frame)) {
+        draw();
+    }
+}
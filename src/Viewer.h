@@ -0,0 +1,45 @@
+/*Sarah Allen & Joshua Lindquist
+CS132 Winter 2022
+Final Project: Simulation
+
+Class main author: Josh
+
+Viewer class header. A Viewer is a window that watches a simulation running in another process
+through the frames it publishes (see SharedFrames), drawing the grid the same way the Gui does.
+It only ever reads the frames, so it can be started, closed and restarted without the simulation
+noticing, and several can watch the same run.*/
+
+#ifndef _VIEWER_H
+#define _VIEWER_H
+
+#include "SharedFrames.h"
+#include "Model.h"
+#include "gwindow.h"
+using namespace sgl;
+
+class Viewer {
+private:
+    //Member variables:
+    GWindow* window;
+    string path;
+    int windowSize;
+    int squareSize;
+    SharedFrames* frames; //nullptr until the simulation has published its file
+    Frame frame;          //last frame drawn
+    vector<Entity*> looks; //one Entity of each Species, asked how to draw that Species
+
+    static const int FRAME_DELAY = 100; //milliseconds between checks for a new frame
+
+public:
+    //Constructor, opens the viewer window and starts watching the frame file at path
+    Viewer(int windowSize, int squareSize, string path);
+
+    //Draws the last frame read
+    void draw();
+
+    //Maps the frame file if it is not mapped yet, then draws the newest frame if it is newer
+    //than the one on screen
+    void update();
+};
+
+#endif
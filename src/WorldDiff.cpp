@@ -0,0 +1,173 @@
+/*Joshua Lindquist & Sarah Allen
+CS132 Winter 2022
+Final Project: Simulation
+
+Cpp file for the WorldDiff class*/
+
+#include "WorldDiff.h"
+#include "SaveLoader.h"
+#include <algorithm>
+#include <cstring>
+#include <thread>
+
+const int WorldDiff::TILE;
+
+WorldDiff::WorldDiff() {
+    size = 0;
+    tilesPerSide = 0;
+    differentTiles = 0;
+    counts.assign(SPECIES_COUNT * SPECIES_COUNT, 0);
+}
+
+bool WorldDiff::tileDiffers(const unsigned char* before, const unsigned char* after, int size,
+                            int row, int col) {
+    int rows = min(TILE, size - row);
+    int cols = min(TILE, size - col);
+    for (int r = 0; r < rows; r++) {
+        size_t first = (size_t) (row + r) * size + col;
+        if (memcmp(before + first, after + first, cols) != 0) {
+            return true;
+        }
+    }
+    return false;
+}
+
+bool WorldDiff::compare(const vector<unsigned char>& before, const vector<unsigned char>& after,
+                        int size, string& error, int threads) {
+    size_t cells = (size_t) size * size;
+    if (size <= 0 || before.size() != cells || after.size() != cells) {
+        error = "the worlds are different sizes";
+        return false;
+    }
+    if (threads <= 0) {
+        threads = thread::hardware_concurrency();
+    }
+    if (threads <= 0) {
+        threads = 1;
+    }
+    this->size = size;
+    tilesPerSide = (size + TILE - 1) / TILE;
+    changes.clear();
+    counts.assign(SPECIES_COUNT * SPECIES_COUNT, 0);
+
+    //Find the tiles that differ; each thread takes every threads-th row of tiles
+    vector<vector<int>> found(threads);
+    vector<thread> workers;
+    for (int i = 0; i < threads; i++) {
+        workers.push_back(thread([this, &before, &after, &found, threads, i] {
+            for (int tileRow = i; tileRow < tilesPerSide; tileRow += threads) {
+                for (int tileCol = 0; tileCol < tilesPerSide; tileCol++) {
+                    int row = tileRow * TILE;
+                    int col = tileCol * TILE;
+                    if (tileDiffers(before.data(), after.data(), this->size, row, col)) {
+                        found[i].push_back(tileRow * tilesPerSide + tileCol);
+                    }
+                }
+            }
+        }));
+    }
+    for (thread& worker : workers) {
+        worker.join();
+    }
+    vector<int> tiles;
+    for (vector<int>& some : found) {
+        tiles.insert(tiles.end(), some.begin(), some.end());
+    }
+    differentTiles = tiles.size();
+
+    //Only the tiles that differ are compared cell by cell
+    vector<vector<CellChange>> changed(threads);
+    vector<vector<long>> tallies(threads, vector<long>(SPECIES_COUNT * SPECIES_COUNT, 0));
+    workers.clear();
+    for (int i = 0; i < threads && i < tiles.size(); i++) {
+        workers.push_back(thread([this, &before, &after, &tiles, &changed, &tallies, threads, i] {
+            for (int t = i; t < tiles.size(); t += threads) {
+                int row = tiles[t] / tilesPerSide * TILE;
+                int col = tiles[t] % tilesPerSide * TILE;
+                for (int r = row; r < min(row + TILE, this->size); r++) {
+                    size_t first = (size_t) r * this->size;
+                    for (int c = col; c < min(col + TILE, this->size); c++) {
+                        unsigned char was = before[first + c];
+                        unsigned char is = after[first + c];
+                        if (was != is) {
+                            changed[i].push_back(CellChange {r, c, (Species) was, (Species) is});
+                            tallies[i][was * SPECIES_COUNT + is]++;
+                        }
+                    }
+                }
+            }
+        }));
+    }
+    for (thread& worker : workers) {
+        worker.join();
+    }
+    for (int i = 0; i < threads; i++) {
+        changes.insert(changes.end(), changed[i].begin(), changed[i].end());
+        for (int k = 0; k < counts.size(); k++) {
+            counts[k] += tallies[i][k];
+        }
+    }
+    sort(changes.begin(), changes.end(), [](const CellChange& a, const CellChange& b) {
+        return a.row != b.row ? a.row < b.row : a.col < b.col;
+    });
+    return true;
+}
+
+bool WorldDiff::compareFiles(const string& beforePath, const string& afterPath, string& error,
+                             int threads) {
+    vector<unsigned char> grids[2];
+    const string* paths[2] = {&beforePath, &afterPath};
+    int sizes[2];
+    for (int i = 0; i < 2; i++) {
+        SaveLoader loader(*paths[i]);
+        if (!loader.isOpen()) {
+            error = "could not read " + *paths[i];
+            return false;
+        }
+        sizes[i] = loader.getSize();
+        loader.parse(grids[i], threads);
+    }
+    if (sizes[0] != sizes[1]) {
+        error = "the worlds are different sizes (" + to_string(sizes[0]) + " and "
+                + to_string(sizes[1]) + " cells across)";
+        return false;
+    }
+    return compare(grids[0], grids[1], sizes[0], error, threads);
+}
+
+const vector<CellChange>& WorldDiff::getChanges() const {
+    return changes;
+}
+
+long WorldDiff::getCount(Species before, Species after) const {
+    return counts[before * SPECIES_COUNT + after];
+}
+
+int WorldDiff::getTileCount() const {
+    return tilesPerSide * tilesPerSide;
+}
+
+int WorldDiff::getDifferentTiles() const {
+    return differentTiles;
+}
+
+void WorldDiff::writeSummary(ostream& out) const {
+    out << "before,after,cells" << endl;
+    for (int was = 0; was < SPECIES_COUNT; was++) {
+        for (int is = 0; is < SPECIES_COUNT; is++) {
+            long count = counts[was * SPECIES_COUNT + is];
+            if (count != 0) {
+                out << to_string((Species) was) << "," << to_string((Species) is) << ","
+                    << count << "\n";
+            }
+        }
+    }
+}
+
+void WorldDiff::writeCsv(ostream& out, const vector<CellChange>& changes) {
+    out << "row,col,before,after" << endl;
+    for (const CellChange& change : changes) {
+        out << change.row << "," << change.col << "," << to_string(change.before) << ","
+            << to_string(change.after) << "\n";
+    }
+}
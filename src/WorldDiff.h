@@ -0,0 +1,80 @@
+/*Sarah Allen & Joshua Lindquist
+CS132 Winter 2022
+Final Project: Simulation
+
+Class main author: Josh
+
+Header for the WorldDiff class, which finds what differs between two saved worlds of the same
+size without looking at every cell one at a time. Both worlds are cut into TILE by TILE tiles,
+split between threads, and each tile's rows are checked with memcmp(), which stops at the first
+row that differs. Only tiles that differ are gone through cell by cell, again in parallel, so two
+huge worlds that barely differ cost about one pass over their memory. The result is every cell
+that changed, with what was there before and after, and how many cells went from each Species
+to each other one.*/
+
+#ifndef _WORLDDIFF_H
+#define _WORLDDIFF_H
+
+#include <ostream>
+#include <string>
+#include <vector>
+#include "entitytypes.h"
+using namespace std;
+
+//One cell that differs between the two worlds
+struct CellChange {
+    int row;
+    int col;
+    Species before;  //EMPTY if something was added here
+    Species after;   //EMPTY if what was here was removed
+};
+
+class WorldDiff {
+public:
+    WorldDiff();
+
+    //Compares two size by size worlds, laid out row by row as SaveLoader::parse() gives them,
+    //using threads threads (0 for one per core). Returns false, with a message in error, if
+    //they aren't both that size.
+    bool compare(const vector<unsigned char>& before, const vector<unsigned char>& after,
+                 int size, string& error, int threads = 0);
+
+    //Loads the saved worlds at beforePath and afterPath and compares them. Returns false, with
+    //a message in error, if either can't be read or they are different sizes.
+    bool compareFiles(const string& beforePath, const string& afterPath, string& error,
+                      int threads = 0);
+
+    //Returns every cell that changed, row by row
+    const vector<CellChange>& getChanges() const;
+
+    //Returns how many cells held before in the first world and after in the second; EMPTY
+    //before counts cells added, EMPTY after counts cells removed
+    long getCount(Species before, Species after) const;
+
+    //Returns how many tiles were compared, and how many of them differ
+    int getTileCount() const;
+    int getDifferentTiles() const;
+
+    //Writes the counts as before,after,cells lines, leaving out pairs that never happened
+    void writeSummary(ostream& out) const;
+
+    //Writes changes as row,col,before,after lines
+    static void writeCsv(ostream& out, const vector<CellChange>& changes);
+
+    //Cells each way in a tile
+    static const int TILE = 64;
+
+private:
+    //Returns true if any cell of the tile whose first cell is (row, col) differs between two
+    //size by size grids
+    static bool tileDiffers(const unsigned char* before, const unsigned char* after, int size,
+                            int row, int col);
+
+    int size;
+    int tilesPerSide;
+    int differentTiles;
+    vector<CellChange> changes;
+    vector<long> counts;  //by before and after Species, SPECIES_COUNT each
+};
+
+#endif
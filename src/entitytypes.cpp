@@ -25,3 +25,19 @@ std::string to_string(Direction direction) {
     }
 }
 int DIRECTION_COUNT = 5;
+
+
+std::string to_string(Species species) {
+    switch (species) {
+        case EMPTY:      return ".";
+        case BUILDING:   return "Building";
+        case DEER:       return "Deer";
+        case HUNTER:     return "Hunter";
+        case LUMBERJACK: return "Lumberjack";
+        case TIGER:      return "Tiger";
+        case TREE:       return "Tree";
+        case ENTITY:     return "Entity";
+        default:         return "unknown";
+    }
+}
+int SPECIES_COUNT = SPECIES_LIMIT;
\ No newline at end of file
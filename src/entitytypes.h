@@ -25,4 +25,22 @@ enum Direction {
 std::string to_string(Direction direction);
 extern int DIRECTION_COUNT;
 
+//Compact id for each kind of Entity, so the model can count and index them without comparing
+//getType() strings. EMPTY stands for a cell with no Entity in it.
+enum Species {
+    EMPTY,
+    BUILDING,
+    DEER,
+    HUNTER,
+    LUMBERJACK,
+    TIGER,
+    TREE,
+    ENTITY
+};
+std::string to_string(Species species);
+extern int SPECIES_COUNT;
+
+//SPECIES_COUNT as a constant, for sizing arrays indexed by Species. ENTITY must stay the last one.
+const int SPECIES_LIMIT = ENTITY + 1;
+
 #endif // _ENTITYTYPES_H
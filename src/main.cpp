@@ -10,6 +10,14 @@ hunters can stand a chance against.
 As for this main() file, it simply creates the GUI.*/
 
 #include "Gui.h"
+#include "geventqueue.h"
+#include "TrajectoryQuery.h"
+#include "TrajectoryRecorder.h"
+#include "Viewer.h"
+#include "BehaviorCounters.h"
+#include "Behavior.h"
+#include "PerfCounters.h"
+#include "WorldDiff.h"
 
 int main() {
     //Changable Parameters:
@@ -20,7 +28,171 @@ int main() {
     int LUMBER_NUM = 1;
     int TREE_NUM = 100;
     int DEER_NUM = 0;
+    int TREE_SIZE = 1;  //cells a Tree (and the Building made from it) covers each way, up to 4
+    string SCENARIO_FILE = "";  //rules for how each species moves, see Behavior.h
+
+    //Only simulate Entities near the area of interest; everywhere else is kept as counts per
+    //16 by 16 block. FOCUS_ROWS = 0 simulates every Entity.
+    int FOCUS_ROW = 0;
+    int FOCUS_COL = 0;
+    int FOCUS_ROWS = 0;
+    int FOCUS_COLS = 0;
+
+    //Live metrics in Prometheus format, leave empty to turn off
+    string METRICS_SOCKET = "";   //Unix-domain socket path, e.g. "/tmp/village-sim.sock"
+    string METRICS_FILE = "";     //file rewritten every METRICS_PERIOD milliseconds
+    int METRICS_PERIOD = 5000;
+    string BEHAVIOR_FILE = "";    //CSV of getMove() branch counts, written when the run ends
+    string TRAJECTORY_FILE = "";  //every Entity's position and state every tick, see TrajectoryReader
+    string EVENT_FILE = "";       //CSV of every birth, fight and new Building
+    //CPU cycles, instructions, cache and branch misses per Entity update for each phase of a
+    //tick, exported with the metrics. Needs Linux and kernel.perf_event_paranoid <= 2.
+    bool HARDWARE_COUNTERS = false;
+    string COUNTER_FILE = "";     //CSV of those counts, written when the run ends
+
+    //Set QUERY_FILE to a recorded trajectory file to print the samples matching QUERY as CSV
+    //instead of simulating, e.g. "ticks=5000-6000 near=25,25,10 species=Tiger,Hunter", or the
+    //births, fights and new Buildings, e.g. "events=fight between=Tiger,Hunter near=25,25,10"
+    string QUERY_FILE = "";
+    string QUERY = "";
+
+    if (QUERY_FILE != "") {
+        TrajectoryReader reader(QUERY_FILE);
+        TrajectoryQuery query(reader);
+        string error;
+        if (!reader.isOpen()) {
+            cout << "Could not read " << QUERY_FILE << endl;
+        } else if (!query.parse(QUERY, error)) {
+            cout << "Bad query: " << error << endl;
+        } else {
+            if (query.isEventQuery()) {
+                TrajectoryQuery::writeEventCsv(cout, query.events());
+            } else {
+                TrajectoryQuery::writeCsv(cout, query.run());
+            }
+            cout << "Read " << query.getChunksRead() << " of " << query.getChunkCount()
+                 << " chunks" << endl;
+            if (query.getChunksFailed() > 0) {
+                cout << query.getChunksFailed() << " chunks of " << QUERY_FILE
+                     << " are damaged or cut short, so these results are incomplete" << endl;
+            }
+        }
+        return 0;
+    }
+
+    //Set DIFF_FILE and DIFF_AGAINST to two saved worlds to print how many cells changed from
+    //each species to each other one instead of simulating, and every changed cell as CSV to
+    //DIFF_OUTPUT if it isn't empty
+    string DIFF_FILE = "";
+    string DIFF_AGAINST = "";
+    string DIFF_OUTPUT = "";
+
+    if (DIFF_FILE != "") {
+        WorldDiff diff;
+        string error;
+        if (!diff.compareFiles(DIFF_FILE, DIFF_AGAINST, error)) {
+            cout << "Could not compare: " << error << endl;
+            return 1;
+        }
+        diff.writeSummary(cout);
+        cout << diff.getChanges().size() << " cells changed in " << diff.getDifferentTiles()
+             << " of " << diff.getTileCount() << " tiles" << endl;
+        if (DIFF_OUTPUT != "") {
+            ofstream output(DIFF_OUTPUT);
+            WorldDiff::writeCsv(output, diff.getChanges());
+            if (!output.good()) {
+                cout << "Could not write " << DIFF_OUTPUT << endl;
+            }
+        }
+        return 0;
+    }
+
+    //Live view from other processes: the simulation publishes every tick to FRAMES_FILE, and a
+    //copy of the program started with VIEWER = true watches it instead of simulating
+    string FRAMES_FILE = "";      //e.g. "/dev/shm/village-sim.frames", leave empty to turn off
+    bool VIEWER = false;
+
+    if (VIEWER) {
+        new Viewer(MODEL_SIZE, SQUARE_SIZE, FRAMES_FILE);
+        return 0;
+    }
+
+    string scenarioError;
+    if (SCENARIO_FILE != "" && !Behavior::load(SCENARIO_FILE, scenarioError)) {
+        cout << "Bad scenario: " << scenarioError << endl;
+        return 1;
+    }
+    Model::setFootprint(TREE, TREE_SIZE, TREE_SIZE);
+    Model::setFootprint(BUILDING, TREE_SIZE, TREE_SIZE);
+
+    if (METRICS_SOCKET != "") {
+        Metrics::instance()->serve(METRICS_SOCKET);
+    }
+    if (METRICS_FILE != "") {
+        Metrics::instance()->startFileExporter(METRICS_FILE, METRICS_PERIOD);
+    }
+    if (BEHAVIOR_FILE != "") {
+        BehaviorCounters::instance()->writeRunAtExit(BEHAVIOR_FILE);
+    }
+    if (HARDWARE_COUNTERS) {
+        if (!PerfCounters::instance()->enable()) {
+            cout << "Hardware counters are not available, running without them" << endl;
+        } else if (COUNTER_FILE != "") {
+            PerfCounters::instance()->writeRunAtExit(COUNTER_FILE);
+        }
+    }
+    if (EVENT_FILE != "" && !EventStream::instance()->writeCsv(EVENT_FILE)) {
+        cout << "Could not write events to " << EVENT_FILE << endl;
+    }
+    if (TRAJECTORY_FILE != "" && !TrajectoryRecorder::instance()->start(TRAJECTORY_FILE)) {
+        cout << "Could not record trajectories to " << TRAJECTORY_FILE << endl;
+    }
+
+    //Record every button click, key press and timer frame the Gui gets to INPUT_RECORDING,
+    //written when the window closes. Set REPLAY_RECORDING to such a file instead to send its
+    //events to a new Gui, made with the same parameters, as fast as it can take them (or at
+    //the recorded pace with REPLAY_REAL_TIME), then print how long each event and frame took,
+    //also to REPLAY_REPORT if it isn't empty, and exit. Run with QT_QPA_PLATFORM=offscreen to
+    //replay without a window on screen. Save and Load still ask for file names on cin.
+    string INPUT_RECORDING = "";
+    string REPLAY_RECORDING = "";
+    bool REPLAY_REAL_TIME = false;
+    string REPLAY_REPORT = "";
+
+    GEventQueue* events = GEventQueue::instance();
+    if (REPLAY_RECORDING != "" && !events->loadRecording(REPLAY_RECORDING)) {
+        cout << "Could not read a recording from " << REPLAY_RECORDING << endl;
+        return 1;
+    }
+    if (REPLAY_RECORDING == "" && INPUT_RECORDING != "") {
+        static string recordingPath = INPUT_RECORDING;
+        events->startRecording();
+        atexit([] {
+            if (!GEventQueue::instance()->saveRecording(recordingPath)) {
+                cout << "Could not write the recording to " << recordingPath << endl;
+            }
+        });
+    }
    
-    new Gui(MODEL_SIZE, SQUARE_SIZE, TIGER_NUM, HUNTER_NUM, LUMBER_NUM, TREE_NUM, DEER_NUM);
+    Gui* gui = new Gui(MODEL_SIZE, SQUARE_SIZE, TIGER_NUM, HUNTER_NUM, LUMBER_NUM, TREE_NUM, DEER_NUM);
+    if (FOCUS_ROWS > 0) {
+        gui->setFocus(FOCUS_ROW, FOCUS_COL, FOCUS_ROWS, FOCUS_COLS);
+    }
+    if (FRAMES_FILE != "") {
+        gui->publishFrames(FRAMES_FILE);
+    }
+
+    if (REPLAY_RECORDING != "") {
+        GReplayStats stats = events->replay(REPLAY_REAL_TIME);
+        cout << stats.toString();
+        if (REPLAY_REPORT != "") {
+            ofstream report(REPLAY_REPORT);
+            report << stats.toString();
+            if (!report.good()) {
+                cout << "Could not write " << REPLAY_REPORT << endl;
+            }
+        }
+        exitGraphics();
+    }
     return 0;
 }
\ No newline at end of file
@@ -0,0 +1,209 @@
+//Cpp for the trajectory file format
+
+
+#include "trajectoryformat.h"
+#include <cstring>
+
+static_assert(SPECIES_LIMIT <= 32, "ChunkInfo::speciesMask has a bit per Species");
+
+std::string to_string(Column column) {
+    switch (column) {
+        case COLUMN_TICK:    return "tick";
+        case COLUMN_ID:      return "id";
+        case COLUMN_X:       return "x";
+        case COLUMN_Y:       return "y";
+        case COLUMN_SPECIES: return "species";
+        default:
+            if (column > COLUMN_SPECIES && column < COLUMN_COUNT) {
+                return "state" + std::to_string(column - COLUMN_STATE);
+            }
+            return "unknown";
+    }
+}
+int COLUMN_COUNT = COLUMN_STATE + Entity::STATE_SIZE;
+
+std::string to_string(EventColumn column) {
+    switch (column) {
+        case EVENT_COLUMN_TICK:          return "tick";
+        case EVENT_COLUMN_TYPE:          return "type";
+        case EVENT_COLUMN_SPECIES:       return "species";
+        case EVENT_COLUMN_OTHER_SPECIES: return "other_species";
+        case EVENT_COLUMN_ACTOR:         return "actor";
+        case EVENT_COLUMN_OTHER:         return "other";
+        case EVENT_COLUMN_RESULT:        return "result";
+        case EVENT_COLUMN_X:             return "x";
+        case EVENT_COLUMN_Y:             return "y";
+        case EVENT_COLUMN_ATTACK:        return "attack";
+        case EVENT_COLUMN_OTHER_ATTACK:  return "other_attack";
+        default:                         return "unknown";
+    }
+}
+int EVENT_COLUMN_COUNT = EVENT_COLUMN_OTHER_ATTACK + 1;
+
+int columnCount(const ChunkInfo& info) {
+    return info.kind == CHUNK_EVENTS ? EVENT_COLUMN_COUNT : COLUMN_COUNT;
+}
+
+//Zigzag: 0, -1, 1, -2, ... become 0, 1, 2, 3, ... so small steps either way need few bits
+static uint64_t zigzag(long long value) {
+    return ((uint64_t) value << 1) ^ (uint64_t) (value >> 63);
+}
+
+static long long unzigzag(uint64_t value) {
+    return (long long) (value >> 1) ^ -(long long) (value & 1);
+}
+
+//Writes values of a fixed number of bits, lowest bits first
+class BitWriter {
+public:
+    BitWriter(std::string& out) : out(out), bits(0), count(0) {}
+
+    void put(uint64_t value, int width) {
+        //At most 7 bits are left over between calls, so 32 more always fit in 64
+        if (width > 32) {
+            put(value & 0xffffffffu, 32);
+            put(value >> 32, width - 32);
+            return;
+        }
+        bits |= value << count;
+        count += width;
+        while (count >= 8) {
+            out.push_back((char) (bits & 0xff));
+            bits >>= 8;
+            count -= 8;
+        }
+    }
+
+    void flush() {
+        if (count > 0) {
+            out.push_back((char) (bits & 0xff));
+        }
+        bits = 0;
+        count = 0;
+    }
+
+private:
+    std::string& out;
+    uint64_t bits;
+    int count;
+};
+
+//Reads what BitWriter wrote. Running past end reads zeros and sets overrun.
+class BitReader {
+public:
+    BitReader(const char* in, const char* end) : in(in), end(end), bits(0), count(0), overrun(false) {}
+
+    uint64_t get(int width) {
+        if (width > 32) {
+            uint64_t low = get(32);
+            return low | get(width - 32) << 32;
+        }
+        while (count < width) {
+            if (in == end) {
+                overrun = true;
+                return 0;
+            }
+            bits |= (uint64_t) (unsigned char) *in++ << count;
+            count += 8;
+        }
+        uint64_t value = width == 0 ? 0 : bits & (~0ull >> (64 - width));
+        bits >>= width;
+        count -= width;
+        return value;
+    }
+
+    //Skips what is left of the current byte, as BitWriter::flush() does
+    void align() {
+        bits = 0;
+        count = 0;
+    }
+
+    const char* in;
+    const char* end;
+    uint64_t bits;
+    int count;
+    bool overrun;
+};
+
+void encodeColumn(const long long* values, size_t count, std::string& out) {
+    BitWriter writer(out);
+    uint64_t deltas[BLOCK_SIZE];
+    long long previous = 0;
+    for (size_t start = 0; start < count; start += BLOCK_SIZE) {
+        size_t blockSize = count - start < (size_t) BLOCK_SIZE ? count - start : BLOCK_SIZE;
+        uint64_t all = 0;
+        for (size_t i = 0; i < blockSize; i++) {
+            deltas[i] = zigzag(values[start + i] - previous);
+            previous = values[start + i];
+            all |= deltas[i];
+        }
+        int width = 0;
+        while (width < 64 && (all >> width) != 0) {
+            width++;
+        }
+        out.push_back((char) width);
+        for (size_t i = 0; i < blockSize; i++) {
+            writer.put(deltas[i], width);
+        }
+        writer.flush();
+    }
+}
+
+bool decodeColumn(const char* in, const char* end, size_t count, std::vector<long long>& values) {
+    values.resize(count);
+    BitReader reader(in, end);
+    long long previous = 0;
+    for (size_t start = 0; start < count; start += BLOCK_SIZE) {
+        size_t blockSize = count - start < (size_t) BLOCK_SIZE ? count - start : BLOCK_SIZE;
+        if (reader.in == end) {
+            return false;
+        }
+        int width = (unsigned char) *reader.in++;
+        if (width > 64) {
+            return false;
+        }
+        for (size_t i = 0; i < blockSize; i++) {
+            previous += unzigzag(reader.get(width));
+            values[start + i] = previous;
+        }
+        reader.align();
+    }
+    return !reader.overrun;
+}
+
+template <typename T>
+static void writeValue(std::ostream& out, T value) {
+    out.write((const char*) &value, sizeof(value));
+}
+
+template <typename T>
+static bool readValue(std::istream& in, T& value) {
+    return (bool) in.read((char*) &value, sizeof(value));
+}
+
+void writeChunkInfo(std::ostream& out, const ChunkInfo& info, bool withOffset) {
+    if (withOffset) {
+        writeValue(out, info.offset);
+    }
+    writeValue(out, info.kind);
+    writeValue(out, info.firstTick);
+    writeValue(out, info.lastTick);
+    writeValue(out, info.rows);
+    writeValue(out, info.minX);
+    writeValue(out, info.maxX);
+    writeValue(out, info.minY);
+    writeValue(out, info.maxY);
+    writeValue(out, info.speciesMask);
+    writeValue(out, info.eventMask);
+}
+
+bool readChunkInfo(std::istream& in, ChunkInfo& info, bool withOffset) {
+    if (withOffset && !readValue(in, info.offset)) {
+        return false;
+    }
+    return readValue(in, info.kind) && readValue(in, info.firstTick)
+            && readValue(in, info.lastTick) && readValue(in, info.rows)
+            && readValue(in, info.minX) && readValue(in, info.maxX)
+            && readValue(in, info.minY) && readValue(in, info.maxY)
+            && readValue(in, info.speciesMask) && readValue(in, info.eventMask);
+}
@@ -0,0 +1,111 @@
+//Layout of the trajectory files written by TrajectoryRecorder and read by TrajectoryReader.
+//
+//A file is the FILE_MAGIC and FORMAT_VERSION, then chunks, then an index. Every chunk holds the
+//samples (one per Entity per tick) of a run of whole ticks, stored column by column: each column
+//is cut into blocks of BLOCK_SIZE values, and every block keeps only the difference of each value
+//from the one before it (zigzagged so small negative steps stay small), packed into just as many
+//bits as its largest difference needs. Neighboring samples are neighboring cells, so most columns
+//shrink to a few bits a value, and the tick column to almost nothing.
+//
+//Chunks of Events (births, fights and new Buildings, see EventStream) are kept the same way,
+//column by column, between the sample chunks. Each holds the Events of a run of whole ticks.
+//
+//Each chunk starts with a ChunkInfo (kind, ticks, rows, bounding box, species and event types it
+//covers), so a reader can tell whether a chunk matters to it without decoding anything. The index
+//repeats those, with the offset of each chunk, at the end of the file; a file cut short without
+//its index can still be read by walking the chunk headers. Numbers are in the byte order of the
+//machine that wrote them.
+
+#ifndef _TRAJECTORYFORMAT_H
+#define _TRAJECTORYFORMAT_H
+
+#include <cstdint>
+#include <istream>
+#include <ostream>
+#include <string>
+#include <vector>
+#include "Entity.h"
+
+//The columns of a chunk, in the order they are stored
+enum Column {
+    COLUMN_TICK,
+    COLUMN_ID,
+    COLUMN_X,        //row of the map the Entity is in
+    COLUMN_Y,        //column of the map the Entity is in
+    COLUMN_SPECIES,
+    COLUMN_STATE     //first of Entity::STATE_SIZE saveState() columns
+};
+std::string to_string(Column column);
+extern int COLUMN_COUNT;
+
+//The columns of a chunk of Events, in the order they are stored
+enum EventColumn {
+    EVENT_COLUMN_TICK,
+    EVENT_COLUMN_TYPE,
+    EVENT_COLUMN_SPECIES,
+    EVENT_COLUMN_OTHER_SPECIES,
+    EVENT_COLUMN_ACTOR,
+    EVENT_COLUMN_OTHER,
+    EVENT_COLUMN_RESULT,
+    EVENT_COLUMN_X,
+    EVENT_COLUMN_Y,
+    EVENT_COLUMN_ATTACK,
+    EVENT_COLUMN_OTHER_ATTACK
+};
+std::string to_string(EventColumn column);
+extern int EVENT_COLUMN_COUNT;
+
+//What the rows of a chunk are
+enum ChunkKind {
+    CHUNK_SAMPLES,  //one per Entity per tick, in Columns
+    CHUNK_EVENTS    //one per Event, in EventColumns
+};
+
+//Bit set of every column, for reading whole chunks
+const unsigned int ALL_COLUMNS = ~0u;
+
+const uint32_t FILE_MAGIC = 0x4a525456;    //"VTRJ"
+const uint32_t CHUNK_MAGIC = 0x4b4e4843;   //"CHNK"
+const uint32_t INDEX_MAGIC = 0x58444e49;   //"INDX"
+const uint32_t FORMAT_VERSION = 2;
+const int BLOCK_SIZE = 128;
+
+//What a chunk covers. The ranges are inclusive.
+struct ChunkInfo {
+    int64_t offset;       //where the chunk starts in the file (index only)
+    uint32_t kind;        //a ChunkKind
+    int64_t firstTick;
+    int64_t lastTick;
+    int64_t rows;
+    int32_t minX;
+    int32_t maxX;
+    int32_t minY;
+    int32_t maxY;
+    uint32_t speciesMask; //bit s set if a sample of Species s is in the chunk, or an Event
+                          //with an actor or other of Species s
+    uint32_t eventMask;   //bit t set if an Event of EventType t is in the chunk
+};
+
+//The decoded columns of one chunk. Columns that were not asked for are left empty.
+struct TrajectoryChunk {
+    ChunkInfo info;
+    std::vector<std::vector<long long>> columns;
+};
+
+//Returns the number of columns a chunk of info's kind has
+int columnCount(const ChunkInfo& info);
+
+//Appends count values to out in the packed column format
+void encodeColumn(const long long* values, size_t count, std::string& out);
+
+//Reads count values packed by encodeColumn() from the bytes between in and end. Returns false if
+//the bytes run out first.
+bool decodeColumn(const char* in, const char* end, size_t count, std::vector<long long>& values);
+
+//Writes the fields of a ChunkInfo; the offset is only written when withOffset is true
+void writeChunkInfo(std::ostream& out, const ChunkInfo& info, bool withOffset);
+
+//Reads the fields written by writeChunkInfo(). Returns false if the stream ran out.
+bool readChunkInfo(std::istream& in, ChunkInfo& info, bool withOffset);
+
+#endif // _TRAJECTORYFORMAT_H
@@ -0,0 +1,162 @@
+/*Joshua Lindquist & Sarah Allen
+CS132 Winter 2022
+Final Project: Simulation
+
+Checks that once a Model is running, a tick allocates nothing but the Entities born or built in
+it. Global operator new is replaced to count what the ticking thread allocates, and the births
+and Buildings are counted from the EventStream. Runs a mixed world plain, with a perception
+stencil and with footprints, and returns 1 if any tick allocated more than expected.*/
+
+#include <atomic>
+#include <chrono>
+#include <cstdlib>
+#include <iostream>
+#include <new>
+#include <thread>
+#include "Model.h"
+#include "EventStream.h"
+
+using namespace std;
+
+//Only the thread running the ticks counts; the EventStream dispatcher allocates on its own
+static thread_local bool counting = false;
+static thread_local long allocations = 0;
+
+void* operator new(size_t size) {
+    if (counting) {
+        allocations++;
+    }
+    void* p = malloc(size == 0 ? 1 : size);
+    if (p == nullptr) {
+        throw bad_alloc();
+    }
+    return p;
+}
+
+void* operator new[](size_t size) {
+    return operator new(size);
+}
+
+void operator delete(void* p) noexcept {
+    free(p);
+}
+
+void operator delete[](void* p) noexcept {
+    free(p);
+}
+
+void operator delete(void* p, size_t) noexcept {
+    free(p);
+}
+
+void operator delete[](void* p, size_t) noexcept {
+    free(p);
+}
+
+static const int WARMUP_TICKS = 5;   //the first ticks set up Perception and the spare map
+static const int CHECKED_TICKS = 50;
+static const long FIRST = -1;        //ticks of the marker Events sent before and after the run
+static const long LAST = -2;
+
+//Returns how many allocations making an Entity of species takes
+static long constructionCost(Species species) {
+    counting = true;
+    allocations = 0;
+    Entity* e = Model::typeTranslator(species);
+    counting = false;
+    delete e;
+    return allocations;
+}
+
+//Runs a mixed world and returns false, after printing why, if a tick allocated anything
+//besides its births and Buildings
+static bool check(const string& name) {
+    vector<long> cost(SPECIES_COUNT, 0);
+    for (int s = 0; s < SPECIES_COUNT; s++) {
+        cost[s] = constructionCost((Species) s);
+    }
+
+    //Expected allocations of each tick, from the Events it sent
+    vector<long> expected(WARMUP_TICKS + CHECKED_TICKS + 2, 0);
+    vector<long> births(expected.size(), 0);
+    vector<long> builds(expected.size(), 0);
+    atomic<bool> done(false);
+    EventStream* stream = EventStream::instance();
+    int id = stream->subscribe([&](const Event& event) {
+        if (event.tick == LAST) {
+            done = true;
+        }
+        if (event.tick < 0 || event.tick >= (long) expected.size()) {
+            return;
+        }
+        if (event.type == EVENT_BIRTH) {
+            expected[event.tick] += cost[event.species];
+            births[event.tick]++;
+        } else if (event.type == EVENT_BUILD) {
+            expected[event.tick] += cost[BUILDING];
+            builds[event.tick]++;
+        }
+    });
+    //Registers this thread's ring before anything is counted
+    Event marker = Event();
+    marker.tick = FIRST;
+    EventStream::emit(marker);
+
+    Model model(60, 20, 40, 40, 300, 150);
+    for (int t = 0; t < WARMUP_TICKS; t++) {
+        model.update();
+    }
+    vector<long> counted(expected.size(), 0);
+    for (int t = 0; t < CHECKED_TICKS; t++) {
+        counting = true;
+        allocations = 0;
+        model.update();
+        counting = false;
+        counted[model.getTick()] = allocations;
+    }
+
+    //The ring is delivered in order, so once the last marker is seen every Event has been
+    marker.tick = LAST;
+    EventStream::emit(marker);
+    while (!done) {
+        this_thread::sleep_for(chrono::milliseconds(1));
+    }
+    stream->unsubscribe(id);
+    long long dropped = stream->getOverflow();
+
+    bool ok = true;
+    long totalBirths = 0;
+    long totalBuilds = 0;
+    for (int t = WARMUP_TICKS + 1; t <= WARMUP_TICKS + CHECKED_TICKS; t++) {
+        totalBirths += births[t];
+        totalBuilds += builds[t];
+        if (counted[t] > expected[t]) {
+            cout << name << ": tick " << t << " allocated " << counted[t] << " times, but only "
+                 << births[t] << " births and " << builds[t] << " Buildings ("
+                 << expected[t] << " allocations) happened" << endl;
+            ok = false;
+        }
+    }
+    if (dropped > 0) {
+        cout << name << ": " << dropped << " Events were dropped" << endl;
+        ok = false;
+    }
+    cout << name << ": " << (ok ? "ok" : "FAILED") << ", " << CHECKED_TICKS << " ticks, "
+         << totalBirths << " births, " << totalBuilds << " Buildings" << endl;
+    return ok;
+}
+
+int main() {
+    bool ok = check("plain");
+
+    Model::setPerception(STENCIL_DIAMOND, 2);
+    ok = check("perception") && ok;
+    Model::setPerception(STENCIL_SQUARE, 0);
+
+    Model::setFootprint(TREE, 2, 2);
+    Model::setFootprint(BUILDING, 2, 2);
+    ok = check("footprints") && ok;
+
+    EventStream::instance()->stop();
+    return ok ? 0 : 1;
+}
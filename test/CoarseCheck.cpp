@@ -0,0 +1,114 @@
+/*Joshua Lindquist & Sarah Allen
+CS132 Winter 2022
+Final Project: Simulation
+
+Checks that coarse blocks keep every Entity. First a world of full coarse blocks is stepped, and
+no block may end up holding more than it has cells. Then a crowded world is focused on one
+corner, so the rest is coarsened, run for a while as counts, and then refined again by clearing
+the focus. Coarsening and refining happen when a tick starts, so the populations are compared
+straight after that, before anything moves: each Species must have as many as just before, and
+nothing may have been left without a cell. Returns 1 if any of that fails.*/
+
+#include <iostream>
+#include <vector>
+#include "CoarseBlocks.h"
+#include "Model.h"
+#include "SimRandom.h"
+
+using namespace std;
+
+static const int SIZE = 64;
+static const int TICKS = 40;
+
+//Starts the next tick without moving anything but a few cells, so the focus has just been
+//applied, and returns false, after printing which, if a Species' total differs from before
+static bool startTick(Model& model, const long before[], const string& what) {
+    model.stepUpdate(0);
+    bool ok = true;
+    for (int s = EMPTY + 1; s < SPECIES_COUNT; s++) {
+        long after = model.getPopulation((Species) s);
+        if (after != before[s]) {
+            cout << "seed " << SimRandom::getSeed() << ", " << what << ": " << before[s] << " "
+                 << to_string((Species) s) << " before but " << after << " after" << endl;
+            ok = false;
+        }
+    }
+    while (!model.stepUpdate(-1)) {}
+    return ok;
+}
+
+//Steps coarse blocks laid out like a checkerboard, blocks full of Trees next to blocks with a
+//few Deer, which don't walk into Trees but do wander over the edge. Returns false, after printing
+//which, if any block ends up with more Entities than cells.
+static bool checkFull(unsigned long long seed) {
+    SimRandom::seed(seed);
+    CoarseBlocks blocks(SIZE);
+    int perSide = SIZE / CoarseBlocks::BLOCK;
+    for (int b = 0; b < blocks.getBlockCount(); b++) {
+        blocks.setCoarse(b, true);
+        if ((b / perSide + b % perSide) % 2 == 0) {
+            blocks.setCount(b, TREE, CoarseBlocks::BLOCK * CoarseBlocks::BLOCK);
+        } else {
+            blocks.setCount(b, DEER, 20 + SimRandom::below(20));
+        }
+    }
+    vector<Arrival> arrivals;
+    for (int t = 0; t < TICKS; t++) {
+        blocks.step(t, arrivals);
+        for (int b = 0; b < blocks.getBlockCount(); b++) {
+            int held = 0;
+            for (int s = EMPTY + 1; s < SPECIES_COUNT; s++) {
+                held += blocks.getCount(b, (Species) s);
+            }
+            if (held > CoarseBlocks::BLOCK * CoarseBlocks::BLOCK) {
+                cout << "seed " << seed << ", tick " << t << ": block " << b << " holds " << held
+                     << " Entities in " << CoarseBlocks::BLOCK * CoarseBlocks::BLOCK << " cells"
+                     << endl;
+                return false;
+            }
+        }
+    }
+    cout << "seed " << seed << ", full blocks: ok" << endl;
+    return true;
+}
+
+static bool check(unsigned long long seed) {
+    SimRandom::seed(seed);
+    //Most cells taken, so blocks fill up
+    Model model(SIZE, 500, 1500, 1500, 3000, 3000);
+    long before[SPECIES_LIMIT];
+    for (int s = 0; s < SPECIES_COUNT; s++) {
+        before[s] = model.getPopulation((Species) s);
+    }
+
+    model.setFocus(0, 0, 8, 8);
+    bool ok = startTick(model, before, "coarsening");
+    for (int t = 1; t < TICKS; t++) {
+        model.update();
+    }
+
+    for (int s = 0; s < SPECIES_COUNT; s++) {
+        before[s] = model.getPopulation((Species) s);
+    }
+    model.clearFocus();
+    ok = startTick(model, before, "refining") && ok;
+    if (model.getUnplaced() > 0) {
+        cout << "seed " << seed << ": " << model.getUnplaced() << " Entities had no free cell"
+             << endl;
+        ok = false;
+    }
+    if (ok) {
+        cout << "seed " << seed << ": ok" << endl;
+    }
+    return ok;
+}
+
+int main() {
+    bool ok = true;
+    unsigned long long seeds[] = {1, 2022, 77};
+    for (unsigned long long seed : seeds) {
+        ok = checkFull(seed) && ok;
+        ok = check(seed) && ok;
+    }
+    return ok ? 0 : 1;
+}
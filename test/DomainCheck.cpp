@@ -0,0 +1,75 @@
+/*Joshua Lindquist & Sarah Allen
+CS132 Winter 2022
+Final Project: Simulation
+
+Checks that a DomainRunner gives exactly the world one Model gives. For a few seeds and numbers of
+strips it runs both side by side, compares every cell of the runner's snapshot() with the Model
+every few ticks, and reports the first cells that differ. Returns 1 if any did.*/
+
+#include <iostream>
+#include <vector>
+#include "DomainRunner.h"
+#include "Model.h"
+#include "SimRandom.h"
+
+using namespace std;
+
+static const int SIZE = 48;
+static const int TICKS = 120;
+static const int TICKS_PER_COMPARE = 10;
+static const int MAX_REPORTED = 5;   //differing cells printed per comparison
+
+//Runs one seed with strips domains and returns false, after printing where, if the worlds differ
+static bool check(unsigned long long seed, int strips) {
+    //The runner forks its domains, so it is made before anything else
+    SimRandom::seed(seed);
+    DomainRunner runner(SIZE, strips, 20, 30, 30, 250, 120);
+    Model model(SIZE, 20, 30, 30, 250, 120);
+
+    vector<unsigned char> grid;
+    for (int t = 0; t < TICKS; t += TICKS_PER_COMPARE) {
+        if (!runner.update(TICKS_PER_COMPARE) || !runner.snapshot(grid)) {
+            cout << "seed " << seed << ", " << strips << " strips: a domain process died" << endl;
+            return false;
+        }
+        for (int i = 0; i < TICKS_PER_COMPARE; i++) {
+            model.update();
+        }
+
+        int mismatches = 0;
+        for (int row = 0; row < SIZE; row++) {
+            for (int col = 0; col < SIZE; col++) {
+                Entity* e = model.getEntity(row, col);
+                Species expected = e == nullptr ? EMPTY : e->getSpecies();
+                Species found = (Species) grid[row * SIZE + col];
+                if (found != expected) {
+                    if (mismatches < MAX_REPORTED) {
+                        cout << "seed " << seed << ", " << strips << " strips, tick "
+                             << model.getTick() << ": (" << row << ", " << col << ") is "
+                             << to_string(found) << " but Model has " << to_string(expected)
+                             << endl;
+                    }
+                    mismatches++;
+                }
+            }
+        }
+        if (mismatches > 0) {
+            cout << "seed " << seed << ", " << strips << " strips: " << mismatches
+                 << " cells differ at tick " << model.getTick() << endl;
+            return false;
+        }
+    }
+    cout << "seed " << seed << ", " << strips << " strips: ok, " << TICKS << " ticks" << endl;
+    return true;
+}
+
+int main() {
+    bool ok = true;
+    unsigned long long seeds[] = {1, 2022};
+    for (unsigned long long seed : seeds) {
+        for (int strips = 2; strips <= 4; strips++) {
+            ok = check(seed, strips) && ok;
+        }
+    }
+    return ok ? 0 : 1;
+}
@@ -0,0 +1,110 @@
+/*Joshua Lindquist & Sarah Allen
+CS132 Winter 2022
+Final Project: Simulation
+
+Checks Perception against counting every neighbourhood by hand. For both stencil shapes and a
+few radii it fills a random grid, runs compute(), and compares counts() and touching() for every
+cell with a plain loop over the stencil, wrapping around the edges the way the Model does. One
+grid holds more of one Species in a row than 16 bits can count. Returns 1 if any cell differs.*/
+
+#include <algorithm>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+#include "Perception.h"
+#include "SimRandom.h"
+
+using namespace std;
+
+static const int MAX_REPORTED = 5;   //differing cells printed per grid
+
+//Returns true if (dr, dc) is in the stencil, the cell itself included
+static bool inStencil(StencilShape shape, int radius, int dr, int dc) {
+    if (shape == STENCIL_SQUARE) {
+        return abs(dr) <= radius && abs(dc) <= radius;
+    }
+    return abs(dr) + abs(dc) <= radius;
+}
+
+//Checks one random grid and returns false, after printing where, if Perception gets it wrong
+static bool check(StencilShape shape, int radius, int rows, int cols) {
+    vector<unsigned char> grid((size_t) rows * cols);
+    vector<OccupancyMap> layers(SPECIES_COUNT, OccupancyMap(rows, cols));
+    for (int row = 0; row < rows; row++) {
+        for (int col = 0; col < cols; col++) {
+            //Mostly empty, like a real map
+            int draw = SimRandom::below(2 * SPECIES_COUNT);
+            Species s = (Species) (draw < SPECIES_COUNT ? draw : EMPTY);
+            grid[(size_t) row * cols + col] = s;
+            layers[s].set(row, col);
+        }
+    }
+    Perception perception(shape, radius, rows, cols);
+    perception.compute(layers);
+    int k = perception.getRadius();
+
+    static const int rowSteps[] = {0, 1, 1, 1, 0, -1, -1, -1};
+    static const int colSteps[] = {-1, -1, 0, 1, 1, 1, 0, -1};
+    int mismatches = 0;
+    vector<int> expected(SPECIES_COUNT);
+    unsigned char touching[SPECIES_LIMIT];
+    for (int row = 0; row < rows; row++) {
+        for (int col = 0; col < cols; col++) {
+            fill(expected.begin(), expected.end(), 0);
+            for (int dr = -k; dr <= k; dr++) {
+                for (int dc = -k; dc <= k; dc++) {
+                    if ((dr != 0 || dc != 0) && inStencil(shape, k, dr, dc)) {
+                        int r = ((row + dr) % rows + rows) % rows;
+                        int c = ((col + dc) % cols + cols) % cols;
+                        expected[grid[(size_t) r * cols + c]]++;
+                    }
+                }
+            }
+            int expectedTouching[SPECIES_LIMIT] = {0};
+            for (int i = 0; i < 8; i++) {
+                int r = (row + rowSteps[i] + rows) % rows;
+                int c = (col + colSteps[i] + cols) % cols;
+                expectedTouching[grid[(size_t) r * cols + c]] |= 1 << i;
+            }
+
+            const unsigned char* counts = perception.counts(row, col);
+            perception.touching(row, col, touching);
+            for (int s = 0; s < SPECIES_COUNT; s++) {
+                if (counts[s] == min(expected[s], 255) && touching[s] == expectedTouching[s]) {
+                    continue;
+                }
+                if (mismatches < MAX_REPORTED) {
+                    cout << to_string(shape) << " radius " << k << ", " << rows << " by " << cols
+                         << ": (" << row << ", " << col << ") has " << (int) counts[s] << " "
+                         << to_string((Species) s) << " touching " << (int) touching[s]
+                         << " but counting by hand gives " << expected[s] << " touching "
+                         << expectedTouching[s] << endl;
+                }
+                mismatches++;
+            }
+        }
+    }
+    if (mismatches > 0) {
+        cout << to_string(shape) << " radius " << k << ", " << rows << " by " << cols << ": "
+             << mismatches << " counts differ" << endl;
+        return false;
+    }
+    cout << to_string(shape) << " radius " << k << ", " << rows << " by " << cols << ": ok" << endl;
+    return true;
+}
+
+int main() {
+    SimRandom::seed(2022);
+    bool ok = true;
+    StencilShape shapes[] = {STENCIL_DIAMOND, STENCIL_SQUARE};
+    int radii[] = {1, 2, 3, Perception::MAX_RADIUS};
+    for (StencilShape shape : shapes) {
+        for (int radius : radii) {
+            ok = check(shape, radius, 37, 53) && ok;
+        }
+        //Smaller than the stencil, so it wraps onto itself
+        ok = check(shape, Perception::MAX_RADIUS, 5, 6) && ok;
+        ok = check(shape, 2, 3, 140000) && ok;
+    }
+    return ok ? 0 : 1;
+}
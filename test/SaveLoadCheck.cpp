@@ -0,0 +1,108 @@
+/*Joshua Lindquist & Sarah Allen
+CS132 Winter 2022
+Final Project: Simulation
+
+Checks SaveLoader on small saved worlds written out by hand: one with every species, blank
+cells, a damaged line and words the old loader skipped, one that stops early, and one with no
+sizes at the front. Each is parsed with a few numbers of threads and compared with the grid the
+old word by word loader gave, cell by cell. Returns 1 if anything differs.*/
+
+#include <cstdio>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+#include "SaveLoader.h"
+
+using namespace std;
+
+static const char* PATH = "SaveLoadCheck.txt";
+
+//Writes text to PATH, loads it, and returns false, after printing where, if the sizes or any
+//cell differ from expected
+static bool check(const string& name, const string& text, int windowSize, int squareSize,
+                  const vector<Species>& expected) {
+    ofstream file(PATH, ios::binary);
+    file << text;
+    file.close();
+
+    bool ok = true;
+    int threadCounts[] = {1, 2, 3, 16};
+    for (int threads : threadCounts) {
+        SaveLoader loader(PATH);
+        if (!loader.isOpen() || loader.getWindowSize() != windowSize
+                || loader.getSquareSize() != squareSize) {
+            cout << name << ": read sizes " << loader.getWindowSize() << " and "
+                 << loader.getSquareSize() << " but expected " << windowSize << " and "
+                 << squareSize << endl;
+            return false;
+        }
+        vector<unsigned char> grid;
+        loader.parse(grid, threads);
+        if (grid.size() != expected.size()) {
+            cout << name << ", " << threads << " threads: " << grid.size() << " cells but expected "
+                 << expected.size() << endl;
+            ok = false;
+            continue;
+        }
+        int size = loader.getSize();
+        for (size_t i = 0; i < grid.size(); i++) {
+            if (grid[i] != expected[i]) {
+                cout << name << ", " << threads << " threads: (" << i / size << ", " << i % size
+                     << ") is " << to_string((Species) grid[i]) << " but should be "
+                     << to_string(expected[i]) << endl;
+                ok = false;
+            }
+        }
+    }
+    if (ok) {
+        cout << name << ": ok" << endl;
+    }
+    return ok;
+}
+
+int main() {
+    bool ok = true;
+
+    //Every species, blanks, a line that isn't a row, a name without its comma, and names the
+    //old loader didn't know. Each of those still takes up a cell.
+    string world =
+        "40\n10\n"
+        "{Deer, Tree, ., Hunter}\n"
+        "{Lumberjack, Tiger, Building, .}\r\n"
+        "#damaged#\n"
+        "{Wolf,\tDeer Tiger}\n"
+        "{Tree,  Deer, Entity, Building}\n"
+        "{Deer, Deer, Deer, Deer}\n";
+    vector<Species> expected = {
+        DEER,       TREE,  EMPTY,    HUNTER,
+        LUMBERJACK, TIGER, BUILDING, EMPTY,
+        EMPTY,      EMPTY, EMPTY,    TIGER,
+        TREE,       DEER,  EMPTY,    BUILDING
+    };
+    ok = check("every species", world, 40, 10, expected) && ok;
+
+    //A save cut off part way through leaves the rest of the cells empty
+    string cut = "30 10 {Tiger, Hunter, .}\n{Tree, Bui";
+    expected = {
+        TIGER, HUNTER, EMPTY,
+        TREE,  EMPTY,  EMPTY,
+        EMPTY, EMPTY,  EMPTY
+    };
+    ok = check("cut short", cut, 30, 10, expected) && ok;
+
+    //Without the sizes at the front nothing can be loaded
+    ofstream file(PATH, ios::binary);
+    file << "{Deer, Tree}\n";
+    file.close();
+    SaveLoader headless(PATH);
+    if (headless.isOpen()) {
+        cout << "no sizes: opened anyway" << endl;
+        ok = false;
+    } else {
+        cout << "no sizes: ok" << endl;
+    }
+
+    remove(PATH);
+    return ok ? 0 : 1;
+}
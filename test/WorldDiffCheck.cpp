@@ -0,0 +1,118 @@
+/*Joshua Lindquist & Sarah Allen
+CS132 Winter 2022
+Final Project: Simulation
+
+Checks WorldDiff on two known worlds. A random world is copied and a handful of cells are
+changed, some in the same tile, some on the ragged last row and column of tiles, and one pair
+swapped so the tile holds the same Species as before. The changes WorldDiff finds, its counts
+and its number of differing tiles must match exactly, with any number of threads. Identical
+worlds must come out with no changes, and worlds of different sizes must be refused. Returns 1
+if anything differs.*/
+
+#include <iostream>
+#include <vector>
+#include "SimRandom.h"
+#include "WorldDiff.h"
+
+using namespace std;
+
+static const int SIZE = 150;   //not a whole number of tiles
+
+//Compares before and after with threads threads and returns false, after printing what, if it
+//doesn't find exactly the expected changes in tiles differing tiles
+static bool check(const vector<unsigned char>& before, const vector<unsigned char>& after,
+                  const vector<CellChange>& expected, int tiles, int threads) {
+    WorldDiff diff;
+    string error;
+    if (!diff.compare(before, after, SIZE, error, threads)) {
+        cout << threads << " threads: could not compare: " << error << endl;
+        return false;
+    }
+    bool ok = true;
+    const vector<CellChange>& found = diff.getChanges();
+    if (found.size() != expected.size()) {
+        cout << threads << " threads: found " << found.size() << " changes but expected "
+             << expected.size() << endl;
+        ok = false;
+    }
+    for (size_t i = 0; i < found.size() && i < expected.size(); i++) {
+        const CellChange& a = found[i];
+        const CellChange& b = expected[i];
+        if (a.row != b.row || a.col != b.col || a.before != b.before || a.after != b.after) {
+            cout << threads << " threads: change " << i << " is (" << a.row << ", " << a.col
+                 << ") " << to_string(a.before) << " to " << to_string(a.after)
+                 << " but should be (" << b.row << ", " << b.col << ") " << to_string(b.before)
+                 << " to " << to_string(b.after) << endl;
+            ok = false;
+        }
+    }
+    vector<long> counts(SPECIES_COUNT * SPECIES_COUNT, 0);
+    for (const CellChange& change : expected) {
+        counts[change.before * SPECIES_COUNT + change.after]++;
+    }
+    for (int was = 0; was < SPECIES_COUNT; was++) {
+        for (int is = 0; is < SPECIES_COUNT; is++) {
+            long count = diff.getCount((Species) was, (Species) is);
+            if (count != counts[was * SPECIES_COUNT + is]) {
+                cout << threads << " threads: " << count << " cells went from "
+                     << to_string((Species) was) << " to " << to_string((Species) is)
+                     << " but should be " << counts[was * SPECIES_COUNT + is] << endl;
+                ok = false;
+            }
+        }
+    }
+    if (diff.getDifferentTiles() != tiles) {
+        cout << threads << " threads: " << diff.getDifferentTiles() << " tiles differ but "
+             << tiles << " should" << endl;
+        ok = false;
+    }
+    return ok;
+}
+
+int main() {
+    SimRandom::seed(2022);
+    vector<unsigned char> before((size_t) SIZE * SIZE);
+    for (unsigned char& cell : before) {
+        cell = SimRandom::below(SPECIES_COUNT - 1);   //every Species but ENTITY
+    }
+
+    //Row by row, the way getChanges() lists them
+    vector<CellChange> expected = {
+        {0, 0, DEER, TREE},       //swapped with the next one
+        {0, 1, TREE, DEER},
+        {5, 70, EMPTY, DEER},
+        {40, 20, DEER, TIGER},
+        {40, 21, HUNTER, EMPTY},
+        {130, 149, TREE, BUILDING},
+        {149, 149, EMPTY, HUNTER}
+    };
+    for (const CellChange& change : expected) {
+        before[(size_t) change.row * SIZE + change.col] = change.before;
+    }
+    vector<unsigned char> after = before;
+    for (const CellChange& change : expected) {
+        after[(size_t) change.row * SIZE + change.col] = change.after;
+    }
+    //Tiles (0, 0), (0, 1) and (2, 2) of the 3 by 3
+    int tiles = 3;
+
+    bool ok = true;
+    int threadCounts[] = {1, 2, 5, 0};
+    for (int threads : threadCounts) {
+        ok = check(before, after, expected, tiles, threads) && ok;
+        ok = check(before, before, vector<CellChange>(), 0, threads) && ok;
+    }
+
+    WorldDiff diff;
+    string error;
+    vector<unsigned char> smaller((size_t) (SIZE - 1) * (SIZE - 1));
+    if (diff.compare(before, smaller, SIZE, error)) {
+        cout << "compared worlds of different sizes" << endl;
+        ok = false;
+    }
+
+    if (ok) {
+        cout << "ok, " << expected.size() << " changes in " << tiles << " tiles" << endl;
+    }
+    return ok ? 0 : 1;
+}